@@ -15,9 +15,52 @@
 #import <Foundation/Foundation.h>
 #import "GRKAnalyticsProvider.h"
 #import "GRKLanguageFeatures.h"
+#import "GRKEventRingBuffer.h"
+#import "GRKTimerTable.h"
+#import "GRKSpanTable.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ * The properties of the summary events delivered while timing aggregation is enabled. See `setTimingAggregationInterval:`.
+ * Durations are in seconds.
+ */
+extern NSString * const kGRKAnalyticsTimingSummaryPropertyCount;
+extern NSString * const kGRKAnalyticsTimingSummaryPropertyMinimum;
+extern NSString * const kGRKAnalyticsTimingSummaryPropertyMaximum;
+extern NSString * const kGRKAnalyticsTimingSummaryPropertyP50;
+extern NSString * const kGRKAnalyticsTimingSummaryPropertyP90;
+extern NSString * const kGRKAnalyticsTimingSummaryPropertyP99;
+extern NSString * const kGRKAnalyticsTimingSummaryPropertyP999;
+
+/**
+ * The properties identifying a span in the events delivered for it. IDs are 16 digit hexadecimal strings.
+ */
+extern NSString * const kGRKAnalyticsSpanPropertyTraceID;
+extern NSString * const kGRKAnalyticsSpanPropertySpanID;
+extern NSString * const kGRKAnalyticsSpanPropertyParentSpanID;
+
+/**
+ * The property holding the spans of a trace, when spans are delivered as `GRKSpanEmissionModeTraceRecord`.
+ * The value is a `;` separated list with an entry for each span, in the order they started. Each entry is `name,parent,start,duration`, where `parent` is the index of the parent span's entry (empty for the root, or if the parent is not in the record), and `start` and `duration` are in microseconds, from the start of the root.
+ */
+extern NSString * const kGRKAnalyticsSpanPropertyTrace;
+
+/**
+ * The property added, with the value `@YES`, to the timing events delivered for abandoned timers. See `setReportsAbandonedTimers:`.
+ */
+extern NSString * const kGRKAnalyticsTimerPropertyAbandoned;
+
+/**
+ * How spans are delivered to providers.
+ */
+typedef NS_ENUM(NSInteger, GRKSpanEmissionMode) {
+    /// Each span is delivered as a timing event of its own, with `kGRKAnalyticsSpanProperty...` properties placing it in its trace.
+    GRKSpanEmissionModeTimingEvents = 0,
+    /// The spans of a trace are gathered as they end, and delivered as a single timing event when the root span ends. See `kGRKAnalyticsSpanPropertyTrace`.
+    GRKSpanEmissionModeTraceRecord,
+};
+
 @interface GRKAnalytics : NSObject
 
 #pragma mark - Configuration
@@ -63,12 +106,149 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (BOOL)userIdentityEnabled;
 
+/**
+ * Enables or disables asynchronous delivery of analytic information to the providers.
+ *
+ * If enabled, each tracking call captures its arguments (including the current super properties) and returns immediately. The work of calling the providers is done off the calling thread, with each provider being called on its own serial `deliveryQueue`, in the order the events were tracked.
+ * If disabled, each tracking call invokes every provider synchronously on the calling thread before returning.
+ *
+ * The default value is `NO`
+ *
+ * @param enabled `YES` to enable asynchronous delivery, `NO` to deliver synchronously.
+ * @see `waitForPendingDeliveriesWithTimeout:`
+ */
++ (void)setAsynchronousDeliveryEnabled:(BOOL)enabled;
+
+/**
+ * Is asynchronous delivery enabled?
+ *
+ * @return `YES` if events are delivered to the providers asynchronously, `NO` if they are delivered on the calling thread.
+ */
++ (BOOL)asynchronousDeliveryEnabled;
+
+/**
+ * Blocks the calling thread until all events tracked so far have been delivered to the providers, or the timeout elapses.
+ * This is useful before the application terminates, or in tests. When asynchronous delivery is disabled this returns `YES` immediately.
+ *
+ * NOTE: This must not be called from a provider's `deliveryQueue`.
+ *
+ * @param timeout The maximum amount of time to wait, in seconds.
+ * @return `YES` if all pending deliveries completed, `NO` if the timeout elapsed first.
+ */
++ (BOOL)waitForPendingDeliveriesWithTimeout:(NSTimeInterval)timeout;
+
+/**
+ * Sets the behavior when events are tracked faster than they can be delivered, while asynchronous delivery is enabled.
+ *
+ * Tracked events are held in a bounded, lock-free, buffer until they are handed to the providers, so tracking from many threads at once never blocks on a lock. If that buffer fills the given policy determines which events are discarded. Configuration, user identity, and user property changes are never discarded, under any policy; they are held outside the buffer, and delivered in order with the events tracked around them.
+ *
+ * The default value is `GRKEventRingBufferOverflowPolicyDropNewest`
+ *
+ * @param policy The overflow policy.
+ * @see `droppedEventCount`
+ */
++ (void)setDeliveryOverflowPolicy:(GRKEventRingBufferOverflowPolicy)policy;
+
+/**
+ * @return The current overflow policy.
+ */
++ (GRKEventRingBufferOverflowPolicy)deliveryOverflowPolicy;
+
+/**
+ * Sets the maximum amount of time, in seconds, a tracking call will wait for room when the overflow policy is `GRKEventRingBufferOverflowPolicyBlock`. After this time the event is discarded.
+ *
+ * The default value is `0.1`
+ *
+ * @param timeout The timeout, in seconds.
+ */
++ (void)setDeliveryOverflowTimeout:(NSTimeInterval)timeout;
+
+/**
+ * @return The current overflow timeout, in seconds.
+ */
++ (NSTimeInterval)deliveryOverflowTimeout;
+
+/**
+ * @return The number of times a tracking call found the delivery buffer full.
+ */
++ (uint64_t)deliveryOverflowCount;
+
+/**
+ * @return The number of events discarded due to the delivery buffer being full.
+ */
++ (uint64_t)droppedEventCount;
+
+/**
+ * Sets the maximum number of events delivered to a provider in a single batch, while asynchronous delivery is enabled.
+ *
+ * Events tracked with `trackEvent:category:properties:` and `trackTimeEnd:category:properties:` are accumulated per provider and handed to `-[GRKAnalyticsProvider trackEvents:]` once the batch reaches this count, `batchMaximumBytes`, or `batchMaximumAge`, whichever comes first. Any other call (errors, purchases, user properties, etc.) delivers the pending batch first, so ordering is preserved.
+ *
+ * The default value is `50`. A value of `1` disables batching.
+ *
+ * @param count The maximum number of events per batch.
+ */
++ (void)setBatchMaximumCount:(NSUInteger)count;
+
+/**
+ * @return The maximum number of events per batch.
+ */
++ (NSUInteger)batchMaximumCount;
+
+/**
+ * Sets the approximate maximum size, in bytes, of a batch. See `-[GRKAnalyticsEvent estimatedSize]`.
+ *
+ * The default value is `32768`
+ *
+ * @param bytes The maximum size of a batch.
+ */
++ (void)setBatchMaximumBytes:(NSUInteger)bytes;
+
+/**
+ * @return The approximate maximum size, in bytes, of a batch.
+ */
++ (NSUInteger)batchMaximumBytes;
+
+/**
+ * Sets the maximum amount of time, in seconds, an event will wait in a partial batch before the batch is delivered.
+ *
+ * The default value is `1.0`
+ *
+ * @param age The maximum age of a batch, in seconds.
+ */
++ (void)setBatchMaximumAge:(NSTimeInterval)age;
+
+/**
+ * @return The maximum age of a batch, in seconds.
+ */
++ (NSTimeInterval)batchMaximumAge;
+
 #pragma mark - Providers
 
+/**
+ * Adds a provider which will receive analytic information. Adding a provider which has already been added has no effect.
+ * Providers may be added and removed from any thread, at any time, including while events are being delivered.
+ *
+ * @param analyticsProvider The provider to add.
+ */
 + (void)addProvider:(GRKAnalyticsProvider *)analyticsProvider;
+
+/**
+ * Removes a previously added provider. Events already handed to the provider may still be delivered to it.
+ *
+ * @param analyticsProvider The provider to remove.
+ */
 + (void)removeProvider:(GRKAnalyticsProvider *)analyticsProvider;
+
+/**
+ * @return The set of providers currently added.
+ */
 + (NSSet *)providers;
 
+/**
+ * @return The providers currently added, in the order they were added. Events are delivered to the providers in this order.
+ */
++ (GRK_GENERIC_NSARRAY(GRKAnalyticsProvider *) *)orderedProviders;
+
 #pragma mark - User
 
 #pragma mark User Identity
@@ -135,6 +315,23 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (void)removeEventSuperProperties:(NSArray *)keys;
 
+/**
+ * Pushes a layer of super properties, such as the context of the current screen.
+ * The properties of the layer take precedence over the other super properties until the layer is popped.
+ *
+ * @param properties The properties of the layer.
+ * @return An opaque token identifying the layer, to be passed to `popEventSuperPropertiesLayer:`.
+ * @see popEventSuperPropertiesLayer:
+ */
++ (id)pushEventSuperPropertiesLayer:(GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
+
+/**
+ * Pops a layer of super properties, along with any layers pushed after it.
+ *
+ * @param token The token returned by `pushEventSuperPropertiesLayer:`. If the layer has already been popped this has no effect.
+ */
++ (void)popEventSuperPropertiesLayer:(id)token;
+
 #pragma mark Event Specific Cases
 
 /**
@@ -213,6 +410,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 /**
  * Start tracking time elapsed for an event.
+ * Time is measured with nanosecond resolution on a monotonic clock, so it is not affected by changes to the system clock.
  *
  * @param event The unique event name.
  * @see trackTimeEnd:
@@ -238,6 +436,186 @@ NS_ASSUME_NONNULL_BEGIN
             category:(nullable NSString *)category
           properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
 
+/**
+ * Start tracking time elapsed for an event which may overlap others of the same name, such as concurrent image or network loads.
+ * Unlike `trackTimeStart:`, each call starts a separate timer. This may be called from any thread.
+ *
+ * @return The handle of the new timer, to pass to `trackTimeEndForTimer:event:category:properties:` or `cancelTimer:`.
+ */
++ (GRKTimerHandle)startTimer;
+
+/**
+ * Finish tracking time elapsed for the timer with the given handle.
+ * If the handle does not identify a running timer (it has already been ended or cancelled, for example) nothing is tracked.
+ *
+ * @param handle       The handle returned by `startTimer`.
+ * @param event        The name of the event.
+ * @param category     The category of the event.
+ * @param properties   A dictionary of all additional properties to associate with this event.
+ */
++ (void)trackTimeEndForTimer:(GRKTimerHandle)handle
+                       event:(NSString *)event
+                    category:(nullable NSString *)category
+                  properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
+
+/**
+ * Stop the timer with the given handle without tracking anything.
+ *
+ * @param handle The handle returned by `startTimer`.
+ */
++ (void)cancelTimer:(GRKTimerHandle)handle;
+
+/**
+ * Sets how timers started from now on by `trackTimeStart:` and `startTimer` count time. Running timers are unaffected.
+ *
+ * With `GRKTimerModePausesWhileSuspended`, timers stop counting while the app is in the background (or, on macOS, while the machine sleeps), so a screen left open overnight reports only the time it was actually on screen.
+ * Pausing and resuming takes constant time, however many timers are running.
+ *
+ * The default value is `GRKTimerModeContinuous`
+ *
+ * @param mode How timers count time.
+ */
++ (void)setTimerMode:(GRKTimerMode)mode;
+
+/**
+ * @return How timers started from now on count time.
+ */
++ (GRKTimerMode)timerMode;
+
+/**
+ * Sets how long a timer may run before it is abandoned. A `trackTimeStart:` or `startTimer` which is never ended would otherwise hold its timer for the life of the process.
+ * Abandoned timers are swept out periodically, and whenever a timer is started, oldest first. Each costs constant time, however many timers are running.
+ * The same maximum applies to spans: a span which is never ended is abandoned, unreported, along with any spans of its trace waiting for it to end.
+ *
+ * The default value is `0`, so timers never expire.
+ *
+ * @param maximumAge The maximum age of a timer, in seconds, or `0` for no maximum.
+ */
++ (void)setTimerMaximumAge:(NSTimeInterval)maximumAge;
+
+/**
+ * @return The maximum age of a timer, in seconds, or `0` for no maximum.
+ */
++ (NSTimeInterval)timerMaximumAge;
+
+/**
+ * Sets the maximum number of running timers. Starting a timer beyond this abandons the oldest running timer.
+ * Spans have a maximum of their own, set to the same number: starting a span beyond it abandons the oldest running span.
+ *
+ * The default value is `1024`
+ *
+ * @param maximumCount The maximum number of running timers.
+ */
++ (void)setTimerMaximumCount:(NSUInteger)maximumCount;
+
+/**
+ * @return The maximum number of running timers.
+ */
++ (NSUInteger)timerMaximumCount;
+
+/**
+ * @return The number of timers abandoned, by age or to make room, since the app was launched.
+ */
++ (uint64_t)abandonedTimerCount;
+
+/**
+ * Sets whether abandoned timers are reported. If `YES`, a timing event is delivered for each abandoned `trackTimeStart:` timer, with the time it ran and the `kGRKAnalyticsTimerPropertyAbandoned` property.
+ * Timers started by `startTimer` have no event name, so they are only counted.
+ *
+ * The default value is `NO`
+ *
+ * @param reportsAbandonedTimers `YES` to report abandoned timers.
+ */
++ (void)setReportsAbandonedTimers:(BOOL)reportsAbandonedTimers;
+
+/**
+ * @return `YES` if abandoned timers are reported.
+ */
++ (BOOL)reportsAbandonedTimers;
+
+/**
+ * Sets how spans are delivered.
+ *
+ * The default value is `GRKSpanEmissionModeTimingEvents`
+ *
+ * @param mode How spans are delivered.
+ */
++ (void)setSpanEmissionMode:(GRKSpanEmissionMode)mode;
+
+/**
+ * @return How spans are delivered.
+ */
++ (GRKSpanEmissionMode)spanEmissionMode;
+
+/**
+ * Start a span: a timing which knows its place in a trace, so nested work (the network, parsing and layout of a screen load, say) can be told apart.
+ *
+ * The span is a child of the calling thread's `currentSpanContext`, or starts a new trace if there is none (or that span has ended), and becomes the thread's current span until it is ended.
+ * To continue a trace on another thread or queue, capture `currentSpanContext` and use `performWithSpanContext:block:` there.
+ * A span may be ended on another thread. The thread it was started on is then left with an ended span as its current context, which is never adopted as a parent, so later spans there start new traces.
+ *
+ * @param name The name of the span.
+ * @return The span, to pass to `endSpan:category:properties:`.
+ */
++ (GRKSpan)startSpan:(NSString *)name;
+
+/**
+ * End a span. See `endSpan:category:properties:`.
+ *
+ * @param span The span returned by `startSpan:`.
+ */
++ (void)endSpan:(GRKSpan)span;
+
+/**
+ * End a span. If the span is the calling thread's current span, its parent becomes current again.
+ * Ending a span twice does nothing.
+ *
+ * @param span       The span returned by `startSpan:`.
+ * @param category   The category of the event delivered for the span, or for the trace when a root span ends in `GRKSpanEmissionModeTraceRecord`.
+ * @param properties A dictionary of all additional properties to associate with the event. When gathering spans into a trace record, only the root span's properties are delivered.
+ */
++ (void)endSpan:(GRKSpan)span
+       category:(nullable NSString *)category
+     properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
+
+/**
+ * @return The calling thread's current span context, or `kGRKSpanContextNone` outside of any span.
+ */
++ (GRKSpanContext)currentSpanContext;
+
+/**
+ * Perform a block with the given span context as the current one, so spans started by the block are its children.
+ *
+ * @param context The span context, typically captured with `currentSpanContext` on another thread.
+ * @param block   The block to perform, synchronously.
+ */
++ (void)performWithSpanContext:(GRKSpanContext)context block:(void (^)(void))block;
+
+/**
+ * Enables aggregation of timing events, for timings too frequent to deliver one by one (every cell render, or every cache lookup, say).
+ *
+ * While enabled, the durations ended by `trackTimeEnd:category:properties:` and `trackTimeEndForTimer:event:category:properties:` are recorded into a histogram per event name and category, rather than delivered.
+ * Every `interval` seconds a single summary event is delivered for each event name and category timed since the last summary, with the name and category of the timed event, and the `kGRKAnalyticsTimingSummaryProperty...` properties.
+ * The properties passed when ending a timing are not included in summaries.
+ *
+ * Each thread records into histograms of its own, of a little under 5 KB each, one for every event name and category the thread has timed. These are kept for as long as the thread lives, so a handful of threads timing a handful of events costs tens of KB, but timing many distinct event names or categories costs proportionally more. Prefer a fixed set of event names and categories over ones which vary (with an identifier in them, say).
+ *
+ * The default value is `0`, which disables aggregation. Disabling aggregation delivers any pending summaries.
+ *
+ * @param interval The number of seconds between summaries, or `0` to disable aggregation.
+ */
++ (void)setTimingAggregationInterval:(NSTimeInterval)interval;
+
+/**
+ * @return The number of seconds between summaries of aggregated timing events, or `0` if aggregation is disabled.
+ */
++ (NSTimeInterval)timingAggregationInterval;
+
+/**
+ * Deliver summaries of the timing events aggregated since the last summary now, rather than waiting for the interval to elapse.
+ */
++ (void)flushTimingSummaries;
+
 #pragma mark - Errors
 
 /**
@@ -13,19 +13,90 @@
 //
 
 #import "GRKAnalytics.h"
+#import "GRKEventBatcher.h"
+#import "GRKPropertyStore.h"
+#import "GRKTimerTable.h"
+#import "GRKTimingAggregator.h"
+#import <stdatomic.h>
+
+#if TARGET_OS_IPHONE
+#import <UIKit/UIKit.h>
+#elif TARGET_OS_MAC
+#import <AppKit/AppKit.h>
+#endif
+
+static NSUInteger const kGRKAnalyticsIngestionCapacity = 4096;
+static NSUInteger const kGRKAnalyticsDefaultBatchMaximumCount = 50;
+static NSUInteger const kGRKAnalyticsDefaultBatchMaximumBytes = 32 * 1024;
+static NSTimeInterval const kGRKAnalyticsDefaultBatchMaximumAge = 1.0;
+
+NSString * const kGRKAnalyticsTimingSummaryPropertyCount = @"count";
+NSString * const kGRKAnalyticsTimingSummaryPropertyMinimum = @"min";
+NSString * const kGRKAnalyticsTimingSummaryPropertyMaximum = @"max";
+NSString * const kGRKAnalyticsTimingSummaryPropertyP50 = @"p50";
+NSString * const kGRKAnalyticsTimingSummaryPropertyP90 = @"p90";
+NSString * const kGRKAnalyticsTimingSummaryPropertyP99 = @"p99";
+NSString * const kGRKAnalyticsTimingSummaryPropertyP999 = @"p99_9";
+
+NSString * const kGRKAnalyticsTimerPropertyAbandoned = @"abandoned";
+
+NSString * const kGRKAnalyticsSpanPropertyTraceID = @"trace_id";
+NSString * const kGRKAnalyticsSpanPropertySpanID = @"span_id";
+NSString * const kGRKAnalyticsSpanPropertyParentSpanID = @"parent_span_id";
+NSString * const kGRKAnalyticsSpanPropertyTrace = @"trace";
+
+// A delivery which must not be discarded, waiting to be fanned out ahead of the enqueued object at `position`.
+@interface GRKOrderedDelivery : NSObject
+
+@property (nonatomic,copy) void(^providerBlock)(GRKAnalyticsProvider *provider);
+@property (nonatomic,assign) uint64_t position;
+
+@end
+
+@implementation GRKOrderedDelivery
+
+@end
 
 @interface GRKAnalytics ()
+{
+    // The number of `orderedDeliveries`, so the fan out queue can check for them without taking the lock.
+    atomic_uint _orderedDeliveryCount;
+}
 
-@property (nonatomic,strong) NSMutableSet *providers;
-@property (nonatomic,strong) NSMutableDictionary *superProperties;
-@property (nonatomic,strong) NSMutableDictionary *eventsDictionary;
+// An immutable snapshot of the registered providers, in the order they were added. Readers take the current
+// snapshot and use it for as long as they need; writers publish a new snapshot.
+@property (atomic,copy) GRK_GENERIC_NSARRAY(GRKAnalyticsProvider *) *orderedProviders;
+@property (nonatomic,strong) GRKPropertyStore *propertyStore;
+@property (nonatomic,strong) GRKTimerTable *timerTable;
+@property (atomic,assign) BOOL reportsAbandonedTimers;
+@property (nonatomic,strong) GRKTimingAggregator *timingAggregator;
+@property (nonatomic,strong) GRKSpanTable *spanTable;
+@property (atomic,assign) GRKSpanEmissionMode spanEmissionMode;
+@property (atomic,assign) NSTimeInterval timingAggregationInterval;
+// Fires every `timingAggregationInterval` while aggregation is enabled. Guarded by `self`.
+@property (nonatomic,strong,nullable) dispatch_source_t timingAggregationSource;
 @property (nonatomic,assign) BOOL enabled;
 @property (nonatomic,assign) BOOL userIdentityEnabled;
+@property (nonatomic,assign) BOOL asynchronousDeliveryEnabled;
+@property (nonatomic,strong) dispatch_queue_t fanOutQueue;
+@property (nonatomic,strong) dispatch_group_t deliveryGroup;
+@property (nonatomic,strong) GRKEventRingBuffer *ingestionBuffer;
+@property (nonatomic,strong) dispatch_source_t ingestionSource;
+// Non discardable deliveries, in the order they were made. Guarded by itself.
+@property (nonatomic,strong) NSMutableArray<GRKOrderedDelivery *> *orderedDeliveries;
+// Provider -> GRKEventBatcher. Only accessed on the fan out queue.
+@property (nonatomic,strong) NSMapTable *batchers;
+@property (nonatomic,assign) NSUInteger batchMaximumCount;
+@property (nonatomic,assign) NSUInteger batchMaximumBytes;
+@property (nonatomic,assign) NSTimeInterval batchMaximumAge;
 
 @end
 
 @implementation GRKAnalytics
 
+// Both accessors are implemented, under the lock which also guards `timingAggregationSource`.
+@synthesize timingAggregationInterval = _timingAggregationInterval;
+
 #pragma mark - Lifecycle
 
 + (instancetype)sharedInstance
@@ -41,14 +112,56 @@
 {
     if ((self = [super init]))
     {
-        _providers = [NSMutableSet set];
+        _orderedProviders = @[];
+        _propertyStore = [[GRKPropertyStore alloc] init];
+        _timerTable = [[GRKTimerTable alloc] init];
+        _timingAggregator = [[GRKTimingAggregator alloc] init];
+        _spanTable = [[GRKSpanTable alloc] init];
+        _spanEmissionMode = GRKSpanEmissionModeTimingEvents;
         _enabled = YES;
 		_userIdentityEnabled = NO;
+        _asynchronousDeliveryEnabled = NO;
+        _fanOutQueue = dispatch_queue_create("com.levigroker.GRKAnalytics.fanout", DISPATCH_QUEUE_SERIAL);
+        _deliveryGroup = dispatch_group_create();
+        _batchers = [NSMapTable weakToStrongObjectsMapTable];
+        _batchMaximumCount = kGRKAnalyticsDefaultBatchMaximumCount;
+        _batchMaximumBytes = kGRKAnalyticsDefaultBatchMaximumBytes;
+        _batchMaximumAge = kGRKAnalyticsDefaultBatchMaximumAge;
+        
+        // Producers (any thread) push into the ring buffer and poke the source; the source coalesces the pokes
+        // and drains the buffer on the fan out queue, which is the single consumer.
+        dispatch_group_t group = _deliveryGroup;
+        _ingestionBuffer = [[GRKEventRingBuffer alloc] initWithCapacity:kGRKAnalyticsIngestionCapacity];
+        _orderedDeliveries = [NSMutableArray array];
+        _ingestionBuffer.discardHandler = ^(id object) {
+            dispatch_group_leave(group);
+        };
+        
+        __weak typeof(self) weakSelf = self;
+        _ingestionSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_DATA_ADD, 0, 0, _fanOutQueue);
+        dispatch_source_set_event_handler(_ingestionSource, ^{
+            [weakSelf drainIngestionBuffer];
+        });
+        dispatch_resume(_ingestionSource);
+        
+        _timerTable.abandonHandler = ^(NSString * _Nullable key, uint64_t elapsed) {
+            [weakSelf timerAbandonedForKey:key elapsedNanoseconds:elapsed];
+        };
+        
+        [self registerNotifications];
     }
     
     return self;
 }
 
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+#if !TARGET_OS_IPHONE && TARGET_OS_MAC
+    [[[NSWorkspace sharedWorkspace] notificationCenter] removeObserver:self];
+#endif
+}
+
 #pragma mark - Configuration
 
 + (void)setEnabled:(BOOL)enabled
@@ -71,6 +184,81 @@
 	return [[self sharedInstance] userIdentityEnabled];
 }
 
++ (void)setAsynchronousDeliveryEnabled:(BOOL)enabled
+{
+    [[self sharedInstance] setAsynchronousDeliveryEnabled:enabled];
+}
+
++ (BOOL)asynchronousDeliveryEnabled
+{
+    return [[self sharedInstance] asynchronousDeliveryEnabled];
+}
+
++ (BOOL)waitForPendingDeliveriesWithTimeout:(NSTimeInterval)timeout
+{
+    return [[self sharedInstance] waitForPendingDeliveriesWithTimeout:timeout];
+}
+
++ (void)setDeliveryOverflowPolicy:(GRKEventRingBufferOverflowPolicy)policy
+{
+    [[self sharedInstance] ingestionBuffer].overflowPolicy = policy;
+}
+
++ (GRKEventRingBufferOverflowPolicy)deliveryOverflowPolicy
+{
+    return [[self sharedInstance] ingestionBuffer].overflowPolicy;
+}
+
++ (void)setDeliveryOverflowTimeout:(NSTimeInterval)timeout
+{
+    [[self sharedInstance] ingestionBuffer].blockTimeout = timeout;
+}
+
++ (NSTimeInterval)deliveryOverflowTimeout
+{
+    return [[self sharedInstance] ingestionBuffer].blockTimeout;
+}
+
++ (uint64_t)deliveryOverflowCount
+{
+    return [[self sharedInstance] ingestionBuffer].overflowCount;
+}
+
++ (uint64_t)droppedEventCount
+{
+    return [[self sharedInstance] ingestionBuffer].droppedCount;
+}
+
++ (void)setBatchMaximumCount:(NSUInteger)count
+{
+    [[self sharedInstance] setBatchMaximumCount:count];
+}
+
++ (NSUInteger)batchMaximumCount
+{
+    return [[self sharedInstance] batchMaximumCount];
+}
+
++ (void)setBatchMaximumBytes:(NSUInteger)bytes
+{
+    [[self sharedInstance] setBatchMaximumBytes:bytes];
+}
+
++ (NSUInteger)batchMaximumBytes
+{
+    return [[self sharedInstance] batchMaximumBytes];
+}
+
++ (void)setBatchMaximumAge:(NSTimeInterval)age
+{
+    [[self sharedInstance] setBatchMaximumAge:age];
+}
+
++ (NSTimeInterval)batchMaximumAge
+{
+    return [[self sharedInstance] batchMaximumAge];
+}
+
 #pragma mark - Providers
 
 + (void)addProvider:(GRKAnalyticsProvider *)analyticsProvider
@@ -85,7 +273,12 @@
 
 + (NSSet *)providers
 {
-    return [[self sharedInstance] providers];
+    return [NSSet setWithArray:[[self sharedInstance] orderedProviders]];
+}
+
++ (GRK_GENERIC_NSARRAY(GRKAnalyticsProvider *) *)orderedProviders
+{
+    return [[self sharedInstance] orderedProviders];
 }
 
 #pragma mark - User
@@ -138,6 +331,16 @@
     [[self sharedInstance] removeEventSuperProperties:keys];
 }
 
++ (id)pushEventSuperPropertiesLayer:(GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    return [[self sharedInstance] pushEventSuperPropertiesLayer:properties];
+}
+
++ (void)popEventSuperPropertiesLayer:(id)token
+{
+    [[self sharedInstance] popEventSuperPropertiesLayer:token];
+}
+
 #pragma mark Event Specific Cases
 
 + (void)trackAppBecameActive
@@ -204,6 +407,126 @@
     [[self sharedInstance] trackTimeEnd:event category:category properties:properties];
 }
 
++ (GRKTimerHandle)startTimer
+{
+    return [[self sharedInstance].timerTable startTimer];
+}
+
++ (void)trackTimeEndForTimer:(GRKTimerHandle)handle
+                       event:(NSString *)event
+                    category:(nullable NSString *)category
+                  properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    [[self sharedInstance] trackTimeEndForTimer:handle event:event category:category properties:properties];
+}
+
++ (void)cancelTimer:(GRKTimerHandle)handle
+{
+    [[self sharedInstance].timerTable stopTimer:handle elapsedNanoseconds:NULL];
+}
+
++ (void)setTimerMode:(GRKTimerMode)mode
+{
+    [[self sharedInstance] timerTable].mode = mode;
+}
+
++ (GRKTimerMode)timerMode
+{
+    return [[self sharedInstance] timerTable].mode;
+}
+
++ (void)setTimerMaximumAge:(NSTimeInterval)maximumAge
+{
+    [[self sharedInstance] timerTable].maximumAge = maximumAge;
+    [[self sharedInstance] spanTable].maximumAge = maximumAge;
+}
+
++ (NSTimeInterval)timerMaximumAge
+{
+    return [[self sharedInstance] timerTable].maximumAge;
+}
+
++ (void)setTimerMaximumCount:(NSUInteger)maximumCount
+{
+    [[self sharedInstance] timerTable].maximumCount = maximumCount;
+    [[self sharedInstance] spanTable].maximumCount = maximumCount;
+}
+
++ (NSUInteger)timerMaximumCount
+{
+    return [[self sharedInstance] timerTable].maximumCount;
+}
+
++ (uint64_t)abandonedTimerCount
+{
+    return [[self sharedInstance] timerTable].abandonedCount;
+}
+
++ (void)setReportsAbandonedTimers:(BOOL)reportsAbandonedTimers
+{
+    [[self sharedInstance] setReportsAbandonedTimers:reportsAbandonedTimers];
+}
+
++ (BOOL)reportsAbandonedTimers
+{
+    return [[self sharedInstance] reportsAbandonedTimers];
+}
+
++ (void)setSpanEmissionMode:(GRKSpanEmissionMode)mode
+{
+    [[self sharedInstance] setSpanEmissionMode:mode];
+}
+
++ (GRKSpanEmissionMode)spanEmissionMode
+{
+    return [[self sharedInstance] spanEmissionMode];
+}
+
++ (GRKSpan)startSpan:(NSString *)name
+{
+    return [[self sharedInstance] startSpan:name];
+}
+
++ (void)endSpan:(GRKSpan)span
+{
+    [self endSpan:span category:nil properties:nil];
+}
+
++ (void)endSpan:(GRKSpan)span
+       category:(nullable NSString *)category
+     properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    [[self sharedInstance] endSpan:span category:category properties:properties];
+}
+
++ (GRKSpanContext)currentSpanContext
+{
+    return GRKSpanContextGetCurrent();
+}
+
++ (void)performWithSpanContext:(GRKSpanContext)context block:(void (^)(void))block
+{
+    GRKSpanContext previous = GRKSpanContextGetCurrent();
+    GRKSpanContextSetCurrent(context);
+    block();
+    GRKSpanContextSetCurrent(previous);
+}
+
++ (void)setTimingAggregationInterval:(NSTimeInterval)interval
+{
+    [[self sharedInstance] setTimingAggregationInterval:interval];
+}
+
++ (NSTimeInterval)timingAggregationInterval
+{
+    return [[self sharedInstance] timingAggregationInterval];
+}
+
++ (void)flushTimingSummaries
+{
+    [[self sharedInstance] flushTimingSummaries];
+}
+
 #pragma mark - Errors
 
 + (void)trackError:(NSError *)error
@@ -224,8 +547,69 @@
 - (void)setEnabled:(BOOL)enabled
 {
     _enabled = enabled;
-    for (GRKAnalyticsProvider *provider in self.providers) {
+    // Delivered regardless of our `enabled` state, and in order with any events already queued.
+    [self deliverToProviders:^(GRKAnalyticsProvider *provider) {
         provider.enabled = enabled;
+    } discardable:NO];
+}
+
+- (void)setBatchMaximumCount:(NSUInteger)batchMaximumCount
+{
+    _batchMaximumCount = MAX(batchMaximumCount, (NSUInteger)1);
+    [self updateBatchers];
+}
+
+- (void)setBatchMaximumBytes:(NSUInteger)batchMaximumBytes
+{
+    _batchMaximumBytes = batchMaximumBytes;
+    [self updateBatchers];
+}
+
+- (void)setBatchMaximumAge:(NSTimeInterval)batchMaximumAge
+{
+    _batchMaximumAge = batchMaximumAge;
+    [self updateBatchers];
+}
+
+- (NSTimeInterval)timingAggregationInterval
+{
+    @synchronized (self)
+    {
+        return _timingAggregationInterval;
+    }
+}
+
+- (void)setTimingAggregationInterval:(NSTimeInterval)timingAggregationInterval
+{
+    timingAggregationInterval = MAX(timingAggregationInterval, 0.0);
+    
+    @synchronized (self)
+    {
+        _timingAggregationInterval = timingAggregationInterval;
+        
+        if (self.timingAggregationSource)
+        {
+            dispatch_source_cancel(self.timingAggregationSource);
+            self.timingAggregationSource = nil;
+        }
+        
+        if (timingAggregationInterval > 0)
+        {
+            uint64_t interval = (uint64_t)(timingAggregationInterval * NSEC_PER_SEC);
+            dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+            dispatch_source_set_timer(source, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), interval, interval / 10);
+            __weak typeof(self) weakSelf = self;
+            dispatch_source_set_event_handler(source, ^{
+                [weakSelf flushTimingSummaries];
+            });
+            dispatch_resume(source);
+            self.timingAggregationSource = source;
+        }
+    }
+    
+    if (timingAggregationInterval <= 0)
+    {
+        [self flushTimingSummaries];
     }
 }
 
@@ -241,11 +625,21 @@
 
 #pragma mark - Providers
 
+// Writers serialize amongst themselves, build a new snapshot, and publish it. Deliveries in flight keep using the
+// snapshot they already hold, so they are never stalled or invalidated by a registry change.
+
 - (void)addProvider:(GRKAnalyticsProvider *)analyticsProvider
 {
     if (analyticsProvider)
     {
-        [self.providers addObject:analyticsProvider];
+        @synchronized (self)
+        {
+            GRK_GENERIC_NSARRAY(GRKAnalyticsProvider *) *providers = self.orderedProviders;
+            if (![providers containsObject:analyticsProvider])
+            {
+                self.orderedProviders = [providers arrayByAddingObject:analyticsProvider];
+            }
+        }
     }
 }
 
@@ -253,7 +647,16 @@
 {
     if (analyticsProvider)
     {
-        [self.providers removeObject:analyticsProvider];
+        @synchronized (self)
+        {
+            GRK_GENERIC_NSARRAY(GRKAnalyticsProvider *) *providers = self.orderedProviders;
+            if ([providers containsObject:analyticsProvider])
+            {
+                NSMutableArray *mutableProviders = [providers mutableCopy];
+                [mutableProviders removeObject:analyticsProvider];
+                self.orderedProviders = mutableProviders;
+            }
+        }
     }
 }
 
@@ -266,7 +669,7 @@
 	if (self.userIdentityEnabled || (userID.length == 0 && email.length == 0)) {
 		[self doForEachProvider:^(GRKAnalyticsProvider *provider) {
 			[provider identifyUserWithID:userID andEmailAddress:email];
-		}];
+		} discardable:NO];
 	}
 }
 
@@ -278,7 +681,7 @@
     {
         [self doForEachProvider:^(GRKAnalyticsProvider *provider) {
             [provider setUserProperty:property toValue:value];
-        }];
+        } discardable:NO];
     }
 }
 
@@ -291,9 +694,7 @@
     if (event)
     {
         NSDictionary *allProperties = [self allPropertiesWithProperties:properties];
-        [self doForEachProvider:^(GRKAnalyticsProvider *provider) {
-            [provider trackEvent:event category:category properties:allProperties];
-        }];
+        [self deliverEvent:[GRKAnalyticsEvent eventWithName:event category:category properties:allProperties]];
     }
 }
 
@@ -303,11 +704,7 @@
 {
     if (properties)
     {
-        if (!self.superProperties)
-        {
-            self.superProperties = [NSMutableDictionary dictionary];
-        }
-        [self.superProperties addEntriesFromDictionary:properties];
+        [self.propertyStore addProperties:properties];
     }
 }
 
@@ -315,7 +712,20 @@
 {
     if (keys)
     {
-        [self.superProperties removeObjectsForKeys:keys];
+        [self.propertyStore removePropertiesForKeys:keys];
+    }
+}
+
+- (id)pushEventSuperPropertiesLayer:(GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    return [self.propertyStore pushLayer:properties ?: @{}];
+}
+
+- (void)popEventSuperPropertiesLayer:(id)token
+{
+    if (token)
+    {
+        [self.propertyStore popLayer:token];
     }
 }
 
@@ -382,31 +792,198 @@
 {
     if (event)
     {
-        if (!self.eventsDictionary)
-        {
-            self.eventsDictionary = [NSMutableDictionary dictionary];
-        }
-        self.eventsDictionary[event] = [NSDate date];
+        [self.timerTable startTimerForKey:event];
+    }
+}
+
+- (void)trackTimeEnd:(NSString *)event
+            category:(nullable NSString *)category
+          properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    uint64_t elapsed = 0;
+    BOOL started = event && [self.timerTable stopTimerForKey:event elapsedNanoseconds:&elapsed];
+    // Once timers have been abandoned, a late end may simply have lost its timer.
+    NSAssert(started || self.timerTable.abandonedCount > 0, @"End timing event '%@' called without a corrosponding start timing event", event);
+
+    if (started)
+    {
+        [self trackTimeEnd:event elapsedNanoseconds:elapsed category:category properties:properties];
+    }
+}
+
+- (void)trackTimeEndForTimer:(GRKTimerHandle)handle
+                       event:(NSString *)event
+                    category:(nullable NSString *)category
+                  properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    // Timers started by handle are often abandoned (a cancelled load, say), so a stale handle is not an error.
+    uint64_t elapsed = 0;
+    if ([self.timerTable stopTimer:handle elapsedNanoseconds:&elapsed] && event)
+    {
+        [self trackTimeEnd:event elapsedNanoseconds:elapsed category:category properties:properties];
     }
 }
 
 - (void)trackTimeEnd:(NSString *)event
+  elapsedNanoseconds:(uint64_t)elapsed
             category:(nullable NSString *)category
           properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
 {
-    NSDate *startDate = self.eventsDictionary[event];
-    NSAssert(startDate, @"End timing event '%@' called without a corrosponding start timing event", event);
+    if (self.timingAggregationInterval > 0)
+    {
+        [self.timingAggregator recordDuration:elapsed forEvent:event category:category];
+        return;
+    }
+    
+    NSTimeInterval eventInterval = (NSTimeInterval)elapsed / NSEC_PER_SEC;
+    NSDictionary *allProperties = [self allPropertiesWithProperties:properties];
+    [self deliverEvent:[GRKAnalyticsEvent timingEventWithName:event category:category timeInterval:eventInterval properties:allProperties]];
+}
 
-    if (startDate)
+- (void)timerAbandonedForKey:(nullable NSString *)key elapsedNanoseconds:(uint64_t)elapsed
+{
+    // Abandoned timers bypass timing aggregation, so they don't skew the summaries of timers which ended.
+    if (key && self.reportsAbandonedTimers)
     {
-        NSTimeInterval eventInterval = [[NSDate date] timeIntervalSinceDate:startDate];
-        [self.eventsDictionary removeObjectForKey:event];
+        NSTimeInterval eventInterval = (NSTimeInterval)elapsed / NSEC_PER_SEC;
+        NSDictionary *allProperties = [self allPropertiesWithProperties:@{kGRKAnalyticsTimerPropertyAbandoned: @YES}];
+        [self deliverEvent:[GRKAnalyticsEvent timingEventWithName:key category:nil timeInterval:eventInterval properties:allProperties]];
+    }
+}
+
+#pragma mark - Spans
+
+- (GRKSpan)startSpan:(NSString *)name
+{
+    GRKSpan span = [self.spanTable startSpanWithName:name parent:GRKSpanContextGetCurrent()];
+    GRKSpanContextSetCurrent(span.context);
+    
+    return span;
+}
+
+- (void)endSpan:(GRKSpan)span
+       category:(nullable NSString *)category
+     properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    // Only unwind the thread's context if this span is current; spans needn't end in the order they started.
+    if (GRKSpanContextGetCurrent().spanID == span.context.spanID)
+    {
+        GRKSpanContext parent = {span.context.traceID, span.parentSpanID, span.context.root, span.parentHandle};
+        GRKSpanContextSetCurrent(span.parentSpanID != 0 ? parent : kGRKSpanContextNone);
+    }
+    
+    BOOL traceRecord = self.spanEmissionMode == GRKSpanEmissionModeTraceRecord;
+    BOOL isRoot = span.context.root == span.handle;
+    [self.spanTable endSpan:span gatherTrace:traceRecord handler:^(const GRKSpanRecord *records, NSUInteger count) {
+        if (isRoot && (traceRecord || count > 1))
+        {
+            [self deliverTraceRecords:records count:count category:category properties:properties];
+        }
+        else
+        {
+            for (NSUInteger index = 0; index < count; ++index)
+            {
+                const GRKSpanRecord *record = &records[index];
+                NSMutableDictionary *spanProperties = [NSMutableDictionary dictionaryWithDictionary:properties ?: @{}];
+                spanProperties[kGRKAnalyticsSpanPropertyTraceID] = [NSString stringWithFormat:@"%016llx", record->traceID];
+                spanProperties[kGRKAnalyticsSpanPropertySpanID] = [NSString stringWithFormat:@"%016llx", record->spanID];
+                if (record->parentSpanID != 0)
+                {
+                    spanProperties[kGRKAnalyticsSpanPropertyParentSpanID] = [NSString stringWithFormat:@"%016llx", record->parentSpanID];
+                }
+                [self trackTimeEnd:record->name elapsedNanoseconds:record->duration category:category properties:spanProperties];
+            }
+        }
+    }];
+}
+
+// Delivered directly, rather than aggregated, as a trace is of no use summarized.
+- (void)deliverTraceRecords:(const GRKSpanRecord *)records
+                      count:(NSUInteger)count
+                   category:(nullable NSString *)category
+                 properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    static NSCharacterSet *separators = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        separators = [NSCharacterSet characterSetWithCharactersInString:@",;"];
+    });
+    
+    // Records are in the order they started, so the root is first.
+    const GRKSpanRecord *root = &records[0];
+    NSMutableString *trace = [NSMutableString string];
+    for (NSUInteger index = 0; index < count; ++index)
+    {
+        const GRKSpanRecord *record = &records[index];
         
-        NSDictionary *allProperties = [self allPropertiesWithProperties:properties];
-        [self doForEachProvider:^(GRKAnalyticsProvider *provider) {
-            [provider trackTimingEvent:event category:category timeInterval:eventInterval properties:allProperties];
-        }];
+        NSString *name = record->name;
+        if ([name rangeOfCharacterFromSet:separators].location != NSNotFound)
+        {
+            name = [[name componentsSeparatedByCharactersInSet:separators] componentsJoinedByString:@"_"];
+        }
+        
+        NSString *parent = @"";
+        for (NSUInteger parentIndex = 0; parentIndex < index && record->parentSpanID != 0; ++parentIndex)
+        {
+            if (records[parentIndex].spanID == record->parentSpanID)
+            {
+                parent = [NSString stringWithFormat:@"%lu", (unsigned long)parentIndex];
+                break;
+            }
+        }
+        
+        [trace appendFormat:@"%@%@,%@,%llu,%llu", index > 0 ? @";" : @"", name, parent, (record->start - root->start) / NSEC_PER_USEC, record->duration / NSEC_PER_USEC];
     }
+    
+    NSMutableDictionary *traceProperties = [NSMutableDictionary dictionaryWithDictionary:properties ?: @{}];
+    traceProperties[kGRKAnalyticsSpanPropertyTraceID] = [NSString stringWithFormat:@"%016llx", root->traceID];
+    traceProperties[kGRKAnalyticsSpanPropertyTrace] = trace;
+    
+    NSDictionary *allProperties = [self allPropertiesWithProperties:traceProperties];
+    NSTimeInterval eventInterval = (NSTimeInterval)root->duration / NSEC_PER_SEC;
+    [self deliverEvent:[GRKAnalyticsEvent timingEventWithName:root->name category:category timeInterval:eventInterval properties:allProperties]];
+}
+
+- (void)flushTimingSummaries
+{
+    [self.timingAggregator drainWithBlock:^(NSString *event, NSString * _Nullable category, GRKTimingHistogram *histogram) {
+        NSDictionary *summary = @{
+            kGRKAnalyticsTimingSummaryPropertyCount: @(histogram.count),
+            kGRKAnalyticsTimingSummaryPropertyMinimum: @((NSTimeInterval)histogram.minimum / NSEC_PER_SEC),
+            kGRKAnalyticsTimingSummaryPropertyMaximum: @((NSTimeInterval)histogram.maximum / NSEC_PER_SEC),
+            kGRKAnalyticsTimingSummaryPropertyP50: @((NSTimeInterval)[histogram valueAtPercentile:50.0] / NSEC_PER_SEC),
+            kGRKAnalyticsTimingSummaryPropertyP90: @((NSTimeInterval)[histogram valueAtPercentile:90.0] / NSEC_PER_SEC),
+            kGRKAnalyticsTimingSummaryPropertyP99: @((NSTimeInterval)[histogram valueAtPercentile:99.0] / NSEC_PER_SEC),
+            kGRKAnalyticsTimingSummaryPropertyP999: @((NSTimeInterval)[histogram valueAtPercentile:99.9] / NSEC_PER_SEC),
+        };
+        NSDictionary *allProperties = [self allPropertiesWithProperties:summary];
+        [self deliverEvent:[GRKAnalyticsEvent eventWithName:event category:category properties:allProperties]];
+    }];
+}
+
+#pragma mark - Notifications
+
+- (void)registerNotifications
+{
+#if TARGET_OS_IPHONE
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(suspendNotification:) name:UIApplicationDidEnterBackgroundNotification object:nil];
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(resumeNotification:) name:UIApplicationWillEnterForegroundNotification object:nil];
+#elif TARGET_OS_MAC
+    // Mac apps aren't suspended, but the machine may sleep.
+    NSNotificationCenter *workspaceCenter = [[NSWorkspace sharedWorkspace] notificationCenter];
+    [workspaceCenter addObserver:self selector:@selector(suspendNotification:) name:NSWorkspaceWillSleepNotification object:nil];
+    [workspaceCenter addObserver:self selector:@selector(resumeNotification:) name:NSWorkspaceDidWakeNotification object:nil];
+#endif
+}
+
+- (void)suspendNotification:(NSNotification *)notification
+{
+    [self.timerTable pause];
+}
+
+- (void)resumeNotification:(NSNotification *)notification
+{
+    [self.timerTable resume];
 }
 
 #pragma mark - Errors
@@ -426,24 +1003,209 @@
 #pragma mark - Helpers
 
 - (void)doForEachProvider:(void(^)(GRKAnalyticsProvider *provider))providerBlock
+{
+    [self doForEachProvider:providerBlock discardable:YES];
+}
+
+- (void)doForEachProvider:(void(^)(GRKAnalyticsProvider *provider))providerBlock discardable:(BOOL)discardable
 {
     if (self.enabled && providerBlock)
     {
-        for (GRKAnalyticsProvider *provider in self.providers) {
+        [self deliverToProviders:providerBlock discardable:discardable];
+    }
+}
+
+// `discardable` deliveries (events) are subject to the ingestion buffer's overflow policy when asynchronous
+// delivery is enabled. Others (configuration, user identity, etc.) never enter the buffer, as dropping them would
+// leave the providers in the wrong state.
+- (void)deliverToProviders:(void(^)(GRKAnalyticsProvider *provider))providerBlock discardable:(BOOL)discardable
+{
+    if (self.asynchronousDeliveryEnabled)
+    {
+        if (discardable)
+        {
+            [self enqueueDelivery:[providerBlock copy]];
+        }
+        else
+        {
+            [self enqueueOrderedDelivery:providerBlock];
+        }
+    }
+    else
+    {
+        for (GRKAnalyticsProvider *provider in self.orderedProviders) {
             providerBlock(provider);
         }
     }
 }
 
-- (NSDictionary *)allPropertiesWithProperties:(NSDictionary *)properties
+// Events are batched per provider when delivered asynchronously.
+- (void)deliverEvent:(GRKAnalyticsEvent *)event
 {
-    NSMutableDictionary *retVal = [NSMutableDictionary dictionaryWithDictionary:self.superProperties];
-    if (properties)
+    if (self.enabled)
+    {
+        if (self.asynchronousDeliveryEnabled)
+        {
+            [self enqueueDelivery:event];
+        }
+        else
+        {
+            for (GRKAnalyticsProvider *provider in self.orderedProviders) {
+                [provider trackEvents:@[event]];
+            }
+        }
+    }
+}
+
+// `delivery` is either a provider block, or a `GRKAnalyticsEvent`.
+- (void)enqueueDelivery:(id)delivery
+{
+    // The caller only pays for a single enqueue, regardless of the number of providers.
+    // The fan out queue then hands the delivery to each provider's own serial queue.
+    dispatch_group_enter(self.deliveryGroup);
+    
+    if ([self.ingestionBuffer enqueue:delivery])
+    {
+        dispatch_source_merge_data(self.ingestionSource, 1);
+    }
+    else
     {
-        [retVal addEntriesFromDictionary:properties];
+        dispatch_group_leave(self.deliveryGroup);
     }
+}
+
+// The delivery is held outside the ingestion buffer, where no overflow policy can evict it, and marked with the
+// buffer's next position. The fan out queue delivers it ahead of whatever is enqueued from then on, which keeps it
+// in order with the events tracked around it.
+- (void)enqueueOrderedDelivery:(void(^)(GRKAnalyticsProvider *provider))providerBlock
+{
+    dispatch_group_enter(self.deliveryGroup);
     
-    return retVal;
+    GRKOrderedDelivery *delivery = [[GRKOrderedDelivery alloc] init];
+    delivery.providerBlock = providerBlock;
+    @synchronized (self.orderedDeliveries)
+    {
+        // Taken under the lock, so the positions of the ordered deliveries never decrease.
+        delivery.position = self.ingestionBuffer.nextPosition;
+        [self.orderedDeliveries addObject:delivery];
+        atomic_fetch_add(&_orderedDeliveryCount, 1);
+    }
+    
+    dispatch_source_merge_data(self.ingestionSource, 1);
+}
+
+// Called on the fan out queue.
+- (void)drainIngestionBuffer
+{
+    GRK_GENERIC_NSARRAY(GRKAnalyticsProvider *) *providers = self.orderedProviders;
+    [self.ingestionBuffer drainWithPositions:^(id object, uint64_t position) {
+        // An ordered delivery made before this object was enqueued goes first. The count is read after the object
+        // was dequeued, so it includes any ordered delivery made before the object was enqueued.
+        [self fanOutOrderedDeliveriesBeforePosition:position providers:providers];
+        [self fanOutDelivery:object providers:providers];
+    }];
+    [self fanOutOrderedDeliveriesBeforePosition:UINT64_MAX providers:providers];
+}
+
+// Called on the fan out queue.
+- (void)fanOutOrderedDeliveriesBeforePosition:(uint64_t)position providers:(GRK_GENERIC_NSARRAY(GRKAnalyticsProvider *) *)providers
+{
+    if (atomic_load(&_orderedDeliveryCount) == 0)
+    {
+        return;
+    }
+    
+    GRK_GENERIC_NSARRAY(GRKOrderedDelivery *) *due = nil;
+    @synchronized (self.orderedDeliveries)
+    {
+        NSUInteger count = 0;
+        while (count < self.orderedDeliveries.count && self.orderedDeliveries[count].position <= position)
+        {
+            ++count;
+        }
+        due = [self.orderedDeliveries subarrayWithRange:NSMakeRange(0, count)];
+        [self.orderedDeliveries removeObjectsInRange:NSMakeRange(0, count)];
+        atomic_fetch_sub(&_orderedDeliveryCount, (unsigned int)count);
+    }
+    
+    for (GRKOrderedDelivery *delivery in due) {
+        [self fanOutDelivery:delivery.providerBlock providers:providers];
+    }
+}
+
+// Called on the fan out queue. `delivery` is either a provider block, or a `GRKAnalyticsEvent`. Leaves the delivery
+// group once the delivery has been handed to every provider.
+- (void)fanOutDelivery:(id)delivery providers:(GRK_GENERIC_NSARRAY(GRKAnalyticsProvider *) *)providers
+{
+    dispatch_group_t group = self.deliveryGroup;
+    for (GRKAnalyticsProvider *provider in providers) {
+        GRKEventBatcher *batcher = [self batcherForProvider:provider];
+        if ([delivery isKindOfClass:GRKAnalyticsEvent.class])
+        {
+            GRKAnalyticsEvent *event = delivery;
+            dispatch_group_async(group, provider.deliveryQueue, ^{
+                [batcher addEvent:event];
+            });
+        }
+        else
+        {
+            void(^providerBlock)(GRKAnalyticsProvider *provider) = delivery;
+            dispatch_group_async(group, provider.deliveryQueue, ^{
+                // Anything batched was tracked before this, so it goes first.
+                [batcher flush];
+                providerBlock(provider);
+            });
+        }
+    }
+    dispatch_group_leave(group);
+}
+
+// Called on the fan out queue.
+- (GRKEventBatcher *)batcherForProvider:(GRKAnalyticsProvider *)provider
+{
+    GRKEventBatcher *batcher = [self.batchers objectForKey:provider];
+    if (!batcher)
+    {
+        batcher = [[GRKEventBatcher alloc] initWithProvider:provider group:self.deliveryGroup];
+        [self configureBatcher:batcher];
+        [self.batchers setObject:batcher forKey:provider];
+    }
+    
+    return batcher;
+}
+
+- (void)configureBatcher:(GRKEventBatcher *)batcher
+{
+    batcher.maximumCount = self.batchMaximumCount;
+    batcher.maximumBytes = self.batchMaximumBytes;
+    batcher.maximumAge = self.batchMaximumAge;
+}
+
+- (void)updateBatchers
+{
+    dispatch_async(self.fanOutQueue, ^{
+        for (GRKEventBatcher *batcher in self.batchers.objectEnumerator) {
+            [self configureBatcher:batcher];
+        }
+    });
+}
+
+- (BOOL)waitForPendingDeliveriesWithTimeout:(NSTimeInterval)timeout
+{
+    if (self.asynchronousDeliveryEnabled)
+    {
+        // Push out any partial batches, rather than waiting for them to age.
+        [self deliverToProviders:^(GRKAnalyticsProvider *provider) {} discardable:NO];
+    }
+    
+    dispatch_time_t deadline = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC));
+    return dispatch_group_wait(self.deliveryGroup, deadline) == 0;
+}
+
+- (NSDictionary *)allPropertiesWithProperties:(NSDictionary *)properties
+{
+    // The event properties overlay the current super properties; neither is copied.
+    return [self.propertyStore propertiesWithOverlay:properties];
 }
 
 @end
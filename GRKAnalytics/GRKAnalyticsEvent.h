@@ -0,0 +1,86 @@
+//
+//  GRKAnalyticsEvent.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, GRKAnalyticsEventType) {
+	/// A generic event, as tracked by `trackEvent:category:properties:`
+	GRKAnalyticsEventTypeEvent = 0,
+	/// A timing event, as tracked by `trackTimingEvent:category:timeInterval:properties:`
+	GRKAnalyticsEventTypeTiming,
+};
+
+/**
+ An immutable record of a single tracked event, as handed to `-[GRKAnalyticsProvider trackEvents:]`.
+ */
+@interface GRKAnalyticsEvent : NSObject
+
+/**
+ The kind of event.
+ */
+@property (nonatomic, readonly) GRKAnalyticsEventType type;
+
+/**
+ The event name.
+ */
+@property (nonatomic, readonly, copy) NSString *name;
+
+/**
+ The category of the event, if any.
+ */
+@property (nonatomic, readonly, copy, nullable) NSString *category;
+
+/**
+ All properties associated with the event, including super properties.
+ */
+@property (nonatomic, readonly, copy, nullable) GRK_GENERIC_NSDICTIONARY(NSString *, id) *properties;
+
+/**
+ The amount of time elapsed, for `GRKAnalyticsEventTypeTiming` events. Zero otherwise.
+ */
+@property (nonatomic, readonly) NSTimeInterval timeInterval;
+
+/**
+ The system uptime (`-[NSProcessInfo systemUptime]`) at which the event was tracked.
+ */
+@property (nonatomic, readonly) NSTimeInterval timestamp;
+
+/**
+ A rough estimate of the number of bytes the event represents, used to size batches. This is computed once, on first access.
+ */
+@property (nonatomic, readonly) NSUInteger estimatedSize;
+
++ (instancetype)eventWithName:(NSString *)name
+					 category:(nullable NSString *)category
+				   properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
+
++ (instancetype)timingEventWithName:(NSString *)name
+						   category:(nullable NSString *)category
+					   timeInterval:(NSTimeInterval)timeInterval
+						 properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
+
+- (instancetype)initWithType:(GRKAnalyticsEventType)type
+						name:(NSString *)name
+					category:(nullable NSString *)category
+				timeInterval:(NSTimeInterval)timeInterval
+				  properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
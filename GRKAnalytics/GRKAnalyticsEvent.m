@@ -0,0 +1,85 @@
+//
+//  GRKAnalyticsEvent.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKAnalyticsEvent.h"
+
+// The size attributed to values which are not strings (numbers, dates, etc.)
+static NSUInteger const kGRKAnalyticsEventScalarValueSize = 8;
+
+@implementation GRKAnalyticsEvent
+{
+	NSUInteger _estimatedSize;
+}
+
+#pragma mark - Lifecycle
+
++ (instancetype)eventWithName:(NSString *)name
+					 category:(nullable NSString *)category
+				   properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+	return [[self alloc] initWithType:GRKAnalyticsEventTypeEvent name:name category:category timeInterval:0 properties:properties];
+}
+
++ (instancetype)timingEventWithName:(NSString *)name
+						   category:(nullable NSString *)category
+					   timeInterval:(NSTimeInterval)timeInterval
+						 properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+	return [[self alloc] initWithType:GRKAnalyticsEventTypeTiming name:name category:category timeInterval:timeInterval properties:properties];
+}
+
+- (instancetype)initWithType:(GRKAnalyticsEventType)type
+						name:(NSString *)name
+					category:(nullable NSString *)category
+				timeInterval:(NSTimeInterval)timeInterval
+				  properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+	if ((self = [super init])) {
+		_type = type;
+		_name = [name copy];
+		_category = [category copy];
+		_timeInterval = timeInterval;
+		_properties = [properties copy];
+		_timestamp = [[NSProcessInfo processInfo] systemUptime];
+	}
+
+	return self;
+}
+
+#pragma mark - Accessors
+
+- (NSUInteger)estimatedSize
+{
+	// Benign race: concurrent callers compute the same value.
+	if (_estimatedSize == 0) {
+		NSUInteger size = self.name.length + self.category.length + kGRKAnalyticsEventScalarValueSize;
+		for (NSString *key in self.properties) {
+			id value = self.properties[key];
+			size += key.length;
+			size += [value isKindOfClass:NSString.class] ? [(NSString *)value length] : kGRKAnalyticsEventScalarValueSize;
+		}
+		_estimatedSize = size;
+	}
+
+	return _estimatedSize;
+}
+
+#pragma mark - NSObject
+
+- (NSString *)description
+{
+	return [NSString stringWithFormat:@"<%@: %p; type = %d; name = %@; category = %@; timeInterval = %f; properties = %@>", NSStringFromClass(self.class), self, (int)self.type, self.name, self.category, self.timeInterval, self.properties];
+}
+
+@end
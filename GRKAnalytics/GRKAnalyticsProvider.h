@@ -14,6 +14,8 @@
 
 #import <Foundation/Foundation.h>
 #import "GRKLanguageFeatures.h"
+#import "GRKAnalyticsEvent.h"
+#import "GRKDeliveryPlan.h"
 @class GRKAnalyticsProvider;
 
 NS_ASSUME_NONNULL_BEGIN
@@ -42,6 +44,7 @@ extern NSString * const GRKAnalyticsEventKeyEventDuration;
 
 /**
  Delegate which will be called to translate event names, parameter keys, etc.
+ The delegate is asked about a given name or key once, and its answer is remembered. Call `invalidateDelegateTranslations` if its answers change.
  */
 @property (nonatomic, weak) id<GRKAnalyticsProviderDelegate> delegate;
 
@@ -76,6 +79,30 @@ events to the providers if disabled, this method allows the provider to take add
  */
 @property (nonatomic, nonnull, copy) NSString *successPropertyName;
 
+/**
+ The maximum number of properties delivered with an event. Properties beyond the budget are dropped before they are sanitized, and counted in `droppedPropertyCount`.
+ Which properties are kept is decided by `parameterPriorityKeys`, then the event's own properties before super properties, then key order.
+ Defaults to `NSUIntegerMax` (no budget); providers for services with a limit set it to that limit.
+ */
+@property (atomic, assign) NSUInteger parameterBudget;
+
+/**
+ Property keys (before translation by the delegate) to keep first when an event has more properties than `parameterBudget`, most important first.
+ */
+@property (atomic, copy, nullable) GRK_GENERIC_NSARRAY(NSString *) *parameterPriorityKeys;
+
+/**
+ The number of properties dropped because they did not fit `parameterBudget`, since the provider was created.
+ */
+@property (atomic, readonly) NSUInteger droppedPropertyCount;
+
+/**
+ The serial queue on which `GRKAnalytics` calls this provider when asynchronous delivery is enabled.
+ Each provider has its own queue, so a slow provider does not hold up delivery to the others, and events are delivered to a given provider in the order they were tracked.
+ @see `+[GRKAnalytics setAsynchronousDeliveryEnabled:]`
+ */
+@property (nonatomic, readonly) dispatch_queue_t deliveryQueue;
+
 #pragma mark - User
 
 #pragma mark User Identity
@@ -193,6 +220,18 @@ events to the providers if disabled, this method allows the provider to take add
             timeInterval:(NSTimeInterval)timeInterval
               properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
 
+#pragma mark - Batches
+
+/**
+ * Track a batch of events.
+ * When asynchronous delivery is enabled `GRKAnalytics` accumulates events tracked with `trackEvent:category:properties:` and `trackTimeEnd:category:properties:` and delivers them through this method, in batches limited by count, size and age.
+ * The default implementation calls `trackEvent:category:properties:` or `trackTimingEvent:category:timeInterval:properties:` for each event, in order. Providers which can amortize work across several events (a single network request or file write, for example) should override this.
+ *
+ * @param events The events to track, in the order they were tracked.
+ * @see `+[GRKAnalytics setBatchMaximumCount:]`
+ */
+- (void)trackEvents:(GRK_GENERIC_NSARRAY(GRKAnalyticsEvent *) *)events;
+
 #pragma mark - Errors
 
 /**
@@ -218,7 +257,7 @@ events to the providers if disabled, this method allows the provider to take add
  * Queries the delegate, if any, to offer alternative property keys for the keys of the given property dictionary.
  *
  * @param properties The property dictionary whose keys are to be inspected (and possibly augmented) by the delegate.
- * @return A new dictionary, which, for each key in the given dictionary, if a non-nil answer is available from the delegate, that answer will be replace the original key, otherwise this the original property key is left intact.
+ * @return A dictionary, which, for each key in the given dictionary, if a non-nil answer is available from the delegate, that answer will be replace the original key, otherwise this the original property key is left intact. If no keys are replaced this may be the given dictionary.
  */
 - (NSDictionary *)delegatePropertiesForProperties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
 
@@ -230,6 +269,55 @@ events to the providers if disabled, this method allows the provider to take add
  */
 - (nullable NSString *)delegateEventForEvent:(nullable NSString *)event;
 
+/**
+ * Returns the plan for delivering the given event with properties having the keys of the given properties.
+ * Plans are cached by event name and property key set, so the delegate is asked about, and the provider sanitizes, a given event name and key set only once.
+ *
+ * @param event      The event name, before translation by the delegate.
+ * @param properties The properties of the event, before translation by the delegate. Only the keys are considered.
+ * @return The delivery plan.
+ */
+- (GRKDeliveryPlan *)deliveryPlanForEvent:(NSString *)event properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
+
+/**
+ Returns the plan for delivering the given event, leaving room in `parameterBudget` for parameters the provider adds itself (a category, for example).
+ The plan admits at most `parameterBudget` less `reservedParameterCount` properties.
+
+ @param event                  The event name, before translation by the delegate.
+ @param properties             The properties of the event, before translation by the delegate. Only the keys (and, for the priority of super properties, the layering) are considered.
+ @param reservedParameterCount The number of parameters the provider will add to the delivered properties.
+ @return The delivery plan.
+ */
+- (GRKDeliveryPlan *)deliveryPlanForEvent:(NSString *)event properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties reservedParameterCount:(NSUInteger)reservedParameterCount;
+
+/**
+ * Sanitizes an event name, already translated by the delegate, for delivery.
+ * Called when a delivery plan is made. The default implementation returns the given event name; subclasses override this to conform to the requirements of their service.
+ *
+ * @param event The event name to sanitize.
+ * @return The sanitized event name, or `nil` if the event should not be delivered.
+ */
+- (nullable NSString *)sanitizedEventForEvent:(NSString *)event;
+
+/**
+ * Discards the cached delivery plans.
+ * This is done by `invalidateDelegateTranslations`, and should be called by subclasses whose sanitizing changes.
+ */
+- (void)invalidateDeliveryPlans;
+
+/**
+ * Adds to `droppedPropertyCount`. Call this with the `droppedPropertyCount` of each plan used, and for any properties dropped otherwise to stay within `parameterBudget`.
+ *
+ * @param count The number of properties dropped.
+ */
+- (void)recordDroppedProperties:(NSUInteger)count;
+
+/**
+ * Discards the remembered answers of the delegate, along with the delivery plans made from them.
+ * This is done automatically when the delegate is set, and should be called if the delegate will give different answers than it has before.
+ */
+- (void)invalidateDelegateTranslations;
+
 #pragma mark - Helpers
 
 
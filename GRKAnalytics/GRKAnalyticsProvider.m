@@ -13,6 +13,9 @@
 //
 
 #import "GRKAnalyticsProvider.h"
+#import "GRKOverlayDictionary.h"
+#import "GRKLayeredDictionary.h"
+#import <stdatomic.h>
 
 NSString * const kGRKAnalyticsProviderDefaultEventKeyAppBecameActive = @"app_became_active";
 NSString * const kGRKAnalyticsProviderDefaultEventKeyError = @"error";
@@ -23,16 +26,95 @@ NSString * const kGRKAnalyticsProviderDefaultPropertyKeyUserEmail = @"user_email
 
 NSString *const GRKAnalyticsEventKeyEventDuration = @"event_duration";
 
+static NSUInteger const kGRKAnalyticsProviderDeliveryPlanCountLimit = 1024;
+static NSUInteger const kGRKAnalyticsProviderTranslationCountLimit = 2048;
+
 @interface GRKAnalyticsProvider ()
 
 @property (nonatomic,assign) BOOL enabled;
+@property (nonatomic,strong) NSCache<GRKDeliveryPlanKey *, GRKDeliveryPlan *> *deliveryPlans;
+// Delegate answers, keyed by the key asked about. Keys without a translation map to themselves.
+@property (nonatomic,strong) NSCache<NSString *, NSString *> *eventTranslations;
+@property (nonatomic,strong) NSCache<NSString *, NSString *> *propertyTranslations;
+// Whether the delegate implements the optional methods, checked when the delegate is set.
+@property (atomic,assign) BOOL delegateTranslatesEvents;
+@property (atomic,assign) BOOL delegateTranslatesProperties;
 
 @end
 
 @implementation GRKAnalyticsProvider
+{
+	atomic_size_t _droppedPropertyCount;
+}
+
+@synthesize parameterBudget = _parameterBudget;
+@synthesize parameterPriorityKeys = _parameterPriorityKeys;
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		NSString *label = [NSString stringWithFormat:@"com.levigroker.GRKAnalytics.delivery.%@", NSStringFromClass(self.class)];
+		_deliveryQueue = dispatch_queue_create(label.UTF8String, DISPATCH_QUEUE_SERIAL);
+		_deliveryPlans = [[NSCache alloc] init];
+		_deliveryPlans.countLimit = kGRKAnalyticsProviderDeliveryPlanCountLimit;
+		_eventTranslations = [[NSCache alloc] init];
+		_eventTranslations.countLimit = kGRKAnalyticsProviderTranslationCountLimit;
+		_propertyTranslations = [[NSCache alloc] init];
+		_propertyTranslations.countLimit = kGRKAnalyticsProviderTranslationCountLimit;
+		_parameterBudget = NSUIntegerMax;
+		atomic_init(&_droppedPropertyCount, 0);
+	}
+	
+	return self;
+}
 
 #pragma mark - Accessors
 
+- (void)setDelegate:(nullable id<GRKAnalyticsProviderDelegate>)delegate
+{
+	_delegate = delegate;
+	self.delegateTranslatesEvents = [delegate respondsToSelector:@selector(provider:eventForEvent:)];
+	self.delegateTranslatesProperties = [delegate respondsToSelector:@selector(provider:propertyForProperty:)];
+	[self invalidateDelegateTranslations];
+}
+
+- (NSUInteger)parameterBudget
+{
+	@synchronized (self) {
+		return _parameterBudget;
+	}
+}
+
+- (void)setParameterBudget:(NSUInteger)parameterBudget
+{
+	@synchronized (self) {
+		_parameterBudget = parameterBudget;
+	}
+	[self invalidateDeliveryPlans];
+}
+
+- (nullable NSArray<NSString *> *)parameterPriorityKeys
+{
+	@synchronized (self) {
+		return _parameterPriorityKeys;
+	}
+}
+
+- (void)setParameterPriorityKeys:(nullable NSArray<NSString *> *)parameterPriorityKeys
+{
+	@synchronized (self) {
+		_parameterPriorityKeys = [parameterPriorityKeys copy];
+	}
+	[self invalidateDeliveryPlans];
+}
+
+- (NSUInteger)droppedPropertyCount
+{
+	return atomic_load_explicit(&_droppedPropertyCount, memory_order_relaxed);
+}
+
 - (NSString *)errorEventName
 {
 	if (!_errorEventName) {
@@ -141,10 +223,25 @@ NSString *const GRKAnalyticsEventKeyEventDuration = @"event_duration";
 {
     NSAssert(!properties[GRKAnalyticsEventKeyEventDuration], @"Timing event '%@' contains custom property which conflicts with internal key '%@'", event, GRKAnalyticsEventKeyEventDuration);
     
-    NSMutableDictionary *mutableProperties = [NSMutableDictionary dictionaryWithDictionary:properties];
-    mutableProperties[GRKAnalyticsEventKeyEventDuration] = @(timeInterval);
+    properties = [GRKOverlayDictionary dictionaryWithBase:properties object:@(timeInterval) forKey:GRKAnalyticsEventKeyEventDuration];
     
-    [self trackEvent:event category:category properties:mutableProperties];
+    [self trackEvent:event category:category properties:properties];
+}
+
+#pragma mark - Batches
+
+- (void)trackEvents:(GRK_GENERIC_NSARRAY(GRKAnalyticsEvent *) *)events
+{
+	for (GRKAnalyticsEvent *event in events) {
+		switch (event.type) {
+			case GRKAnalyticsEventTypeEvent:
+				[self trackEvent:event.name category:event.category properties:event.properties];
+				break;
+			case GRKAnalyticsEventTypeTiming:
+				[self trackTimingEvent:event.name category:event.category timeInterval:event.timeInterval properties:event.properties];
+				break;
+		}
+	}
 }
 
 #pragma mark - Errors
@@ -160,11 +257,10 @@ NSString *const GRKAnalyticsEventKeyEventDuration = @"event_duration";
 {
 	NSString *retVal = property;
 	
-	if ([self.delegate respondsToSelector:@selector(provider:propertyForProperty:)]) {
-		NSString *key = [self.delegate provider:self propertyForProperty:property];
-		if (key) {
-			retVal = key;
-		}
+	if (property && self.delegateTranslatesProperties) {
+		retVal = [self translationForKey:property cache:self.propertyTranslations translator:^NSString *(id<GRKAnalyticsProviderDelegate> delegate, NSString *key) {
+			return [delegate provider:self propertyForProperty:key];
+		}];
 	}
 	
 	return retVal;
@@ -172,17 +268,23 @@ NSString *const GRKAnalyticsEventKeyEventDuration = @"event_duration";
 
 - (NSDictionary *)delegatePropertiesForProperties:(nullable NSDictionary *)properties
 {
-	NSMutableDictionary *retVal = [NSMutableDictionary dictionaryWithDictionary:properties ?: @{}];
+	NSDictionary *retVal = properties ?: @{};
 	
-	if ([self.delegate respondsToSelector:@selector(provider:propertyForProperty:)]) {
-		NSArray *keys = [retVal allKeys];
-		for (NSString *key in keys) {
-			NSString *delegateKey = [self.delegate provider:self propertyForProperty:key];
-			if (delegateKey && ![delegateKey isEqualToString:key]) {
-				retVal[delegateKey] = retVal[key];
-				retVal[key] = nil;
+	if (self.delegateTranslatesProperties) {
+		NSMutableDictionary *translated = nil;
+		for (NSString *key in retVal) {
+			NSString *delegateKey = [self delegatePropertyForProperty:key];
+			if (![delegateKey isEqualToString:key]) {
+				if (!translated) {
+					translated = [NSMutableDictionary dictionaryWithDictionary:retVal];
+				}
+				translated[delegateKey] = retVal[key];
+				translated[key] = nil;
 			}
 		}
+		if (translated) {
+			retVal = translated;
+		}
 	}
 	
 	return retVal;
@@ -192,18 +294,127 @@ NSString *const GRKAnalyticsEventKeyEventDuration = @"event_duration";
 {
 	NSString *retVal = event;
 	
-	if ([self.delegate respondsToSelector:@selector(provider:eventForEvent:)]) {
-		NSString *key = [self.delegate provider:self eventForEvent:event];
-		if (key) {
-			retVal = key;
-		}
+	if (event && self.delegateTranslatesEvents) {
+		retVal = [self translationForKey:event cache:self.eventTranslations translator:^NSString *(id<GRKAnalyticsProviderDelegate> delegate, NSString *key) {
+			return [delegate provider:self eventForEvent:key];
+		}];
 	}
 	
 	return retVal;
 }
 
+- (void)invalidateDelegateTranslations
+{
+	[self.eventTranslations removeAllObjects];
+	[self.propertyTranslations removeAllObjects];
+	[self invalidateDeliveryPlans];
+}
+
+- (GRKDeliveryPlan *)deliveryPlanForEvent:(NSString *)event properties:(nullable NSDictionary *)properties
+{
+	return [self deliveryPlanForEvent:event properties:properties reservedParameterCount:0];
+}
+
+- (GRKDeliveryPlan *)deliveryPlanForEvent:(NSString *)event properties:(nullable NSDictionary *)properties reservedParameterCount:(NSUInteger)reservedParameterCount
+{
+	NSUInteger parameterBudget = self.parameterBudget;
+	NSUInteger budget = parameterBudget > reservedParameterCount ? parameterBudget - reservedParameterCount : 0;
+	// Which properties are admitted over budget depends on which are the event's own, so then they are part of the key.
+	NSDictionary *eventProperties = properties.count > budget ? [self eventPropertiesForProperties:properties] : nil;
+
+	GRKDeliveryPlanKey *key = [GRKDeliveryPlanKey lookupKeyWithEvent:event properties:properties eventProperties:eventProperties reservedParameterCount:reservedParameterCount];
+	GRKDeliveryPlan *retVal = [self.deliveryPlans objectForKey:key];
+
+	if (!retVal) {
+		NSString *delegateEvent = [self delegateEventForEvent:event];
+		NSString *sanitizedEvent = delegateEvent ? [self sanitizedEventForEvent:delegateEvent] : nil;
+
+		NSMutableDictionary<NSString *, NSString *> *keyMapping = [NSMutableDictionary dictionary];
+		if (self.delegateTranslatesProperties) {
+			for (NSString *propertyKey in properties) {
+				NSString *delegateKey = [self delegatePropertyForProperty:propertyKey];
+				if (![delegateKey isEqualToString:propertyKey]) {
+					keyMapping[propertyKey] = delegateKey;
+				}
+			}
+		}
+
+		NSSet<NSString *> *admittedKeys = properties.count > budget ? [self admittedKeysForProperties:properties eventProperties:eventProperties budget:budget] : nil;
+
+		retVal = [[GRKDeliveryPlan alloc] initWithEvent:sanitizedEvent keyMapping:keyMapping admittedKeys:admittedKeys droppedPropertyCount:admittedKeys ? properties.count - admittedKeys.count : 0];
+		[self.deliveryPlans setObject:retVal forKey:[key storageKey]];
+	}
+
+	return retVal;
+}
+
+- (nullable NSString *)sanitizedEventForEvent:(NSString *)event
+{
+	return event;
+}
+
+- (void)invalidateDeliveryPlans
+{
+	[self.deliveryPlans removeAllObjects];
+}
+
+- (void)recordDroppedProperties:(NSUInteger)count
+{
+	if (count > 0) {
+		atomic_fetch_add_explicit(&_droppedPropertyCount, count, memory_order_relaxed);
+	}
+}
+
 #pragma mark - Helpers
 
+// Chooses which properties fill the budget: the `parameterPriorityKeys` in order, then the event's own properties, then super properties. Keys of equal priority are taken in key order, so the choice is the same every time.
+- (NSSet<NSString *> *)admittedKeysForProperties:(NSDictionary *)properties eventProperties:(nullable NSDictionary *)eventProperties budget:(NSUInteger)budget
+{
+	NSMutableSet<NSString *> *retVal = [NSMutableSet setWithCapacity:budget];
+
+	for (NSString *key in self.parameterPriorityKeys) {
+		if (retVal.count >= budget) {
+			return retVal;
+		}
+		if (properties[key]) {
+			[retVal addObject:key];
+		}
+	}
+
+	for (NSDictionary *tier in eventProperties ? @[eventProperties, properties] : @[properties]) {
+		for (NSString *key in [tier.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+			if (retVal.count >= budget) {
+				return retVal;
+			}
+			[retVal addObject:key];
+		}
+	}
+
+	return retVal;
+}
+
+// Super properties are layered beneath the event's own properties by `GRKAnalytics`.
+- (nullable NSDictionary *)eventPropertiesForProperties:(NSDictionary *)properties
+{
+	return [properties isKindOfClass:GRKLayeredDictionary.class] ? ((GRKLayeredDictionary *)properties).top : nil;
+}
+
+- (NSString *)translationForKey:(NSString *)key cache:(NSCache<NSString *, NSString *> *)cache translator:(NSString * _Nullable (^)(id<GRKAnalyticsProviderDelegate> delegate, NSString *key))translator
+{
+	id<GRKAnalyticsProviderDelegate> delegate = self.delegate;
+	if (!delegate) {
+		return key;
+	}
+
+	NSString *retVal = [cache objectForKey:key];
+	if (!retVal) {
+		retVal = translator(delegate, key) ?: key;
+		[cache setObject:retVal forKey:key];
+	}
+
+	return retVal;
+}
+
 - (nullable NSString *)cropString:(nullable NSString *)string maxLength:(NSUInteger)maxLength
 {
 	NSString *retVal = string;
@@ -0,0 +1,93 @@
+//
+//  GRKDeliveryPlan.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/**
+ The work a provider does to deliver a given event name with a given set of property keys, done once and kept for reuse.
+ Plans are immutable, and are created and cached by `-[GRKAnalyticsProvider deliveryPlanForEvent:properties:]`.
+ */
+@interface GRKDeliveryPlan : NSObject
+
+/**
+ The event name to deliver, as translated by the delegate and sanitized by the provider.
+ If `nil` or empty, the event should not be delivered.
+ */
+@property (nonatomic, readonly, copy, nullable) NSString *event;
+
+/**
+ The keys translated by the delegate, mapped from the original key to the translated key. Keys which are not translated are not included.
+ */
+@property (nonatomic, readonly, copy) GRK_GENERIC_NSDICTIONARY(NSString *, NSString *) *keyMapping;
+
+/**
+ The original keys of the properties to deliver, when the provider's parameter budget does not admit them all. If `nil`, every property is delivered.
+ */
+@property (nonatomic, readonly, copy, nullable) NSSet<NSString *> *admittedKeys;
+
+/**
+ The number of properties left out by `admittedKeys`.
+ */
+@property (nonatomic, readonly) NSUInteger droppedPropertyCount;
+
+- (instancetype)initWithEvent:(nullable NSString *)event keyMapping:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, NSString *) *)keyMapping;
+- (instancetype)initWithEvent:(nullable NSString *)event keyMapping:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, NSString *) *)keyMapping admittedKeys:(nullable NSSet<NSString *> *)admittedKeys droppedPropertyCount:(NSUInteger)droppedPropertyCount NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Applies the key mapping, and the admitted keys, to the given properties.
+
+ @param properties The properties whose keys to translate. These should have the key set the plan was made for.
+ @return The admitted properties with translated keys. If every key is admitted and no keys are translated, the given properties are returned.
+ */
+- (GRK_GENERIC_NSDICTIONARY(NSString *, id) *)propertiesForProperties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
+
+@end
+
+/**
+ The key of a cached `GRKDeliveryPlan`: an event name, a set of property keys, and the number of parameters reserved by the provider.
+ When the plan's admitted keys depend on which properties are the event's own (rather than super properties), the key also includes the set of the event's own property keys.
+ A key made for a lookup refers to the properties being delivered rather than copying their keys.
+ */
+@interface GRKDeliveryPlanKey : NSObject <NSCopying>
+
+/**
+ Returns a key which refers to the given properties, for looking up a plan.
+ */
++ (instancetype)lookupKeyWithEvent:(NSString *)event properties:(nullable NSDictionary *)properties;
+
+/**
+ Returns a key which refers to the given properties, for looking up a plan which leaves room in the parameter budget for parameters the provider adds itself.
+ */
++ (instancetype)lookupKeyWithEvent:(NSString *)event properties:(nullable NSDictionary *)properties reservedParameterCount:(NSUInteger)reservedParameterCount;
+
+/**
+ Returns a key which refers to the given properties, for looking up a plan whose admitted keys depend on which of the properties are the event's own.
+
+ @param eventProperties The event's own properties, a subset of `properties`, or `nil` if the plan does not depend on them.
+ */
++ (instancetype)lookupKeyWithEvent:(NSString *)event properties:(nullable NSDictionary *)properties eventProperties:(nullable NSDictionary *)eventProperties reservedParameterCount:(NSUInteger)reservedParameterCount;
+
+/**
+ Returns a key which holds its own copy of the property keys, for storing a plan.
+ */
+- (instancetype)storageKey;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,200 @@
+//
+//  GRKDeliveryPlan.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKDeliveryPlan.h"
+
+@implementation GRKDeliveryPlan
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithEvent:(nullable NSString *)event keyMapping:(nullable NSDictionary<NSString *, NSString *> *)keyMapping
+{
+	return [self initWithEvent:event keyMapping:keyMapping admittedKeys:nil droppedPropertyCount:0];
+}
+
+- (instancetype)initWithEvent:(nullable NSString *)event keyMapping:(nullable NSDictionary<NSString *, NSString *> *)keyMapping admittedKeys:(nullable NSSet<NSString *> *)admittedKeys droppedPropertyCount:(NSUInteger)droppedPropertyCount
+{
+	if ((self = [super init])) {
+		_event = [event copy];
+		_keyMapping = [keyMapping copy] ?: @{};
+		_admittedKeys = [admittedKeys copy];
+		_droppedPropertyCount = droppedPropertyCount;
+	}
+
+	return self;
+}
+
+#pragma mark - Implementation
+
+- (NSDictionary<NSString *, id> *)propertiesForProperties:(nullable NSDictionary<NSString *, id> *)properties
+{
+	NSSet<NSString *> *admittedKeys = self.admittedKeys;
+	if (self.keyMapping.count == 0 && !admittedKeys) {
+		return properties ?: @{};
+	}
+
+	NSMutableDictionary<NSString *, id> *retVal = [NSMutableDictionary dictionaryWithCapacity:admittedKeys ? admittedKeys.count : properties.count];
+	NSDictionary<NSString *, NSString *> *keyMapping = self.keyMapping;
+	if (admittedKeys) {
+		for (NSString *key in admittedKeys) {
+			id object = properties[key];
+			if (object) {
+				retVal[keyMapping[key] ?: key] = object;
+			}
+		}
+	}
+	else {
+		[properties enumerateKeysAndObjectsUsingBlock:^(NSString *key, id object, BOOL *stop) {
+			retVal[keyMapping[key] ?: key] = object;
+		}];
+	}
+
+	return retVal;
+}
+
+@end
+
+@interface GRKDeliveryPlanKey ()
+
+@property (nonatomic, copy) NSString *event;
+// Either the NSDictionary being delivered (lookup keys) or an NSSet of its keys (storage keys).
+@property (nonatomic, strong, nullable) id keys;
+@property (nonatomic, assign) NSUInteger count;
+// Likewise for the event's own properties, when they are part of the key.
+@property (nonatomic, strong, nullable) id eventKeys;
+@property (nonatomic, assign) NSUInteger eventCount;
+@property (nonatomic, assign) NSUInteger reservedParameterCount;
+@property (nonatomic, assign) NSUInteger keyHash;
+
+- (BOOL)containsKey:(id)key;
+- (BOOL)containsEventKey:(id)key;
+
+@end
+
+@implementation GRKDeliveryPlanKey
+
+#pragma mark - Lifecycle
+
++ (instancetype)lookupKeyWithEvent:(NSString *)event properties:(nullable NSDictionary *)properties
+{
+	return [self lookupKeyWithEvent:event properties:properties reservedParameterCount:0];
+}
+
++ (instancetype)lookupKeyWithEvent:(NSString *)event properties:(nullable NSDictionary *)properties reservedParameterCount:(NSUInteger)reservedParameterCount
+{
+	return [self lookupKeyWithEvent:event properties:properties eventProperties:nil reservedParameterCount:reservedParameterCount];
+}
+
++ (instancetype)lookupKeyWithEvent:(NSString *)event properties:(nullable NSDictionary *)properties eventProperties:(nullable NSDictionary *)eventProperties reservedParameterCount:(NSUInteger)reservedParameterCount
+{
+	GRKDeliveryPlanKey *retVal = [[self alloc] init];
+	retVal.event = event;
+	retVal.keys = properties;
+	retVal.count = properties.count;
+	retVal.eventKeys = eventProperties;
+	retVal.eventCount = eventProperties.count;
+	retVal.reservedParameterCount = reservedParameterCount;
+
+	NSUInteger hash = event.hash ^ properties.count ^ (reservedParameterCount << 16) ^ (eventProperties.count << 24);
+	for (id key in properties) {
+		// XOR, so the hash does not depend on the order of enumeration.
+		hash ^= [key hash];
+	}
+	for (id key in eventProperties) {
+		// Added rather than XORed, as these keys are also among `properties`.
+		hash += [key hash];
+	}
+	retVal.keyHash = hash;
+
+	return retVal;
+}
+
+- (instancetype)storageKey
+{
+	GRKDeliveryPlanKey *retVal = [[GRKDeliveryPlanKey alloc] init];
+	retVal.event = self.event;
+	retVal.keys = [self.keys isKindOfClass:NSDictionary.class] ? [NSSet setWithArray:[self.keys allKeys]] : self.keys;
+	retVal.count = self.count;
+	retVal.eventKeys = [self.eventKeys isKindOfClass:NSDictionary.class] ? [NSSet setWithArray:[self.eventKeys allKeys]] : self.eventKeys;
+	retVal.eventCount = self.eventCount;
+	retVal.reservedParameterCount = self.reservedParameterCount;
+	retVal.keyHash = self.keyHash;
+
+	return retVal;
+}
+
+#pragma mark - NSObject
+
+- (NSUInteger)hash
+{
+	return self.keyHash;
+}
+
+- (BOOL)isEqual:(id)object
+{
+	if (object == self) {
+		return YES;
+	}
+	if (![object isKindOfClass:GRKDeliveryPlanKey.class]) {
+		return NO;
+	}
+
+	GRKDeliveryPlanKey *other = object;
+	if (other.keyHash != self.keyHash || other.count != self.count || other.eventCount != self.eventCount || other.reservedParameterCount != self.reservedParameterCount || (other.eventKeys == nil) != (self.eventKeys == nil) || ![other.event isEqualToString:self.event]) {
+		return NO;
+	}
+
+	// Equal counts, so every key of one being in the other means the key sets are equal.
+	for (id key in self.keys) {
+		if (![other containsKey:key]) {
+			return NO;
+		}
+	}
+	for (id key in self.eventKeys) {
+		if (![other containsEventKey:key]) {
+			return NO;
+		}
+	}
+
+	return YES;
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(nullable NSZone *)zone
+{
+	return [self storageKey];
+}
+
+#pragma mark - Helpers
+
+- (BOOL)containsKey:(id)key
+{
+	if ([self.keys isKindOfClass:NSDictionary.class]) {
+		return [(NSDictionary *)self.keys objectForKey:key] != nil;
+	}
+
+	return [(NSSet *)self.keys member:key] != nil;
+}
+
+- (BOOL)containsEventKey:(id)key
+{
+	if ([self.eventKeys isKindOfClass:NSDictionary.class]) {
+		return [(NSDictionary *)self.eventKeys objectForKey:key] != nil;
+	}
+
+	return [(NSSet *)self.eventKeys member:key] != nil;
+}
+
+@end
@@ -0,0 +1,79 @@
+//
+//  GRKEventBatcher.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+@class GRKAnalyticsProvider;
+@class GRKAnalyticsEvent;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Accumulates events for a single provider and hands them to `-[GRKAnalyticsProvider trackEvents:]` once the batch reaches a maximum count, size, or age.
+
+ All methods must be called on the provider's `deliveryQueue`.
+ */
+@interface GRKEventBatcher : NSObject
+
+/**
+ The provider the batches are delivered to.
+ */
+@property (nonatomic, readonly, weak) GRKAnalyticsProvider *provider;
+
+/**
+ The batch is delivered once it holds this many events.
+ */
+@property (atomic, assign) NSUInteger maximumCount;
+
+/**
+ The batch is delivered once the `estimatedSize` of its events reaches this many bytes.
+ */
+@property (atomic, assign) NSUInteger maximumBytes;
+
+/**
+ The batch is delivered once its oldest event has been waiting this many seconds.
+ */
+@property (atomic, assign) NSTimeInterval maximumAge;
+
+/**
+ The number of events waiting to be delivered.
+ */
+@property (nonatomic, readonly) NSUInteger pendingCount;
+
+/**
+ Create a new batcher.
+
+ @param provider The provider to deliver batches to.
+ @param group    A group which is entered while a batch is pending, so waiting on it includes batched events.
+ @return A new batcher, with an empty batch.
+ */
+- (instancetype)initWithProvider:(GRKAnalyticsProvider *)provider group:(dispatch_group_t)group NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Add an event to the batch, delivering the batch if it is now full.
+
+ @param event The event to add.
+ */
+- (void)addEvent:(GRKAnalyticsEvent *)event;
+
+/**
+ Deliver the pending batch now, if there is one.
+ */
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,108 @@
+//
+//  GRKEventBatcher.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKEventBatcher.h"
+#import "GRKAnalyticsEvent.h"
+#import "GRKAnalyticsProvider.h"
+
+@interface GRKEventBatcher ()
+
+@property (nonatomic, strong) dispatch_group_t group;
+@property (nonatomic, strong) NSMutableArray<GRKAnalyticsEvent *> *batch;
+@property (nonatomic, assign) NSUInteger batchBytes;
+// Incremented with each delivered batch, so a stale age timer can tell its batch has already gone.
+@property (nonatomic, assign) NSUInteger generation;
+
+@end
+
+@implementation GRKEventBatcher
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithProvider:(GRKAnalyticsProvider *)provider group:(dispatch_group_t)group
+{
+	if ((self = [super init])) {
+		_provider = provider;
+		_group = group;
+		_batch = [NSMutableArray array];
+		_maximumCount = 1;
+		_maximumBytes = NSUIntegerMax;
+		_maximumAge = 0;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	// Balance the group for a batch which will now never be delivered.
+	if (_batch.count > 0) {
+		dispatch_group_leave(_group);
+	}
+}
+
+#pragma mark - Accessors
+
+- (NSUInteger)pendingCount
+{
+	return self.batch.count;
+}
+
+#pragma mark - Batching
+
+- (void)addEvent:(GRKAnalyticsEvent *)event
+{
+	if (self.batch.count == 0) {
+		dispatch_group_enter(self.group);
+		[self scheduleAgeLimit];
+	}
+
+	[self.batch addObject:event];
+	self.batchBytes += event.estimatedSize;
+
+	if (self.batch.count >= self.maximumCount || self.batchBytes >= self.maximumBytes) {
+		[self flush];
+	}
+}
+
+- (void)flush
+{
+	if (self.batch.count > 0) {
+		NSArray<GRKAnalyticsEvent *> *events = [self.batch copy];
+		[self.batch removeAllObjects];
+		self.batchBytes = 0;
+		self.generation += 1;
+
+		[self.provider trackEvents:events];
+
+		dispatch_group_leave(self.group);
+	}
+}
+
+- (void)scheduleAgeLimit
+{
+	GRKAnalyticsProvider *provider = self.provider;
+	NSTimeInterval maximumAge = self.maximumAge;
+	if (provider && maximumAge > 0 && self.maximumCount > 1) {
+		NSUInteger generation = self.generation;
+		__weak typeof(self) weakSelf = self;
+		dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(maximumAge * NSEC_PER_SEC)), provider.deliveryQueue, ^{
+			if (weakSelf.generation == generation) {
+				[weakSelf flush];
+			}
+		});
+	}
+}
+
+@end
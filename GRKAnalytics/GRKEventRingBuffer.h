@@ -0,0 +1,132 @@
+//
+//  GRKEventRingBuffer.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ What to do when an object is enqueued into a full `GRKEventRingBuffer`.
+ */
+typedef NS_ENUM(NSInteger, GRKEventRingBufferOverflowPolicy) {
+	/// The object being enqueued is discarded.
+	GRKEventRingBufferOverflowPolicyDropNewest = 0,
+	/// The oldest object in the buffer is discarded to make room for the object being enqueued.
+	GRKEventRingBufferOverflowPolicyDropOldest,
+	/// The producer waits for room, up to `blockTimeout`, after which the object being enqueued is discarded.
+	GRKEventRingBufferOverflowPolicyBlock,
+};
+
+/**
+ A bounded, lock-free, multiple producer queue of objects.
+
+ Any number of threads may enqueue concurrently without blocking each other. Objects are dequeued in the order they were enqueued (per producer), and are intended to be consumed by a single consumer.
+ */
+@interface GRKEventRingBuffer : NSObject
+
+/**
+ The maximum number of objects the buffer can hold. This is the requested capacity rounded up to a power of two.
+ */
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/**
+ The behavior when enqueueing into a full buffer.
+ Defaults to `GRKEventRingBufferOverflowPolicyDropNewest`
+ */
+@property (atomic, assign) GRKEventRingBufferOverflowPolicy overflowPolicy;
+
+/**
+ The maximum amount of time, in seconds, a producer will wait for room when the `overflowPolicy` is `GRKEventRingBufferOverflowPolicyBlock`.
+ Defaults to `0.1`
+ */
+@property (atomic, assign) NSTimeInterval blockTimeout;
+
+/**
+ Called with each object which is discarded from the buffer to make room under the `GRKEventRingBufferOverflowPolicyDropOldest` policy. This is called on the producer's thread.
+ Objects rejected by `enqueue:` are not passed to this handler; `enqueue:` returns `NO` for those instead.
+ */
+@property (atomic, copy, nullable) void (^discardHandler)(id object);
+
+/**
+ The number of times a producer found the buffer full.
+ */
+@property (nonatomic, readonly) uint64_t overflowCount;
+
+/**
+ The number of objects discarded due to the buffer being full, for any policy.
+ */
+@property (nonatomic, readonly) uint64_t droppedCount;
+
+/**
+ The position the next object enqueued will take. Objects take consecutive positions, from zero, in the order they are enqueued.
+ Objects enqueued before this is read (on any thread) have lower positions than objects enqueued after.
+ */
+@property (nonatomic, readonly) uint64_t nextPosition;
+
+/**
+ Create a new buffer.
+
+ @param capacity The minimum number of objects the buffer should hold. Must be greater than zero.
+ @return A new, empty, buffer.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Enqueue the given object, applying the `overflowPolicy` if the buffer is full.
+
+ @param object The object to enqueue.
+ @return `YES` if the object was enqueued, `NO` if it was discarded.
+ */
+- (BOOL)enqueue:(id)object;
+
+/**
+ Enqueue the given object, applying the given policy if the buffer is full.
+
+ @param object  The object to enqueue.
+ @param policy  The overflow policy to apply.
+ @param timeout The maximum amount of time, in seconds, to wait for room when `policy` is `GRKEventRingBufferOverflowPolicyBlock`. Pass `DBL_MAX` to wait indefinitely.
+ @return `YES` if the object was enqueued, `NO` if it was discarded.
+ */
+- (BOOL)enqueue:(id)object overflowPolicy:(GRKEventRingBufferOverflowPolicy)policy timeout:(NSTimeInterval)timeout;
+
+/**
+ Dequeue the oldest object in the buffer.
+
+ @return The oldest object, or `nil` if the buffer is empty.
+ */
+- (nullable id)dequeue;
+
+/**
+ Dequeue all objects currently in the buffer, calling the given block with each, in order.
+
+ @param block The block to call with each object.
+ @return The number of objects dequeued.
+ */
+- (NSUInteger)drain:(void (^)(id object))block;
+
+/**
+ Dequeue all objects currently in the buffer, calling the given block with each, and its position, in order.
+
+ @param block The block to call with each object.
+ @return The number of objects dequeued.
+ @see `nextPosition`
+ */
+- (NSUInteger)drainWithPositions:(void (^)(id object, uint64_t position))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,293 @@
+//
+//  GRKEventRingBuffer.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKEventRingBuffer.h"
+#import <stdatomic.h>
+#import <stdlib.h>
+
+// This is Dmitry Vyukov's bounded MPMC queue. Each cell carries a sequence number which tells producers and
+// consumers whether the cell is free for the lap they are on, so the only contended operation is a single
+// compare-and-swap on the head (consumers) or tail (producers) position.
+// See http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+// Although we only ever have one consumer, tolerating multiple consumers is what allows a producer to
+// discard the oldest object under `GRKEventRingBufferOverflowPolicyDropOldest`.
+
+#define GRK_CACHE_LINE_SIZE 64
+
+typedef struct {
+	atomic_size_t sequence;
+	void *object;
+} GRKRingCell;
+
+typedef struct {
+	_Alignas(GRK_CACHE_LINE_SIZE) atomic_size_t head;
+	_Alignas(GRK_CACHE_LINE_SIZE) atomic_size_t tail;
+	_Alignas(GRK_CACHE_LINE_SIZE) atomic_uint_least64_t overflowCount;
+	atomic_uint_least64_t droppedCount;
+	atomic_uint waitingProducers;
+} GRKRingPositions;
+
+@interface GRKEventRingBuffer ()
+{
+	GRKRingCell *_cells;
+	size_t _mask;
+	GRKRingPositions *_positions;
+	dispatch_semaphore_t _spaceSemaphore;
+}
+
+@end
+
+@implementation GRKEventRingBuffer
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+	NSParameterAssert(capacity > 0);
+
+	if ((self = [super init])) {
+		size_t size = 1;
+		while (size < MAX(capacity, (NSUInteger)2)) {
+			size <<= 1;
+		}
+		_capacity = size;
+		_mask = size - 1;
+
+		_cells = calloc(size, sizeof(GRKRingCell));
+		for (size_t i = 0; i < size; ++i) {
+			atomic_init(&_cells[i].sequence, i);
+		}
+
+		void *positions = NULL;
+		posix_memalign(&positions, GRK_CACHE_LINE_SIZE, sizeof(GRKRingPositions));
+		_positions = positions;
+		atomic_init(&_positions->head, 0);
+		atomic_init(&_positions->tail, 0);
+		atomic_init(&_positions->overflowCount, 0);
+		atomic_init(&_positions->droppedCount, 0);
+		atomic_init(&_positions->waitingProducers, 0);
+
+		_spaceSemaphore = dispatch_semaphore_create(0);
+		_overflowPolicy = GRKEventRingBufferOverflowPolicyDropNewest;
+		_blockTimeout = 0.1;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	void *object = NULL;
+	while ((object = [self dequeueUnretainedAtPosition:NULL])) {
+		CFRelease(object);
+	}
+	free(_cells);
+	free(_positions);
+}
+
+#pragma mark - Accessors
+
+- (uint64_t)overflowCount
+{
+	return atomic_load_explicit(&_positions->overflowCount, memory_order_relaxed);
+}
+
+- (uint64_t)droppedCount
+{
+	return atomic_load_explicit(&_positions->droppedCount, memory_order_relaxed);
+}
+
+- (uint64_t)nextPosition
+{
+	return atomic_load_explicit(&_positions->tail, memory_order_acquire);
+}
+
+#pragma mark - Producer
+
+- (BOOL)enqueue:(id)object
+{
+	return [self enqueue:object overflowPolicy:self.overflowPolicy timeout:self.blockTimeout];
+}
+
+- (BOOL)enqueue:(id)object overflowPolicy:(GRKEventRingBufferOverflowPolicy)policy timeout:(NSTimeInterval)timeout
+{
+	void *retained = (void *)CFBridgingRetain(object);
+
+	if ([self enqueueRetained:retained]) {
+		return YES;
+	}
+
+	atomic_fetch_add_explicit(&_positions->overflowCount, 1, memory_order_relaxed);
+
+	BOOL success = NO;
+	switch (policy) {
+		case GRKEventRingBufferOverflowPolicyDropNewest:
+			break;
+		case GRKEventRingBufferOverflowPolicyDropOldest:
+			success = [self enqueueRetainedDroppingOldest:retained];
+			break;
+		case GRKEventRingBufferOverflowPolicyBlock:
+			success = [self enqueueRetained:retained waitingUpTo:timeout];
+			break;
+	}
+
+	if (!success) {
+		atomic_fetch_add_explicit(&_positions->droppedCount, 1, memory_order_relaxed);
+		CFRelease(retained);
+	}
+
+	return success;
+}
+
+- (BOOL)enqueueRetained:(void *)object
+{
+	size_t position = atomic_load_explicit(&_positions->tail, memory_order_relaxed);
+	GRKRingCell *cell = NULL;
+
+	for (;;) {
+		cell = &_cells[position & _mask];
+		size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+		if (difference == 0) {
+			if (atomic_compare_exchange_weak_explicit(&_positions->tail, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if (difference < 0) {
+			// The cell still holds an object from the previous lap; the buffer is full.
+			return NO;
+		}
+		else {
+			position = atomic_load_explicit(&_positions->tail, memory_order_relaxed);
+		}
+	}
+
+	cell->object = object;
+	atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+
+	return YES;
+}
+
+- (BOOL)enqueueRetainedDroppingOldest:(void *)object
+{
+	while (![self enqueueRetained:object]) {
+		void *oldest = [self dequeueUnretainedAtPosition:NULL];
+		if (oldest) {
+			atomic_fetch_add_explicit(&_positions->droppedCount, 1, memory_order_relaxed);
+			id discarded = CFBridgingRelease(oldest);
+			void (^discardHandler)(id object) = self.discardHandler;
+			if (discardHandler) {
+				discardHandler(discarded);
+			}
+		}
+	}
+
+	return YES;
+}
+
+- (BOOL)enqueueRetained:(void *)object waitingUpTo:(NSTimeInterval)timeout
+{
+	dispatch_time_t deadline = timeout >= DBL_MAX ? DISPATCH_TIME_FOREVER : dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC));
+	BOOL success = NO;
+
+	atomic_fetch_add_explicit(&_positions->waitingProducers, 1, memory_order_acq_rel);
+	while (!(success = [self enqueueRetained:object])) {
+		if (dispatch_semaphore_wait(_spaceSemaphore, deadline) != 0) {
+			// One last attempt, in case room was made as we timed out.
+			success = [self enqueueRetained:object];
+			break;
+		}
+	}
+	atomic_fetch_sub_explicit(&_positions->waitingProducers, 1, memory_order_acq_rel);
+
+	return success;
+}
+
+#pragma mark - Consumer
+
+- (nullable id)dequeue
+{
+	void *object = [self dequeueUnretainedAtPosition:NULL];
+	if (object) {
+		[self signalWaitingProducers];
+	}
+
+	return CFBridgingRelease(object);
+}
+
+- (NSUInteger)drain:(void (^)(id object))block
+{
+	return [self drainWithPositions:^(id object, uint64_t position) {
+		block(object);
+	}];
+}
+
+- (NSUInteger)drainWithPositions:(void (^)(id object, uint64_t position))block
+{
+	NSUInteger count = 0;
+	void *object = NULL;
+	size_t position = 0;
+
+	while ((object = [self dequeueUnretainedAtPosition:&position])) {
+		++count;
+		[self signalWaitingProducers];
+		@autoreleasepool {
+			block(CFBridgingRelease(object), position);
+		}
+	}
+
+	return count;
+}
+
+- (nullable void *)dequeueUnretainedAtPosition:(nullable size_t *)outPosition
+{
+	size_t position = atomic_load_explicit(&_positions->head, memory_order_relaxed);
+	GRKRingCell *cell = NULL;
+
+	for (;;) {
+		cell = &_cells[position & _mask];
+		size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+		if (difference == 0) {
+			if (atomic_compare_exchange_weak_explicit(&_positions->head, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if (difference < 0) {
+			// The cell has not been written for this lap yet; the buffer is empty.
+			return NULL;
+		}
+		else {
+			position = atomic_load_explicit(&_positions->head, memory_order_relaxed);
+		}
+	}
+
+	void *object = cell->object;
+	cell->object = NULL;
+	atomic_store_explicit(&cell->sequence, position + _mask + 1, memory_order_release);
+	if (outPosition) {
+		*outPosition = position;
+	}
+
+	return object;
+}
+
+- (void)signalWaitingProducers
+{
+	if (atomic_load_explicit(&_positions->waitingProducers, memory_order_acquire) > 0) {
+		dispatch_semaphore_signal(_spaceSemaphore);
+	}
+}
+
+@end
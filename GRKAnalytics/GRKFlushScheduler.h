@@ -0,0 +1,154 @@
+//
+//  GRKFlushScheduler.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The outcome of a single flush step of a `GRKFlushable`.
+ */
+typedef NS_ENUM(NSInteger, GRKFlushStepResult) {
+	/// Hits were sent, and more may be waiting.
+	GRKFlushStepResultMore,
+	/// Nothing is left to send.
+	GRKFlushStepResultDone,
+	/// The step failed; the flushable is not asked again during this flush.
+	GRKFlushStepResultFailed,
+};
+
+/**
+ The reason a flush finished.
+ */
+typedef NS_ENUM(NSInteger, GRKFlushStatus) {
+	/// Every registered flushable reported it had nothing left to send (or failed).
+	GRKFlushStatusComplete,
+	/// The hit budget was used up.
+	GRKFlushStatusHitBudgetExhausted,
+	/// The time budget was used up.
+	GRKFlushStatusDeadlineReached,
+	/// The flush was cancelled through its cancellation token.
+	GRKFlushStatusCancelled,
+};
+
+/**
+ Anything which holds hits and can send them on request, one bounded step at a time.
+ */
+@protocol GRKFlushable <NSObject>
+
+/**
+ Send up to `hitLimit` pending hits.
+
+ @param hitLimit   The maximum number of hits to send in this step.
+ @param completion Must be called exactly once, on any queue, with the result of the step and the number of hits sent. Pass `NSNotFound` as the count when it is not known.
+ */
+- (void)flushWithHitLimit:(NSUInteger)hitLimit completion:(void (^)(GRKFlushStepResult result, NSUInteger flushedCount))completion;
+
+@optional
+
+/**
+ The number of hits waiting to be sent, or `NSNotFound` if it is not known.
+ */
+- (NSUInteger)pendingHitCount;
+
+@end
+
+/**
+ Cancels a flush in progress. A token may be shared between flushes.
+ */
+@interface GRKFlushCancellationToken : NSObject
+
+@property (atomic, readonly, getter=isCancelled) BOOL cancelled;
+
+- (void)cancel;
+
+@end
+
+/**
+ What a flush sent, and what it left behind.
+ */
+@interface GRKFlushResult : NSObject
+
+@property (nonatomic, readonly) GRKFlushStatus status;
+
+/**
+ The number of hits the flushables reported sending. Hits sent by flushables which could not count them are not included.
+ */
+@property (nonatomic, readonly) NSUInteger flushedCount;
+
+/**
+ The number of hits still waiting, or `NSNotFound` if any flushable could not say.
+ */
+@property (nonatomic, readonly) NSUInteger remainingCount;
+
+/**
+ The number of flushables which reported a failed step.
+ */
+@property (nonatomic, readonly) NSUInteger failedCount;
+
+@end
+
+/**
+ Flushes the hits of every registered `GRKFlushable` within a time budget and a hit budget.
+
+ Flushables are flushed in registration order, one step at a time, so a flush can stop between any two steps. A step which never completes is abandoned once the time budget is used up.
+ On iOS the shared scheduler flushes inside a background task when the app enters the background, and on macOS it flushes when the app is about to terminate. Elsewhere, flushes only happen when requested.
+
+ All methods are safe to call from any thread.
+ */
+@interface GRKFlushScheduler : NSObject
+
+/**
+ The scheduler providers register with.
+ */
++ (instancetype)sharedScheduler;
+
+/**
+ The time budget of flushes started by the app lifecycle, in seconds. On iOS it is further limited by the background time remaining. The default is 10 seconds.
+ */
+@property (atomic, assign) NSTimeInterval lifecycleTimeBudget;
+
+/**
+ The hit budget of flushes started by the app lifecycle. The default is `NSUIntegerMax`.
+ */
+@property (atomic, assign) NSUInteger lifecycleHitBudget;
+
+/**
+ Register a flushable. The scheduler does not retain it, and registering it again has no effect.
+
+ @param flushable The flushable to register.
+ */
+- (void)registerFlushable:(id<GRKFlushable>)flushable;
+
+/**
+ Unregister a flushable. A flush in progress may still complete a step it has already started.
+
+ @param flushable The flushable to unregister.
+ */
+- (void)unregisterFlushable:(id<GRKFlushable>)flushable;
+
+/**
+ Flush the registered flushables.
+
+ @param timeBudget        The time, in seconds, after which the flush stops.
+ @param hitBudget         The number of hits after which the flush stops.
+ @param cancellationToken An optional token to stop the flush early.
+ @param completion        Called once, on an arbitrary queue, when the flush finishes.
+ */
+- (void)flushWithTimeBudget:(NSTimeInterval)timeBudget hitBudget:(NSUInteger)hitBudget cancellationToken:(nullable GRKFlushCancellationToken *)cancellationToken completion:(nullable void (^)(GRKFlushResult *result))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
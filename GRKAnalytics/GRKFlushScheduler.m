@@ -0,0 +1,406 @@
+//
+//  GRKFlushScheduler.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKFlushScheduler.h"
+
+#if TARGET_OS_IPHONE
+#import <UIKit/UIKit.h>
+#elif TARGET_OS_MAC
+#import <AppKit/AppKit.h>
+#endif
+
+// Background time kept back from a lifecycle flush, so the background task can end before it expires.
+static NSTimeInterval const kGRKFlushSchedulerBackgroundTimeMargin = 1.0;
+// Time budgets of this many seconds or more are treated as unlimited (and do not fit a dispatch time anyway).
+static NSTimeInterval const kGRKFlushOperationMaximumTimerBudget = 60.0 * 60.0 * 24.0 * 365.0;
+
+#pragma mark - GRKFlushCancellationToken
+
+@interface GRKFlushCancellationToken ()
+
+@property (atomic, readwrite, getter=isCancelled) BOOL cancelled;
+@property (nonatomic, strong) NSMutableArray<dispatch_block_t> *handlers;
+
+// Calls the handler once the token is cancelled, immediately if it already is. Returns the handler to pass to
+// `-removeCancellationHandler:`.
+- (dispatch_block_t)addCancellationHandler:(dispatch_block_t)handler;
+
+// Forgets a handler added with `-addCancellationHandler:`, so a token which outlives its flush doesn't keep it.
+- (void)removeCancellationHandler:(dispatch_block_t)handler;
+
+@end
+
+@implementation GRKFlushCancellationToken
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		_handlers = [NSMutableArray array];
+	}
+
+	return self;
+}
+
+- (void)cancel
+{
+	NSArray<dispatch_block_t> *handlers = nil;
+
+	@synchronized (self) {
+		if (!self.cancelled) {
+			self.cancelled = YES;
+			handlers = [self.handlers copy];
+			[self.handlers removeAllObjects];
+		}
+	}
+
+	for (dispatch_block_t handler in handlers) {
+		handler();
+	}
+}
+
+- (dispatch_block_t)addCancellationHandler:(dispatch_block_t)handler
+{
+	BOOL cancelled = NO;
+	handler = [handler copy];
+
+	@synchronized (self) {
+		cancelled = self.cancelled;
+		if (!cancelled) {
+			[self.handlers addObject:handler];
+		}
+	}
+
+	if (cancelled) {
+		handler();
+	}
+
+	return handler;
+}
+
+- (void)removeCancellationHandler:(dispatch_block_t)handler
+{
+	@synchronized (self) {
+		[self.handlers removeObjectIdenticalTo:handler];
+	}
+}
+
+@end
+
+#pragma mark - GRKFlushResult
+
+@interface GRKFlushResult ()
+
+- (instancetype)initWithStatus:(GRKFlushStatus)status flushedCount:(NSUInteger)flushedCount remainingCount:(NSUInteger)remainingCount failedCount:(NSUInteger)failedCount;
+
+@end
+
+@implementation GRKFlushResult
+
+- (instancetype)initWithStatus:(GRKFlushStatus)status flushedCount:(NSUInteger)flushedCount remainingCount:(NSUInteger)remainingCount failedCount:(NSUInteger)failedCount
+{
+	if ((self = [super init])) {
+		_status = status;
+		_flushedCount = flushedCount;
+		_remainingCount = remainingCount;
+		_failedCount = failedCount;
+	}
+
+	return self;
+}
+
+- (NSString *)description
+{
+	return [NSString stringWithFormat:@"<%@: %p status: %ld flushed: %lu remaining: %ld failed: %lu>", NSStringFromClass(self.class), (void *)self, (long)self.status, (unsigned long)self.flushedCount, self.remainingCount == NSNotFound ? -1L : (long)self.remainingCount, (unsigned long)self.failedCount];
+}
+
+@end
+
+#pragma mark - GRKFlushOperation
+
+// The state of a single flush. Everything but `-startWithTimeBudget:` runs on `queue`.
+@interface GRKFlushOperation : NSObject
+
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, copy) NSArray<id<GRKFlushable>> *flushables;
+@property (nonatomic, assign) NSUInteger index;
+@property (nonatomic, assign) NSUInteger hitBudget;
+@property (nonatomic, assign) NSTimeInterval deadline;
+@property (nonatomic, strong, nullable) GRKFlushCancellationToken *cancellationToken;
+// The handler added to `cancellationToken`, removed once the flush finishes.
+@property (nonatomic, copy, nullable) dispatch_block_t cancellationHandler;
+@property (nonatomic, copy, nullable) void (^completion)(GRKFlushResult *result);
+@property (nonatomic, assign) NSUInteger flushedCount;
+@property (nonatomic, assign) NSUInteger failedCount;
+// Incremented with each step, so a late completion of an abandoned step can tell it is stale.
+@property (nonatomic, assign) NSUInteger step;
+@property (nonatomic, assign) BOOL finished;
+// The operation itself, until it finishes. Nothing else need hold a running flush, and the blocks it schedules only hold it weakly.
+@property (nonatomic, strong, nullable) GRKFlushOperation *running;
+
+- (void)startWithTimeBudget:(NSTimeInterval)timeBudget;
+
+@end
+
+@implementation GRKFlushOperation
+
+- (void)startWithTimeBudget:(NSTimeInterval)timeBudget
+{
+	timeBudget = MAX(timeBudget, 0);
+	self.deadline = [NSProcessInfo processInfo].systemUptime + timeBudget;
+
+	dispatch_async(self.queue, ^{
+		self.running = self;
+		// Neither the deadline nor the token's handler keep the operation alive once it has finished.
+		__weak typeof(self) weakSelf = self;
+		dispatch_queue_t queue = self.queue;
+		// A step which never completes must not hold the flush past its deadline.
+		if (timeBudget < kGRKFlushOperationMaximumTimerBudget) {
+			dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeBudget * NSEC_PER_SEC)), queue, ^{
+				[weakSelf finishWithStatus:GRKFlushStatusDeadlineReached];
+			});
+		}
+		self.cancellationHandler = [self.cancellationToken addCancellationHandler:^{
+			dispatch_async(queue, ^{
+				[weakSelf finishWithStatus:GRKFlushStatusCancelled];
+			});
+		}];
+		[self nextStep];
+	});
+}
+
+- (void)nextStep
+{
+	if (self.finished) {
+		return;
+	}
+
+	if (self.cancellationToken.isCancelled) {
+		[self finishWithStatus:GRKFlushStatusCancelled];
+	}
+	else if ([NSProcessInfo processInfo].systemUptime >= self.deadline) {
+		[self finishWithStatus:GRKFlushStatusDeadlineReached];
+	}
+	else if (self.flushedCount >= self.hitBudget) {
+		[self finishWithStatus:GRKFlushStatusHitBudgetExhausted];
+	}
+	else if (self.index >= self.flushables.count) {
+		[self finishWithStatus:GRKFlushStatusComplete];
+	}
+	else {
+		NSUInteger step = ++self.step;
+		[self.flushables[self.index] flushWithHitLimit:self.hitBudget - self.flushedCount completion:^(GRKFlushStepResult result, NSUInteger flushedCount) {
+			dispatch_async(self.queue, ^{
+				if (!self.finished && step == self.step) {
+					[self completeStepWithResult:result flushedCount:flushedCount];
+					[self nextStep];
+				}
+			});
+		}];
+	}
+}
+
+- (void)completeStepWithResult:(GRKFlushStepResult)result flushedCount:(NSUInteger)flushedCount
+{
+	if (flushedCount != NSNotFound) {
+		self.flushedCount += flushedCount;
+	}
+
+	switch (result) {
+		case GRKFlushStepResultMore:
+			break;
+		case GRKFlushStepResultFailed:
+			self.failedCount += 1;
+			self.index += 1;
+			break;
+		case GRKFlushStepResultDone:
+			self.index += 1;
+			break;
+	}
+}
+
+- (void)finishWithStatus:(GRKFlushStatus)status
+{
+	if (self.finished) {
+		return;
+	}
+	self.finished = YES;
+
+	NSUInteger remainingCount = 0;
+	for (id<GRKFlushable> flushable in self.flushables) {
+		NSUInteger pendingCount = [flushable respondsToSelector:@selector(pendingHitCount)] ? [flushable pendingHitCount] : NSNotFound;
+		if (pendingCount == NSNotFound) {
+			remainingCount = NSNotFound;
+			break;
+		}
+		remainingCount += pendingCount;
+	}
+
+	GRKFlushResult *result = [[GRKFlushResult alloc] initWithStatus:status flushedCount:self.flushedCount remainingCount:remainingCount failedCount:self.failedCount];
+	void (^completion)(GRKFlushResult *) = self.completion;
+	self.completion = nil;
+	self.flushables = @[];
+	if (self.cancellationHandler) {
+		[self.cancellationToken removeCancellationHandler:self.cancellationHandler];
+		self.cancellationHandler = nil;
+	}
+	self.cancellationToken = nil;
+
+	if (completion) {
+		completion(result);
+	}
+	self.running = nil;
+}
+
+@end
+
+#pragma mark - GRKFlushScheduler
+
+@interface GRKFlushScheduler ()
+
+@property (nonatomic, strong) NSPointerArray *flushables;
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+@end
+
+@implementation GRKFlushScheduler
+
+#pragma mark - Lifecycle
+
++ (instancetype)sharedScheduler
+{
+	static GRKFlushScheduler *sharedScheduler = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		sharedScheduler = [[GRKFlushScheduler alloc] init];
+		[sharedScheduler registerNotifications];
+	});
+
+	return sharedScheduler;
+}
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		_flushables = [NSPointerArray weakObjectsPointerArray];
+		_queue = dispatch_queue_create("com.levigroker.GRKAnalytics.GRKFlushScheduler", DISPATCH_QUEUE_SERIAL);
+		_lifecycleTimeBudget = 10.0;
+		_lifecycleHitBudget = NSUIntegerMax;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	[[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark - Registration
+
+- (void)registerFlushable:(id<GRKFlushable>)flushable
+{
+	@synchronized (self) {
+		[self.flushables compact];
+		for (id registered in self.flushables) {
+			if (registered == flushable) {
+				return;
+			}
+		}
+		[self.flushables addPointer:(__bridge void *)flushable];
+	}
+}
+
+- (void)unregisterFlushable:(id<GRKFlushable>)flushable
+{
+	@synchronized (self) {
+		for (NSUInteger index = 0; index < self.flushables.count; ++index) {
+			if ([self.flushables pointerAtIndex:index] == (__bridge void *)flushable) {
+				[self.flushables removePointerAtIndex:index];
+				break;
+			}
+		}
+	}
+}
+
+#pragma mark - Flushing
+
+- (void)flushWithTimeBudget:(NSTimeInterval)timeBudget hitBudget:(NSUInteger)hitBudget cancellationToken:(nullable GRKFlushCancellationToken *)cancellationToken completion:(nullable void (^)(GRKFlushResult *result))completion
+{
+	GRKFlushOperation *operation = [[GRKFlushOperation alloc] init];
+	operation.queue = self.queue;
+	operation.hitBudget = hitBudget;
+	operation.cancellationToken = cancellationToken;
+	operation.completion = completion;
+
+	@synchronized (self) {
+		NSMutableArray<id<GRKFlushable>> *flushables = [NSMutableArray arrayWithCapacity:self.flushables.count];
+		for (id<GRKFlushable> flushable in self.flushables) {
+			if (flushable) {
+				[flushables addObject:flushable];
+			}
+		}
+		operation.flushables = flushables;
+	}
+
+	[operation startWithTimeBudget:timeBudget];
+}
+
+#pragma mark - Notifications
+
+- (void)registerNotifications
+{
+#if TARGET_OS_IPHONE
+	[[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationDidEnterBackgroundNotification:) name:UIApplicationDidEnterBackgroundNotification object:nil];
+#elif TARGET_OS_MAC
+	[[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationWillTerminateNotification:) name:NSApplicationWillTerminateNotification object:nil];
+#endif
+}
+
+#if TARGET_OS_IPHONE
+
+- (void)applicationDidEnterBackgroundNotification:(NSNotification *)notification
+{
+	UIApplication *application = [UIApplication sharedApplication];
+	GRKFlushCancellationToken *cancellationToken = [[GRKFlushCancellationToken alloc] init];
+
+	__block UIBackgroundTaskIdentifier taskId = [application beginBackgroundTaskWithExpirationHandler:^{
+		[cancellationToken cancel];
+	}];
+
+	if (taskId == UIBackgroundTaskInvalid) {
+		return;
+	}
+
+	NSTimeInterval timeBudget = MIN(self.lifecycleTimeBudget, application.backgroundTimeRemaining - kGRKFlushSchedulerBackgroundTimeMargin);
+	[self flushWithTimeBudget:timeBudget hitBudget:self.lifecycleHitBudget cancellationToken:cancellationToken completion:^(GRKFlushResult *result) {
+		[application endBackgroundTask:taskId];
+	}];
+}
+
+#elif TARGET_OS_MAC
+
+- (void)applicationWillTerminateNotification:(NSNotification *)notification
+{
+	// The app quits as soon as this returns, so wait for the flush (which completes on the scheduler's queue, not this one).
+	NSTimeInterval timeBudget = self.lifecycleTimeBudget;
+	dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+	[self flushWithTimeBudget:timeBudget hitBudget:self.lifecycleHitBudget cancellationToken:nil completion:^(GRKFlushResult *result) {
+		dispatch_semaphore_signal(semaphore);
+	}];
+	dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)((timeBudget + kGRKFlushSchedulerBackgroundTimeMargin) * NSEC_PER_SEC)));
+}
+
+#endif //TARGET_OS_IPHONE
+
+@end
@@ -0,0 +1,50 @@
+//
+//  GRKLayeredDictionary.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ An immutable dictionary which presents the entries of a top dictionary over those of a base dictionary, without copying either.
+ Where both contain a key, the top dictionary's value is used.
+ */
+@interface GRKLayeredDictionary : NSDictionary
+
+/**
+ The dictionary whose entries are overridden by `top`.
+ */
+@property (nonatomic, readonly, copy) NSDictionary *base;
+
+/**
+ The dictionary whose entries take precedence.
+ */
+@property (nonatomic, readonly, copy) NSDictionary *top;
+
+/**
+ Returns a dictionary with the entries of `top` over those of `base`.
+ If either is empty the other is returned directly, rather than creating a layered dictionary.
+
+ @param top  The dictionary whose entries take precedence.
+ @param base The dictionary whose entries are overridden by `top`.
+ @return A dictionary with the entries of both.
+ */
++ (NSDictionary *)dictionaryWithTop:(nullable NSDictionary *)top base:(nullable NSDictionary *)base;
+
+- (instancetype)initWithTop:(NSDictionary *)top base:(NSDictionary *)base NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,133 @@
+//
+//  GRKLayeredDictionary.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKLayeredDictionary.h"
+
+// Enumerates the keys of the top dictionary, then the keys of the base dictionary which are not in the top.
+@interface GRKLayeredDictionaryKeyEnumerator : NSEnumerator
+
+- (instancetype)initWithTop:(NSDictionary *)top base:(NSDictionary *)base;
+
+@end
+
+@implementation GRKLayeredDictionaryKeyEnumerator
+{
+	NSDictionary *_top;
+	NSEnumerator *_topEnumerator;
+	NSEnumerator *_baseEnumerator;
+}
+
+- (instancetype)initWithTop:(NSDictionary *)top base:(NSDictionary *)base
+{
+	if ((self = [super init])) {
+		_top = top;
+		_topEnumerator = [top keyEnumerator];
+		_baseEnumerator = [base keyEnumerator];
+	}
+
+	return self;
+}
+
+- (nullable id)nextObject
+{
+	id key = [_topEnumerator nextObject];
+	if (!key) {
+		while ((key = [_baseEnumerator nextObject]) && _top[key]) {
+			// Skip keys overridden by the top dictionary.
+		}
+	}
+
+	return key;
+}
+
+@end
+
+@implementation GRKLayeredDictionary
+{
+	NSUInteger _count;
+}
+
+#pragma mark - Lifecycle
+
++ (NSDictionary *)dictionaryWithTop:(nullable NSDictionary *)top base:(nullable NSDictionary *)base
+{
+	if (top.count == 0) {
+		return [base copy] ?: @{};
+	}
+	if (base.count == 0) {
+		return [top copy];
+	}
+
+	return [[self alloc] initWithTop:top base:base];
+}
+
+- (instancetype)initWithTop:(NSDictionary *)top base:(NSDictionary *)base
+{
+	if ((self = [super init])) {
+		_top = [top copy];
+		_base = [base copy];
+
+		_count = _base.count;
+		for (id key in _top) {
+			if (!_base[key]) {
+				++_count;
+			}
+		}
+	}
+
+	return self;
+}
+
+- (instancetype)init
+{
+	return [self initWithTop:@{} base:@{}];
+}
+
+- (instancetype)initWithObjects:(const id _Nonnull [_Nullable])objects forKeys:(const id<NSCopying> _Nonnull [_Nullable])keys count:(NSUInteger)count
+{
+	return [self initWithTop:[NSDictionary dictionaryWithObjects:objects forKeys:keys count:count] base:@{}];
+}
+
+- (nullable instancetype)initWithCoder:(NSCoder *)coder
+{
+	NSDictionary *dictionary = [[NSDictionary alloc] initWithCoder:coder];
+	return dictionary ? [self initWithTop:dictionary base:@{}] : nil;
+}
+
+#pragma mark - NSDictionary
+
+- (NSUInteger)count
+{
+	return _count;
+}
+
+- (nullable id)objectForKey:(id)key
+{
+	return _top[key] ?: _base[key];
+}
+
+- (NSEnumerator *)keyEnumerator
+{
+	return [[GRKLayeredDictionaryKeyEnumerator alloc] initWithTop:_top base:_base];
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(nullable NSZone *)zone
+{
+	// Immutable
+	return self;
+}
+
+@end
@@ -0,0 +1,61 @@
+//
+//  GRKOverlayDictionary.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/**
+ The maximum number of overrides held inline by a `GRKOverlayDictionary`.
+ */
+extern NSUInteger const GRKOverlayDictionaryMaximumOverrides;
+
+/**
+ An immutable dictionary which presents a base dictionary with a handful of entries overridden, without copying the base.
+ Providers use it to add a key or two to the properties of an event.
+
+ An override with a `nil` object hides the key of the base dictionary. This matches assigning `nil` to a key of a mutable copy.
+
+ The base dictionary is held by reference, not copied, so a mutable base must not be mutated while the overlay is in use. Copying the overlay copies a mutable base, so a copy is a snapshot.
+ */
+@interface GRKOverlayDictionary : NSDictionary
+
+/**
+ Returns the base dictionary with a single entry overridden.
+
+ @param base   The dictionary to override. It is held by reference, so it must not be mutated afterwards.
+ @param object The object for the key, or `nil` to hide the key.
+ @param key    The key to override. If `nil`, the base dictionary is returned unaltered.
+ @return A dictionary with the override applied.
+ */
++ (NSDictionary *)dictionaryWithBase:(nullable NSDictionary *)base object:(nullable id)object forKey:(nullable id<NSCopying>)key;
+
+/**
+ Returns the base dictionary with the given entries overridden.
+ Where a key is given more than once, the last object given for it is used. Entries with a `nil` key are ignored.
+ If more than `GRKOverlayDictionaryMaximumOverrides` entries are given, a copy of the base dictionary is made instead.
+
+ @param base    The dictionary to override. It is held by reference, so it must not be mutated afterwards.
+ @param objects The objects for the keys. A `nil` object hides the key.
+ @param keys    The keys to override.
+ @param count   The number of entries in `objects` and `keys`.
+ @return A dictionary with the overrides applied.
+ */
++ (NSDictionary *)dictionaryWithBase:(nullable NSDictionary *)base objects:(const id _Nullable [_Nullable])objects forKeys:(const id _Nullable [_Nullable])keys count:(NSUInteger)count;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,216 @@
+//
+//  GRKOverlayDictionary.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKOverlayDictionary.h"
+
+
+enum { kGRKOverlayDictionaryInlineCapacity = 8 };
+
+NSUInteger const GRKOverlayDictionaryMaximumOverrides = kGRKOverlayDictionaryInlineCapacity;
+
+@interface GRKOverlayDictionary ()
+
+- (instancetype)initWithBase:(NSDictionary *)base objects:(const id _Nullable [_Nullable])objects forKeys:(const id _Nullable [_Nullable])keys count:(NSUInteger)count NS_DESIGNATED_INITIALIZER;
+
+- (NSUInteger)indexOfOverrideForKey:(id)key;
+
+@end
+
+// Enumerates the overriding keys which have objects, then the keys of the base dictionary which are not overridden.
+@interface GRKOverlayDictionaryKeyEnumerator : NSEnumerator
+
+- (instancetype)initWithDictionary:(GRKOverlayDictionary *)dictionary keys:(const id _Nullable [_Nonnull])keys objects:(const id _Nullable [_Nonnull])objects count:(NSUInteger)count base:(NSDictionary *)base;
+
+@end
+
+@implementation GRKOverlayDictionaryKeyEnumerator
+{
+	GRKOverlayDictionary *_dictionary;
+	id _keys[kGRKOverlayDictionaryInlineCapacity];
+	NSUInteger _count;
+	NSUInteger _index;
+	NSEnumerator *_baseEnumerator;
+}
+
+- (instancetype)initWithDictionary:(GRKOverlayDictionary *)dictionary keys:(const id _Nullable [_Nonnull])keys objects:(const id _Nullable [_Nonnull])objects count:(NSUInteger)count base:(NSDictionary *)base
+{
+	if ((self = [super init])) {
+		_dictionary = dictionary;
+		for (NSUInteger i = 0; i < count; ++i) {
+			if (objects[i]) {
+				_keys[_count++] = keys[i];
+			}
+		}
+		_baseEnumerator = [base keyEnumerator];
+	}
+
+	return self;
+}
+
+- (nullable id)nextObject
+{
+	if (_index < _count) {
+		return _keys[_index++];
+	}
+
+	id key;
+	while ((key = [_baseEnumerator nextObject]) && [_dictionary indexOfOverrideForKey:key] != NSNotFound) {
+		// Skip overridden keys.
+	}
+
+	return key;
+}
+
+@end
+
+@implementation GRKOverlayDictionary
+{
+	NSDictionary *_base;
+	id _keys[kGRKOverlayDictionaryInlineCapacity];
+	id _objects[kGRKOverlayDictionaryInlineCapacity];
+	NSUInteger _overrideCount;
+	NSUInteger _count;
+}
+
+#pragma mark - Lifecycle
+
++ (NSDictionary *)dictionaryWithBase:(nullable NSDictionary *)base object:(nullable id)object forKey:(nullable id<NSCopying>)key
+{
+	id objects[] = {object};
+	id keys[] = {key};
+	return [self dictionaryWithBase:base objects:objects forKeys:keys count:1];
+}
+
++ (NSDictionary *)dictionaryWithBase:(nullable NSDictionary *)base objects:(const id _Nullable [_Nullable])objects forKeys:(const id _Nullable [_Nullable])keys count:(NSUInteger)count
+{
+	base = base ?: @{};
+
+	if (count > GRKOverlayDictionaryMaximumOverrides) {
+		NSMutableDictionary *retVal = [base mutableCopy];
+		for (NSUInteger i = 0; i < count; ++i) {
+			if (keys[i]) {
+				retVal[keys[i]] = objects[i];
+			}
+		}
+		return retVal;
+	}
+
+	GRKOverlayDictionary *retVal = [[self alloc] initWithBase:base objects:objects forKeys:keys count:count];
+	return retVal->_overrideCount > 0 ? retVal : base;
+}
+
+- (instancetype)initWithBase:(NSDictionary *)base objects:(const id _Nullable [_Nullable])objects forKeys:(const id _Nullable [_Nullable])keys count:(NSUInteger)count
+{
+	if ((self = [super init])) {
+		// Held by reference: copying a mutable base, such as the properties made by a `GRKDeliveryPlan`, would cost as much as the overlay saves.
+		_base = base;
+		_count = _base.count;
+
+		for (NSUInteger i = 0; i < count && i < GRKOverlayDictionaryMaximumOverrides; ++i) {
+			id key = keys[i];
+			if (!key) {
+				continue;
+			}
+
+			id object = objects[i];
+			NSUInteger index = [self indexOfOverrideForKey:key];
+			if (index == NSNotFound) {
+				index = _overrideCount++;
+				_keys[index] = [key copy];
+				// Account for the key as it appears in the base dictionary, before this override.
+				if (_base[key]) {
+					--_count;
+				}
+			}
+			else if (_objects[index]) {
+				--_count;
+			}
+
+			_objects[index] = object;
+			if (object) {
+				++_count;
+			}
+		}
+	}
+
+	return self;
+}
+
+- (instancetype)init
+{
+	return [self initWithBase:@{} objects:NULL forKeys:NULL count:0];
+}
+
+- (instancetype)initWithObjects:(const id _Nonnull [_Nullable])objects forKeys:(const id<NSCopying> _Nonnull [_Nullable])keys count:(NSUInteger)count
+{
+	return [self initWithBase:[NSDictionary dictionaryWithObjects:objects forKeys:keys count:count] objects:NULL forKeys:NULL count:0];
+}
+
+- (nullable instancetype)initWithCoder:(NSCoder *)coder
+{
+	NSDictionary *dictionary = [[NSDictionary alloc] initWithCoder:coder];
+	return dictionary ? [self initWithBase:dictionary objects:NULL forKeys:NULL count:0] : nil;
+}
+
+#pragma mark - NSDictionary
+
+- (NSUInteger)count
+{
+	return _count;
+}
+
+- (nullable id)objectForKey:(id)key
+{
+	NSUInteger index = [self indexOfOverrideForKey:key];
+	return index == NSNotFound ? _base[key] : _objects[index];
+}
+
+- (NSEnumerator *)keyEnumerator
+{
+	return [[GRKOverlayDictionaryKeyEnumerator alloc] initWithDictionary:self keys:_keys objects:_objects count:_overrideCount base:_base];
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(nullable NSZone *)zone
+{
+	// Immutable, unless the base (held by reference) is mutable, in which case the copy overlays a snapshot of it.
+	NSDictionary *base = [_base copy];
+	if (base == _base) {
+		return self;
+	}
+
+	return [[GRKOverlayDictionary alloc] initWithBase:base objects:_objects forKeys:_keys count:_overrideCount];
+}
+
+#pragma mark - Helpers
+
+- (NSUInteger)indexOfOverrideForKey:(id)key
+{
+	// Identical keys (typically constant strings) are the common case, so check those before isEqual:.
+	for (NSUInteger i = 0; i < _overrideCount; ++i) {
+		if (_keys[i] == key) {
+			return i;
+		}
+	}
+	for (NSUInteger i = 0; i < _overrideCount; ++i) {
+		if ([_keys[i] isEqual:key]) {
+			return i;
+		}
+	}
+
+	return NSNotFound;
+}
+
+@end
@@ -0,0 +1,74 @@
+//
+//  GRKPropertyStore.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A versioned store of super properties.
+
+ Each change produces a new immutable version which shares the unchanged layers of the previous one, so changes never copy the whole store. Scoped layers (per-screen context, for example) can be pushed on top of the store and popped again in constant time.
+ The merged properties of a version are computed at most once, the first time they are needed, and then shared by every event tracked against that version.
+
+ All methods are safe to call from any thread.
+ */
+@interface GRKPropertyStore : NSObject
+
+/**
+ The merged properties of the current version.
+ */
+@property (nonatomic, readonly) GRK_GENERIC_NSDICTIONARY(NSString *, id) *currentProperties;
+
+/**
+ Add properties to the store, replacing the values of any existing keys.
+
+ @param properties The properties to add.
+ */
+- (void)addProperties:(GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
+
+/**
+ Remove properties from the store. This does not affect pushed layers.
+
+ @param keys The keys of the properties to remove.
+ */
+- (void)removePropertiesForKeys:(NSArray *)keys;
+
+/**
+ Push a layer of properties which take precedence over the properties of the store, and of previously pushed layers.
+
+ @param properties The properties of the layer.
+ @return An opaque token identifying the layer, to be passed to `popLayer:`.
+ */
+- (id)pushLayer:(GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
+
+/**
+ Pop a previously pushed layer, along with any layers pushed after it.
+
+ @param token The token returned by `pushLayer:`. If the layer has already been popped this has no effect.
+ */
+- (void)popLayer:(id)token;
+
+/**
+ Returns the given properties over the properties of the current version, without copying the current version.
+
+ @param properties The properties which take precedence.
+ @return A dictionary with the entries of both.
+ */
+- (GRK_GENERIC_NSDICTIONARY(NSString *, id) *)propertiesWithOverlay:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
+
+@end
+
+NS_ASSUME_NONNULL_END
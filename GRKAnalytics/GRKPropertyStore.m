@@ -0,0 +1,218 @@
+//
+//  GRKPropertyStore.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKPropertyStore.h"
+#import "GRKLayeredDictionary.h"
+
+// Once the chain of base layers is this deep, it is collapsed into a single layer, so merging stays cheap.
+static NSUInteger const kGRKPropertyStoreMaximumDepth = 16;
+
+#pragma mark - GRKPropertyLayer
+
+// An immutable layer of changes on top of a (shared) parent layer.
+@interface GRKPropertyLayer : NSObject
+
+@property (nonatomic, readonly, strong, nullable) GRKPropertyLayer *parent;
+@property (nonatomic, readonly, copy) NSDictionary *entries;
+@property (nonatomic, readonly, copy, nullable) NSArray *removedKeys;
+@property (nonatomic, readonly) NSUInteger depth;
+
+- (instancetype)initWithParent:(nullable GRKPropertyLayer *)parent entries:(nullable NSDictionary *)entries removedKeys:(nullable NSArray *)removedKeys;
+
+// Applies this layer, and all its ancestors (oldest first), to the given dictionary.
+- (void)applyToDictionary:(NSMutableDictionary *)dictionary;
+
+@end
+
+@implementation GRKPropertyLayer
+
+- (instancetype)initWithParent:(nullable GRKPropertyLayer *)parent entries:(nullable NSDictionary *)entries removedKeys:(nullable NSArray *)removedKeys
+{
+	if ((self = [super init])) {
+		_parent = parent;
+		_entries = [entries copy] ?: @{};
+		_removedKeys = [removedKeys copy];
+		_depth = parent.depth + 1;
+	}
+
+	return self;
+}
+
+- (void)applyToDictionary:(NSMutableDictionary *)dictionary
+{
+	NSMutableArray<GRKPropertyLayer *> *layers = [NSMutableArray arrayWithCapacity:self.depth];
+	for (GRKPropertyLayer *layer = self; layer; layer = layer.parent) {
+		[layers addObject:layer];
+	}
+
+	for (GRKPropertyLayer *layer in layers.reverseObjectEnumerator) {
+		if (layer.removedKeys) {
+			[dictionary removeObjectsForKeys:layer.removedKeys];
+		}
+		[dictionary addEntriesFromDictionary:layer.entries];
+	}
+}
+
+@end
+
+#pragma mark - GRKPropertyVersion
+
+// An immutable snapshot of the store: the base layers, plus the stack of pushed layers.
+@interface GRKPropertyVersion : NSObject
+
+@property (nonatomic, readonly, strong, nullable) GRKPropertyLayer *base;
+@property (nonatomic, readonly, strong, nullable) GRKPropertyLayer *scope;
+// The merged properties, computed on first use. Concurrent first uses may each compute them, harmlessly.
+@property (atomic, copy, nullable) NSDictionary *mergedProperties;
+
+- (instancetype)initWithBase:(nullable GRKPropertyLayer *)base scope:(nullable GRKPropertyLayer *)scope;
+
+- (NSDictionary *)properties;
+
+@end
+
+@implementation GRKPropertyVersion
+
+- (instancetype)initWithBase:(nullable GRKPropertyLayer *)base scope:(nullable GRKPropertyLayer *)scope
+{
+	if ((self = [super init])) {
+		_base = base;
+		_scope = scope;
+	}
+
+	return self;
+}
+
+- (NSDictionary *)properties
+{
+	NSDictionary *properties = self.mergedProperties;
+
+	if (!properties) {
+		if (!self.base && !self.scope) {
+			properties = @{};
+		}
+		else {
+			NSMutableDictionary *merged = [NSMutableDictionary dictionary];
+			[self.base applyToDictionary:merged];
+			[self.scope applyToDictionary:merged];
+			properties = [merged copy];
+		}
+		self.mergedProperties = properties;
+	}
+
+	return properties;
+}
+
+@end
+
+#pragma mark - GRKPropertyStore
+
+@interface GRKPropertyStore ()
+
+@property (atomic, strong) GRKPropertyVersion *currentVersion;
+
+@end
+
+@implementation GRKPropertyStore
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		_currentVersion = [[GRKPropertyVersion alloc] initWithBase:nil scope:nil];
+	}
+
+	return self;
+}
+
+#pragma mark - Accessors
+
+- (NSDictionary *)currentProperties
+{
+	return [self.currentVersion properties];
+}
+
+#pragma mark - Implementation
+
+- (void)addProperties:(NSDictionary *)properties
+{
+	if (properties.count > 0) {
+		@synchronized (self) {
+			GRKPropertyVersion *version = self.currentVersion;
+			GRKPropertyLayer *base = [[GRKPropertyLayer alloc] initWithParent:version.base entries:properties removedKeys:nil];
+			self.currentVersion = [[GRKPropertyVersion alloc] initWithBase:[self compactedLayer:base] scope:version.scope];
+		}
+	}
+}
+
+- (void)removePropertiesForKeys:(NSArray *)keys
+{
+	if (keys.count > 0) {
+		@synchronized (self) {
+			GRKPropertyVersion *version = self.currentVersion;
+			GRKPropertyLayer *base = [[GRKPropertyLayer alloc] initWithParent:version.base entries:nil removedKeys:keys];
+			self.currentVersion = [[GRKPropertyVersion alloc] initWithBase:[self compactedLayer:base] scope:version.scope];
+		}
+	}
+}
+
+- (id)pushLayer:(NSDictionary *)properties
+{
+	GRKPropertyLayer *scope = nil;
+
+	@synchronized (self) {
+		GRKPropertyVersion *version = self.currentVersion;
+		scope = [[GRKPropertyLayer alloc] initWithParent:version.scope entries:properties removedKeys:nil];
+		self.currentVersion = [[GRKPropertyVersion alloc] initWithBase:version.base scope:scope];
+	}
+
+	return scope;
+}
+
+- (void)popLayer:(id)token
+{
+	@synchronized (self) {
+		GRKPropertyVersion *version = self.currentVersion;
+		// The token is almost always the top layer, so this is typically a single step.
+		for (GRKPropertyLayer *scope = version.scope; scope; scope = scope.parent) {
+			if (scope == token) {
+				self.currentVersion = [[GRKPropertyVersion alloc] initWithBase:version.base scope:scope.parent];
+				break;
+			}
+		}
+	}
+}
+
+- (NSDictionary *)propertiesWithOverlay:(nullable NSDictionary *)properties
+{
+	return [GRKLayeredDictionary dictionaryWithTop:properties base:self.currentProperties];
+}
+
+#pragma mark - Helpers
+
+- (GRKPropertyLayer *)compactedLayer:(GRKPropertyLayer *)layer
+{
+	GRKPropertyLayer *retVal = layer;
+
+	if (layer.depth > kGRKPropertyStoreMaximumDepth) {
+		NSMutableDictionary *merged = [NSMutableDictionary dictionary];
+		[layer applyToDictionary:merged];
+		retVal = [[GRKPropertyLayer alloc] initWithParent:nil entries:merged removedKeys:nil];
+	}
+
+	return retVal;
+}
+
+@end
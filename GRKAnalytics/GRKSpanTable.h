@@ -0,0 +1,139 @@
+//
+//  GRKSpanTable.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+#import "GRKTimerTable.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Where a span sits in a trace. This is a plain value, so it can be captured by a block and carried to another thread.
+ */
+typedef struct {
+	/// The trace the span belongs to, or `0` outside of any trace.
+	uint64_t traceID;
+	/// The span itself.
+	uint64_t spanID;
+	/// The handle of the trace's root span, which gathers the trace's spans. Not part of the span's identity.
+	GRKTimerHandle root;
+	/// The handle of the span, so a context whose span has ended is recognised as such. `kGRKTimerHandleInvalid` for a span outside of this process.
+	GRKTimerHandle handle;
+} GRKSpanContext;
+
+/**
+ The context outside of any trace.
+ */
+extern GRKSpanContext const kGRKSpanContextNone;
+
+/**
+ A running span, as returned by `-[GRKSpanTable startSpanWithName:parent:]`.
+ */
+typedef struct {
+	/// Identifies the span's slot in its table.
+	GRKTimerHandle handle;
+	/// The span's place in its trace.
+	GRKSpanContext context;
+	/// The span's parent, or `0` if the span is the root of its trace.
+	uint64_t parentSpanID;
+	/// The handle of the span's parent, or `kGRKTimerHandleInvalid` if the span is the root of its trace.
+	GRKTimerHandle parentHandle;
+} GRKSpan;
+
+/**
+ A finished span, as passed to the handler of `-[GRKSpanTable endSpan:gatherTrace:handler:]`.
+ */
+typedef struct {
+	/// The name the span was started with. Only valid for the duration of the handler.
+	__unsafe_unretained NSString *name;
+	uint64_t traceID;
+	uint64_t spanID;
+	/// The span's parent, or `0` if the span is the root of its trace.
+	uint64_t parentSpanID;
+	/// When the span started, in `GRKMonotonicTimeNanoseconds`.
+	uint64_t start;
+	/// The nanoseconds the span ran for.
+	uint64_t duration;
+} GRKSpanRecord;
+
+/**
+ The calling thread's current span context: that of the innermost span started on this thread and not yet ended, or one set with `GRKSpanContextSetCurrent`.
+ */
+FOUNDATION_EXTERN GRKSpanContext GRKSpanContextGetCurrent(void);
+
+/**
+ Set the calling thread's current span context.
+ */
+FOUNDATION_EXTERN void GRKSpanContextSetCurrent(GRKSpanContext context);
+
+/**
+ Spans: timers which know their place in a trace.
+
+ Like `GRKTimerTable`, spans are held in a contiguous array of reusable slots, and identified by handles which pack a slot index with its generation. Starting or ending a span is a single clock read and a slot write.
+ The table is bounded in the same way: spans which are never ended are abandoned once they are older than `maximumAge`, or to make room beyond `maximumCount`, oldest first. An abandoned root's ended spans, kept for its trace, are abandoned with it.
+ All methods are thread safe.
+ */
+@interface GRKSpanTable : NSObject
+
+/**
+ The number of spans started and not yet reported.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ If this value is positive, spans running longer than this many seconds are abandoned, unreported. They are swept out periodically, and whenever a span is started.
+ Defaults to `0`, so spans never expire.
+ */
+@property (atomic, assign) NSTimeInterval maximumAge;
+
+/**
+ The maximum number of spans started and not yet reported, including ended spans kept for their trace. Starting a span beyond this abandons the oldest running span. Defaults to `1024`.
+ */
+@property (atomic, assign) NSUInteger maximumCount;
+
+/**
+ The number of spans abandoned, by age or to make room, since the table was created. This includes the ended spans abandoned with their root.
+ */
+@property (atomic, readonly) uint64_t abandonedCount;
+
+/**
+ Start a span.
+
+ @param name   The name of the span.
+ @param parent The context of the span's parent. If its `traceID` is `0`, or its span has ended, the span starts a new trace. A context left current on a thread after its span was ended elsewhere is therefore never adopted as a parent.
+ @return The new span.
+ */
+- (GRKSpan)startSpanWithName:(NSString *)name parent:(GRKSpanContext)parent;
+
+/**
+ End a span.
+
+ When gathering traces, a span whose trace's root is still running is kept until the root ends, and the handler is not called.
+ Ending a root calls the handler with the root and every span kept for its trace, in the order they started. Any other span is reported alone.
+
+ @param span        The span to end.
+ @param gatherTrace Whether to gather spans into their traces.
+ @param handler     Called, on the calling thread, with the records to report.
+ @return `YES` if the span was running. Ending a span twice, or a span whose handle is otherwise stale, does nothing.
+ */
+- (BOOL)endSpan:(GRKSpan)span gatherTrace:(BOOL)gatherTrace handler:(void (^)(const GRKSpanRecord *records, NSUInteger count))handler;
+
+/**
+ Abandon every span older than `maximumAge` now, rather than waiting for the next periodic sweep.
+ */
+- (void)sweep;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,441 @@
+//
+//  GRKSpanTable.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKSpanTable.h"
+#import <stdatomic.h>
+#import <stdlib.h>
+
+static NSUInteger const kGRKSpanTableInitialCapacity = 16;
+static NSUInteger const kGRKSpanTableDefaultMaximumCount = 1024;
+// The sweep runs this many times per `maximumAge`, so a span is abandoned at most a quarter of its maximum age late.
+static uint64_t const kGRKSpanTableSweepsPerMaximumAge = 4;
+// Marks the end of the free slot list, of the list of running spans, and of a trace's list of ended spans.
+static uint32_t const kGRKSpanTableNoSlot = UINT32_MAX;
+// The `nextFree` of a slot holding a span.
+static uint32_t const kGRKSpanTableSlotInUse = UINT32_MAX - 1;
+
+GRKSpanContext const kGRKSpanContextNone = {0, 0, 0, 0};
+
+static _Thread_local GRKSpanContext GRKSpanContextCurrent;
+
+GRKSpanContext GRKSpanContextGetCurrent(void)
+{
+	return GRKSpanContextCurrent;
+}
+
+void GRKSpanContextSetCurrent(GRKSpanContext context)
+{
+	GRKSpanContextCurrent = context;
+}
+
+// Trace and span IDs are drawn from a single counter, which starts at a random value so IDs from different runs are unlikely to collide.
+static uint64_t GRKSpanNextID(void)
+{
+	static atomic_uint_least64_t nextID;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		uint64_t seed = 0;
+		arc4random_buf(&seed, sizeof(seed));
+		atomic_init(&nextID, seed);
+	});
+
+	uint64_t retVal = 0;
+	while (retVal == 0) {
+		retVal = atomic_fetch_add_explicit(&nextID, 1, memory_order_relaxed);
+	}
+
+	return retVal;
+}
+
+typedef struct {
+	// The span's name, retained.
+	void *name;
+	uint64_t traceID;
+	uint64_t spanID;
+	uint64_t parentSpanID;
+	// In `GRKMonotonicTimeNanoseconds`. The end is `0` while the span runs.
+	uint64_t start;
+	uint64_t end;
+	// The next free slot, while this slot is free, otherwise `kGRKSpanTableSlotInUse`.
+	uint32_t nextFree;
+	// Advanced each time the slot is freed, so handles to earlier spans in this slot no longer match. Never zero.
+	uint32_t generation;
+	// In a root span, the first of the trace's ended spans. In an ended span, the next.
+	uint32_t nextEnded;
+	// Running spans are linked in the order they were started, oldest first.
+	uint32_t older;
+	uint32_t newer;
+} GRKSpanSlot;
+
+static inline GRKTimerHandle GRKSpanHandleMake(uint32_t slot, uint32_t generation)
+{
+	return ((uint64_t)generation << 32) | slot;
+}
+
+// Orders records by when they started, with the root first should a child start in the same nanosecond.
+static int GRKSpanRecordCompareStart(const void *first, const void *second)
+{
+	const GRKSpanRecord *firstRecord = first;
+	const GRKSpanRecord *secondRecord = second;
+	if (firstRecord->start != secondRecord->start) {
+		return firstRecord->start < secondRecord->start ? -1 : 1;
+	}
+
+	return (firstRecord->parentSpanID != 0) - (secondRecord->parentSpanID != 0);
+}
+
+@interface GRKSpanTable ()
+{
+	GRKSpanSlot *_slots;
+	uint32_t _capacity;
+	// The head of the list of free slots, threaded through `nextFree`.
+	uint32_t _firstFree;
+	// The ends of the list of running spans, threaded through `older` and `newer`.
+	uint32_t _oldest;
+	uint32_t _newest;
+	NSUInteger _count;
+	NSTimeInterval _maximumAge;
+	uint64_t _maximumAgeNanoseconds;
+	NSUInteger _maximumCount;
+	uint64_t _abandonedCount;
+}
+
+// Sweeps out spans older than `maximumAge`, while there is a maximum age. Guarded by `self`.
+@property (nonatomic, strong, nullable) dispatch_source_t sweepSource;
+
+@end
+
+@implementation GRKSpanTable
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		_firstFree = kGRKSpanTableNoSlot;
+		_oldest = kGRKSpanTableNoSlot;
+		_newest = kGRKSpanTableNoSlot;
+		_maximumCount = kGRKSpanTableDefaultMaximumCount;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_sweepSource) {
+		dispatch_source_cancel(_sweepSource);
+	}
+	for (uint32_t slot = 0; slot < _capacity; ++slot) {
+		if (_slots[slot].nextFree == kGRKSpanTableSlotInUse) {
+			CFRelease(_slots[slot].name);
+		}
+	}
+	free(_slots);
+}
+
+#pragma mark - Accessors
+
+- (NSUInteger)count
+{
+	@synchronized (self) {
+		return _count;
+	}
+}
+
+- (NSTimeInterval)maximumAge
+{
+	@synchronized (self) {
+		return _maximumAge;
+	}
+}
+
+- (void)setMaximumAge:(NSTimeInterval)maximumAge
+{
+	maximumAge = MAX(maximumAge, 0.0);
+
+	@synchronized (self) {
+		_maximumAge = maximumAge;
+		_maximumAgeNanoseconds = (uint64_t)(maximumAge * NSEC_PER_SEC);
+
+		if (self.sweepSource) {
+			dispatch_source_cancel(self.sweepSource);
+			self.sweepSource = nil;
+		}
+
+		if (_maximumAgeNanoseconds > 0) {
+			uint64_t interval = MAX(_maximumAgeNanoseconds / kGRKSpanTableSweepsPerMaximumAge, (uint64_t)NSEC_PER_MSEC);
+			dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+			dispatch_source_set_timer(source, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), interval, interval / 10);
+			__weak typeof(self) weakSelf = self;
+			dispatch_source_set_event_handler(source, ^{
+				[weakSelf sweep];
+			});
+			dispatch_resume(source);
+			self.sweepSource = source;
+		}
+	}
+
+	[self sweep];
+}
+
+- (NSUInteger)maximumCount
+{
+	@synchronized (self) {
+		return _maximumCount;
+	}
+}
+
+- (void)setMaximumCount:(NSUInteger)maximumCount
+{
+	@synchronized (self) {
+		_maximumCount = MAX(maximumCount, (NSUInteger)1);
+	}
+
+	[self sweep];
+}
+
+- (uint64_t)abandonedCount
+{
+	@synchronized (self) {
+		return _abandonedCount;
+	}
+}
+
+#pragma mark - Spans
+
+- (GRKSpan)startSpanWithName:(NSString *)name parent:(GRKSpanContext)parent
+{
+	GRKSpan span;
+	span.context.spanID = GRKSpanNextID();
+	void *retainedName = (void *)CFBridgingRetain([name copy]);
+
+	// Read the clock last, so setting up isn't counted.
+	uint64_t now = GRKMonotonicTimeNanoseconds();
+	BOOL joinsParent = NO;
+
+	@synchronized (self) {
+		// Abandon first, so an abandoned parent is not joined.
+		[self abandonSpansAt:now making:1];
+
+		// A parent from outside this process can't be checked, so is always joined.
+		joinsParent = parent.traceID != 0 && (parent.handle == kGRKTimerHandleInvalid || [self isRunningSpan:parent.handle]);
+		span.context.traceID = joinsParent ? parent.traceID : span.context.spanID;
+		span.parentSpanID = joinsParent ? parent.spanID : 0;
+		span.parentHandle = joinsParent ? parent.handle : kGRKTimerHandleInvalid;
+
+		uint32_t slot = [self allocateSlot];
+		GRKSpanSlot *spanSlot = &_slots[slot];
+		spanSlot->name = retainedName;
+		spanSlot->traceID = span.context.traceID;
+		spanSlot->spanID = span.context.spanID;
+		spanSlot->parentSpanID = span.parentSpanID;
+		spanSlot->start = now;
+		spanSlot->end = 0;
+		spanSlot->nextEnded = kGRKSpanTableNoSlot;
+		[self linkSlot:slot];
+		++_count;
+
+		span.handle = GRKSpanHandleMake(slot, spanSlot->generation);
+	}
+	span.context.handle = span.handle;
+	span.context.root = joinsParent ? parent.root : span.handle;
+
+	return span;
+}
+
+- (BOOL)endSpan:(GRKSpan)span gatherTrace:(BOOL)gatherTrace handler:(void (^)(const GRKSpanRecord *records, NSUInteger count))handler
+{
+	uint64_t now = GRKMonotonicTimeNanoseconds();
+	uint32_t slot = (uint32_t)span.handle;
+	BOOL isRoot = span.context.root == span.handle;
+
+	GRKSpanRecord *records = NULL;
+	NSUInteger recordCount = 0;
+
+	@synchronized (self) {
+		if (![self isRunningSpan:span.handle]) {
+			return NO;
+		}
+		_slots[slot].end = now;
+		[self unlinkSlot:slot];
+
+		if (gatherTrace && !isRoot && [self isRunningSpan:span.context.root]) {
+			// Kept until the root ends.
+			uint32_t root = (uint32_t)span.context.root;
+			_slots[slot].nextEnded = _slots[root].nextEnded;
+			_slots[root].nextEnded = slot;
+			return YES;
+		}
+
+		// A root reports its trace's ended spans, even if gathering has since been turned off.
+		NSUInteger capacity = 1;
+		if (isRoot) {
+			for (uint32_t ended = _slots[slot].nextEnded; ended != kGRKSpanTableNoSlot; ended = _slots[ended].nextEnded) {
+				++capacity;
+			}
+		}
+		records = malloc(capacity * sizeof(GRKSpanRecord));
+		if (!records) {
+			[NSException raise:NSMallocException format:@"Unable to report %lu spans.", (unsigned long)capacity];
+		}
+
+		// The names keep the retain of their slot until the records are released, below.
+		for (uint32_t ended = slot; ended != kGRKSpanTableNoSlot; ) {
+			GRKSpanSlot *spanSlot = &_slots[ended];
+			records[recordCount++] = (GRKSpanRecord){
+				.name = (__bridge NSString *)spanSlot->name,
+				.traceID = spanSlot->traceID,
+				.spanID = spanSlot->spanID,
+				.parentSpanID = spanSlot->parentSpanID,
+				.start = spanSlot->start,
+				.duration = spanSlot->end > spanSlot->start ? spanSlot->end - spanSlot->start : 0,
+			};
+			uint32_t next = spanSlot->nextEnded;
+			[self freeSlot:ended];
+			ended = next;
+		}
+		_count -= recordCount;
+	}
+
+	if (recordCount > 1) {
+		qsort(records, recordCount, sizeof(GRKSpanRecord), GRKSpanRecordCompareStart);
+	}
+	handler(records, recordCount);
+
+	for (NSUInteger index = 0; index < recordCount; ++index) {
+		CFRelease((__bridge CFTypeRef)records[index].name);
+	}
+	free(records);
+
+	return YES;
+}
+
+#pragma mark - Abandoning
+
+- (void)sweep
+{
+	uint64_t now = GRKMonotonicTimeNanoseconds();
+
+	@synchronized (self) {
+		[self abandonSpansAt:now making:0];
+	}
+}
+
+// Must be called while synchronized on self. Like `-[GRKTimerTable abandonTimersAt:making:]`, spans expire in the order they
+// were started, so only the oldest need ever be looked at. An abandoned root takes the ended spans gathered for its trace with it.
+- (void)abandonSpansAt:(uint64_t)now making:(NSUInteger)room
+{
+	while (_oldest != kGRKSpanTableNoSlot) {
+		uint32_t slot = _oldest;
+		BOOL expired = _maximumAgeNanoseconds > 0 && now > _slots[slot].start && now - _slots[slot].start >= _maximumAgeNanoseconds;
+		BOOL full = _count + room > _maximumCount;
+		if (!expired && !full) {
+			break;
+		}
+
+		[self unlinkSlot:slot];
+		for (uint32_t abandoned = slot; abandoned != kGRKSpanTableNoSlot; ) {
+			uint32_t next = _slots[abandoned].nextEnded;
+			CFRelease(_slots[abandoned].name);
+			[self freeSlot:abandoned];
+			--_count;
+			++_abandonedCount;
+			abandoned = next;
+		}
+	}
+}
+
+#pragma mark - Helpers
+
+// Must be called while synchronized on self.
+- (BOOL)isRunningSpan:(GRKTimerHandle)handle
+{
+	uint32_t slot = (uint32_t)handle;
+	uint32_t generation = (uint32_t)(handle >> 32);
+
+	return slot < _capacity && _slots[slot].nextFree == kGRKSpanTableSlotInUse && _slots[slot].generation == generation && _slots[slot].end == 0;
+}
+
+// Must be called while synchronized on self.
+- (uint32_t)allocateSlot
+{
+	if (_firstFree == kGRKSpanTableNoSlot) {
+		uint32_t capacity = _capacity > 0 ? _capacity * 2 : (uint32_t)kGRKSpanTableInitialCapacity;
+		GRKSpanSlot *slots = realloc(_slots, capacity * sizeof(GRKSpanSlot));
+		if (!slots) {
+			[NSException raise:NSMallocException format:@"Unable to grow the span table to %u spans.", capacity];
+		}
+		_slots = slots;
+		// Thread the new slots onto the free list, lowest index first.
+		for (uint32_t slot = capacity; slot > _capacity; --slot) {
+			_slots[slot - 1].nextFree = _firstFree;
+			_slots[slot - 1].generation = 1;
+			_firstFree = slot - 1;
+		}
+		_capacity = capacity;
+	}
+
+	uint32_t slot = _firstFree;
+	_firstFree = _slots[slot].nextFree;
+	_slots[slot].nextFree = kGRKSpanTableSlotInUse;
+
+	return slot;
+}
+
+// Must be called while synchronized on self. Adds a newly started span to the list of running spans.
+- (void)linkSlot:(uint32_t)slot
+{
+	_slots[slot].older = _newest;
+	_slots[slot].newer = kGRKSpanTableNoSlot;
+	if (_newest != kGRKSpanTableNoSlot) {
+		_slots[_newest].newer = slot;
+	}
+	else {
+		_oldest = slot;
+	}
+	_newest = slot;
+}
+
+// Must be called while synchronized on self.
+- (void)unlinkSlot:(uint32_t)slot
+{
+	uint32_t older = _slots[slot].older;
+	uint32_t newer = _slots[slot].newer;
+
+	if (older != kGRKSpanTableNoSlot) {
+		_slots[older].newer = newer;
+	}
+	else {
+		_oldest = newer;
+	}
+
+	if (newer != kGRKSpanTableNoSlot) {
+		_slots[newer].older = older;
+	}
+	else {
+		_newest = older;
+	}
+}
+
+// Must be called while synchronized on self. The slot's name is not released.
+- (void)freeSlot:(uint32_t)slot
+{
+	_slots[slot].name = NULL;
+	_slots[slot].generation = _slots[slot].generation == UINT32_MAX ? 1 : _slots[slot].generation + 1;
+	_slots[slot].nextFree = _firstFree;
+	_firstFree = slot;
+}
+
+@end
@@ -0,0 +1,147 @@
+//
+//  GRKTimerTable.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The current time, in nanoseconds, on a clock which only moves forward. Unlike `NSDate`, it is not moved by network time updates or changes to the system clock.
+ The clock keeps counting while the device sleeps, where the system allows (iOS 10 and macOS 10.12 onward).
+ */
+FOUNDATION_EXTERN uint64_t GRKMonotonicTimeNanoseconds(void);
+
+/**
+ Identifies a single timer started by `-[GRKTimerTable startTimer]`. The low 32 bits are the timer's slot, and the high 32 bits the slot's generation, so a handle is no longer valid once its timer has stopped, even after the slot is reused.
+ */
+typedef uint64_t GRKTimerHandle;
+
+/**
+ A handle which never identifies a timer.
+ */
+static GRKTimerHandle const kGRKTimerHandleInvalid = 0;
+
+/**
+ How a timer counts time.
+ */
+typedef NS_ENUM(NSInteger, GRKTimerMode) {
+	/// The timer counts all time, including while the app is suspended.
+	GRKTimerModeContinuous = 0,
+	/// The timer does not count time while its table is paused, typically while the app is in the background.
+	GRKTimerModePausesWhileSuspended,
+};
+
+/**
+ Timers which record their start as a raw `GRKMonotonicTimeNanoseconds` value. Timers are either identified by a `GRKTimerHandle`, so any number may run at once, or keyed by event name.
+
+ Start times are held in a single contiguous array of slots, and slots freed by stopped timers are reused, so starting a timer allocates nothing once the table has grown to its working size.
+ The table is bounded: timers which are never stopped are abandoned once they are older than `maximumAge`, or to make room beyond `maximumCount`, oldest first.
+ All methods are thread safe.
+ */
+@interface GRKTimerTable : NSObject
+
+/**
+ The number of running timers.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ The mode of timers started from now on. Running timers keep the mode they were started with.
+ Defaults to `GRKTimerModeContinuous`.
+ */
+@property (atomic, assign) GRKTimerMode mode;
+
+/**
+ Whether timers in `GRKTimerModePausesWhileSuspended` are paused.
+ */
+@property (nonatomic, readonly, getter=isPaused) BOOL paused;
+
+/**
+ If this value is positive, timers running longer than this many seconds are abandoned. They are swept out periodically, and whenever a timer is started.
+ Defaults to `0`, so timers never expire.
+ */
+@property (atomic, assign) NSTimeInterval maximumAge;
+
+/**
+ The maximum number of running timers. Starting a timer beyond this abandons the oldest running timer. Defaults to `1024`.
+ */
+@property (atomic, assign) NSUInteger maximumCount;
+
+/**
+ The number of timers abandoned, by age or to make room, since the table was created.
+ */
+@property (atomic, readonly) uint64_t abandonedCount;
+
+/**
+ Called, outside the table's lock, on the thread which abandoned the timers, with each abandoned timer: the key of a timer started by key, or `nil` for a timer started by handle, and the nanoseconds it ran.
+ */
+@property (atomic, copy, nullable) void (^abandonHandler)(NSString * _Nullable key, uint64_t elapsed);
+
+/**
+ Start a timer for the given key, restarting it if it is already running.
+
+ @param key The key of the timer, typically an event name.
+ */
+- (void)startTimerForKey:(NSString *)key;
+
+/**
+ Start a timer which is independent of every other timer. Starting and stopping a timer by handle is constant time, and involves no hashing.
+
+ @return The handle of the new timer.
+ */
+- (GRKTimerHandle)startTimer;
+
+/**
+ Stop the timer with the given handle.
+
+ @param handle  The handle of the timer to stop.
+ @param elapsed On return, the nanoseconds since the timer was started. Untouched if the handle does not identify a running timer.
+ @return `YES` if the handle identified a running timer.
+ */
+- (BOOL)stopTimer:(GRKTimerHandle)handle elapsedNanoseconds:(uint64_t *)elapsed;
+
+/**
+ Stop the timer for the given key.
+
+ @param key     The key of the timer to stop.
+ @param elapsed On return, the nanoseconds since the timer was started. Untouched if no timer was running.
+ @return `YES` if a timer was running for the key.
+ */
+- (BOOL)stopTimerForKey:(NSString *)key elapsedNanoseconds:(uint64_t *)elapsed;
+
+/**
+ Pause every timer in `GRKTimerModePausesWhileSuspended`. This takes constant time, however many timers are running: those timers all read a clock which stands still while the table is paused.
+ Pausing a paused table does nothing.
+ */
+- (void)pause;
+
+/**
+ Resume the timers paused by `pause`. Resuming a table which isn't paused does nothing.
+ */
+- (void)resume;
+
+/**
+ Abandon every timer older than `maximumAge` now, rather than waiting for the next periodic sweep.
+ */
+- (void)sweep;
+
+/**
+ Stop every running timer, without reporting them. Outstanding handles are no longer valid.
+ */
+- (void)removeAllTimers;
+
+@end
+
+NS_ASSUME_NONNULL_END
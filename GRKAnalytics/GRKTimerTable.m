@@ -0,0 +1,501 @@
+//
+//  GRKTimerTable.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKTimerTable.h"
+#import <mach/mach_time.h>
+#import <stdlib.h>
+#import <time.h>
+
+static NSUInteger const kGRKTimerTableInitialCapacity = 16;
+static NSUInteger const kGRKTimerTableDefaultMaximumCount = 1024;
+// The sweep runs this many times per `maximumAge`, so a timer is abandoned at most a quarter of its maximum age late.
+static uint64_t const kGRKTimerTableSweepsPerMaximumAge = 4;
+// Marks the end of the free slot list, and of the list of running timers.
+static uint32_t const kGRKTimerTableNoSlot = UINT32_MAX;
+// The `nextFree` of a slot holding a running timer.
+static uint32_t const kGRKTimerTableSlotInUse = UINT32_MAX - 1;
+
+uint64_t GRKMonotonicTimeNanoseconds(void)
+{
+	if (@available(iOS 10.0, macOS 10.12, tvOS 10.0, watchOS 3.0, *)) {
+		return clock_gettime_nsec_np(CLOCK_MONOTONIC);
+	}
+
+	// Before `CLOCK_MONOTONIC` was available, mach absolute time (which pauses while the device sleeps) is the best there is.
+	static mach_timebase_info_data_t timebase;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		mach_timebase_info(&timebase);
+	});
+
+	uint64_t ticks = mach_absolute_time();
+	if (timebase.numer == timebase.denom) {
+		return ticks;
+	}
+	// Split the conversion so `ticks * numer` can't overflow.
+	return (ticks / timebase.denom) * timebase.numer + (ticks % timebase.denom) * timebase.numer / timebase.denom;
+}
+
+typedef struct {
+	// When the timer was started, in `GRKMonotonicTimeNanoseconds`, or on the pausing clock if `pausing`.
+	uint64_t start;
+	// When the timer was started, in `GRKMonotonicTimeNanoseconds`, for measuring its age.
+	uint64_t startedAt;
+	// The key of a timer started by key, retained, otherwise `NULL`.
+	void *key;
+	// The next free slot, while this slot is free, otherwise `kGRKTimerTableSlotInUse`.
+	uint32_t nextFree;
+	// Advanced each time the slot is freed, so handles to earlier timers in this slot no longer match. Never zero.
+	uint32_t generation;
+	// Running timers are linked in the order they were (re)started, oldest first.
+	uint32_t older;
+	uint32_t newer;
+	// Whether `start` is on the clock which stands still while the table is paused.
+	BOOL pausing;
+} GRKTimerSlot;
+
+static inline GRKTimerHandle GRKTimerHandleMake(uint32_t slot, uint32_t generation)
+{
+	return ((uint64_t)generation << 32) | slot;
+}
+
+// A timer which was abandoned, to be reported once the table is unlocked.
+@interface GRKAbandonedTimer : NSObject
+
+@property (nonatomic, copy, nullable) NSString *key;
+@property (nonatomic, assign) uint64_t elapsed;
+
+@end
+
+@implementation GRKAbandonedTimer
+
+@end
+
+@interface GRKTimerTable ()
+{
+	GRKTimerSlot *_slots;
+	uint32_t _capacity;
+	// The head of the list of free slots, threaded through `nextFree`.
+	uint32_t _firstFree;
+	// The ends of the list of running timers, threaded through `older` and `newer`.
+	uint32_t _oldest;
+	uint32_t _newest;
+	// The number of running timers started by handle.
+	NSUInteger _handleCount;
+	// The clock of pausing timers is the monotonic clock less the time spent paused. While paused it reads as of `_pauseStart`.
+	uint64_t _pausedDuration;
+	uint64_t _pauseStart;
+	BOOL _paused;
+	NSTimeInterval _maximumAge;
+	uint64_t _maximumAgeNanoseconds;
+	NSUInteger _maximumCount;
+	uint64_t _abandonedCount;
+}
+
+// Key -> slot index, for timers started by key. Small indexes are tagged pointers, so looking up or adding a key doesn't allocate a number.
+@property (nonatomic, strong) GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, NSNumber *) *slotIndexes;
+// Sweeps out timers older than `maximumAge`, while there is a maximum age. Guarded by `self`.
+@property (nonatomic, strong, nullable) dispatch_source_t sweepSource;
+
+@end
+
+@implementation GRKTimerTable
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		_slotIndexes = [NSMutableDictionary dictionaryWithCapacity:kGRKTimerTableInitialCapacity];
+		_firstFree = kGRKTimerTableNoSlot;
+		_oldest = kGRKTimerTableNoSlot;
+		_newest = kGRKTimerTableNoSlot;
+		_maximumCount = kGRKTimerTableDefaultMaximumCount;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_sweepSource) {
+		dispatch_source_cancel(_sweepSource);
+	}
+	for (uint32_t slot = _oldest; slot != kGRKTimerTableNoSlot; slot = _slots[slot].newer) {
+		if (_slots[slot].key) {
+			CFRelease(_slots[slot].key);
+		}
+	}
+	free(_slots);
+}
+
+#pragma mark - Accessors
+
+- (NSUInteger)count
+{
+	@synchronized (self) {
+		return self.slotIndexes.count + _handleCount;
+	}
+}
+
+- (BOOL)isPaused
+{
+	@synchronized (self) {
+		return _paused;
+	}
+}
+
+- (NSTimeInterval)maximumAge
+{
+	@synchronized (self) {
+		return _maximumAge;
+	}
+}
+
+- (void)setMaximumAge:(NSTimeInterval)maximumAge
+{
+	maximumAge = MAX(maximumAge, 0.0);
+
+	@synchronized (self) {
+		_maximumAge = maximumAge;
+		_maximumAgeNanoseconds = (uint64_t)(maximumAge * NSEC_PER_SEC);
+
+		if (self.sweepSource) {
+			dispatch_source_cancel(self.sweepSource);
+			self.sweepSource = nil;
+		}
+
+		if (_maximumAgeNanoseconds > 0) {
+			uint64_t interval = MAX(_maximumAgeNanoseconds / kGRKTimerTableSweepsPerMaximumAge, (uint64_t)NSEC_PER_MSEC);
+			dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+			dispatch_source_set_timer(source, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), interval, interval / 10);
+			__weak typeof(self) weakSelf = self;
+			dispatch_source_set_event_handler(source, ^{
+				[weakSelf sweep];
+			});
+			dispatch_resume(source);
+			self.sweepSource = source;
+		}
+	}
+
+	[self sweep];
+}
+
+- (NSUInteger)maximumCount
+{
+	@synchronized (self) {
+		return _maximumCount;
+	}
+}
+
+- (void)setMaximumCount:(NSUInteger)maximumCount
+{
+	@synchronized (self) {
+		_maximumCount = MAX(maximumCount, (NSUInteger)1);
+	}
+
+	[self sweep];
+}
+
+- (uint64_t)abandonedCount
+{
+	@synchronized (self) {
+		return _abandonedCount;
+	}
+}
+
+#pragma mark - Pausing
+
+- (void)pause
+{
+	uint64_t now = GRKMonotonicTimeNanoseconds();
+
+	@synchronized (self) {
+		if (!_paused) {
+			_pauseStart = now;
+			_paused = YES;
+		}
+	}
+}
+
+- (void)resume
+{
+	uint64_t now = GRKMonotonicTimeNanoseconds();
+
+	@synchronized (self) {
+		if (_paused) {
+			_pausedDuration += now > _pauseStart ? now - _pauseStart : 0;
+			_paused = NO;
+		}
+	}
+}
+
+#pragma mark - Timers
+
+- (void)startTimerForKey:(NSString *)key
+{
+	// Read the clock first, so waiting on the lock isn't counted.
+	uint64_t now = GRKMonotonicTimeNanoseconds();
+	NSArray<GRKAbandonedTimer *> *abandoned = nil;
+
+	@synchronized (self) {
+		abandoned = [self abandonTimersAt:now making:self.slotIndexes[key] ? 0 : 1];
+
+		NSNumber *index = self.slotIndexes[key];
+		uint32_t slot = 0;
+		if (index) {
+			slot = index.unsignedIntValue;
+			[self unlinkSlot:slot];
+		}
+		else {
+			key = [key copy];
+			slot = [self allocateSlot];
+			_slots[slot].key = (void *)CFBridgingRetain(key);
+			self.slotIndexes[key] = @(slot);
+		}
+		[self startSlot:slot at:now];
+	}
+
+	[self reportAbandonedTimers:abandoned];
+}
+
+- (GRKTimerHandle)startTimer
+{
+	uint64_t now = GRKMonotonicTimeNanoseconds();
+	NSArray<GRKAbandonedTimer *> *abandoned = nil;
+	GRKTimerHandle handle = kGRKTimerHandleInvalid;
+
+	@synchronized (self) {
+		abandoned = [self abandonTimersAt:now making:1];
+
+		uint32_t slot = [self allocateSlot];
+		_slots[slot].key = NULL;
+		[self startSlot:slot at:now];
+		++_handleCount;
+
+		handle = GRKTimerHandleMake(slot, _slots[slot].generation);
+	}
+
+	[self reportAbandonedTimers:abandoned];
+
+	return handle;
+}
+
+- (BOOL)stopTimer:(GRKTimerHandle)handle elapsedNanoseconds:(uint64_t *)elapsed
+{
+	uint64_t now = GRKMonotonicTimeNanoseconds();
+	uint32_t slot = (uint32_t)handle;
+	uint32_t generation = (uint32_t)(handle >> 32);
+
+	@synchronized (self) {
+		if (slot >= _capacity || _slots[slot].nextFree != kGRKTimerTableSlotInUse || _slots[slot].generation != generation || _slots[slot].key) {
+			return NO;
+		}
+
+		if (elapsed) {
+			*elapsed = [self elapsedForSlot:slot at:now];
+		}
+		[self removeSlot:slot];
+	}
+
+	return YES;
+}
+
+- (BOOL)stopTimerForKey:(NSString *)key elapsedNanoseconds:(uint64_t *)elapsed
+{
+	uint64_t now = GRKMonotonicTimeNanoseconds();
+
+	@synchronized (self) {
+		NSNumber *index = self.slotIndexes[key];
+		if (!index) {
+			return NO;
+		}
+
+		uint32_t slot = index.unsignedIntValue;
+		if (elapsed) {
+			*elapsed = [self elapsedForSlot:slot at:now];
+		}
+		[self removeSlot:slot];
+	}
+
+	return YES;
+}
+
+- (void)removeAllTimers
+{
+	@synchronized (self) {
+		while (_oldest != kGRKTimerTableNoSlot) {
+			[self removeSlot:_oldest];
+		}
+	}
+}
+
+#pragma mark - Abandoning
+
+- (void)sweep
+{
+	uint64_t now = GRKMonotonicTimeNanoseconds();
+	NSArray<GRKAbandonedTimer *> *abandoned = nil;
+
+	@synchronized (self) {
+		abandoned = [self abandonTimersAt:now making:0];
+	}
+
+	[self reportAbandonedTimers:abandoned];
+}
+
+// Must be called while synchronized on self. Every timer shares the same maximum age, so timers expire in the order they were
+// started: only the oldest need ever be looked at, and each expired timer costs constant time.
+- (nullable NSArray<GRKAbandonedTimer *> *)abandonTimersAt:(uint64_t)now making:(NSUInteger)room
+{
+	NSMutableArray<GRKAbandonedTimer *> *retVal = nil;
+
+	while (_oldest != kGRKTimerTableNoSlot) {
+		uint32_t slot = _oldest;
+		BOOL expired = _maximumAgeNanoseconds > 0 && now > _slots[slot].startedAt && now - _slots[slot].startedAt >= _maximumAgeNanoseconds;
+		BOOL full = self.slotIndexes.count + _handleCount + room > _maximumCount;
+		if (!expired && !full) {
+			break;
+		}
+
+		GRKAbandonedTimer *timer = [[GRKAbandonedTimer alloc] init];
+		timer.key = (__bridge NSString *)_slots[slot].key;
+		timer.elapsed = [self elapsedForSlot:slot at:now];
+		if (!retVal) {
+			retVal = [NSMutableArray array];
+		}
+		[retVal addObject:timer];
+
+		[self removeSlot:slot];
+		++_abandonedCount;
+	}
+
+	return retVal;
+}
+
+- (void)reportAbandonedTimers:(nullable NSArray<GRKAbandonedTimer *> *)abandoned
+{
+	if (abandoned.count > 0) {
+		void (^abandonHandler)(NSString * _Nullable key, uint64_t elapsed) = self.abandonHandler;
+		if (abandonHandler) {
+			for (GRKAbandonedTimer *timer in abandoned) {
+				abandonHandler(timer.key, timer.elapsed);
+			}
+		}
+	}
+}
+
+#pragma mark - Helpers
+
+// Must be called while synchronized on self.
+- (uint64_t)pausingTimeAt:(uint64_t)now
+{
+	return (_paused ? _pauseStart : now) - _pausedDuration;
+}
+
+// Must be called while synchronized on self. The slot must not be linked.
+- (void)startSlot:(uint32_t)slot at:(uint64_t)now
+{
+	BOOL pausing = self.mode == GRKTimerModePausesWhileSuspended;
+	_slots[slot].pausing = pausing;
+	_slots[slot].start = pausing ? [self pausingTimeAt:now] : now;
+	_slots[slot].startedAt = now;
+
+	_slots[slot].older = _newest;
+	_slots[slot].newer = kGRKTimerTableNoSlot;
+	if (_newest != kGRKTimerTableNoSlot) {
+		_slots[_newest].newer = slot;
+	}
+	else {
+		_oldest = slot;
+	}
+	_newest = slot;
+}
+
+// Must be called while synchronized on self.
+- (void)unlinkSlot:(uint32_t)slot
+{
+	uint32_t older = _slots[slot].older;
+	uint32_t newer = _slots[slot].newer;
+
+	if (older != kGRKTimerTableNoSlot) {
+		_slots[older].newer = newer;
+	}
+	else {
+		_oldest = newer;
+	}
+
+	if (newer != kGRKTimerTableNoSlot) {
+		_slots[newer].older = older;
+	}
+	else {
+		_newest = older;
+	}
+}
+
+// Must be called while synchronized on self.
+- (uint64_t)elapsedForSlot:(uint32_t)slot at:(uint64_t)now
+{
+	uint64_t end = _slots[slot].pausing ? [self pausingTimeAt:now] : now;
+	uint64_t start = _slots[slot].start;
+
+	return end > start ? end - start : 0;
+}
+
+// Must be called while synchronized on self.
+- (uint32_t)allocateSlot
+{
+	if (_firstFree == kGRKTimerTableNoSlot) {
+		uint32_t capacity = _capacity > 0 ? _capacity * 2 : (uint32_t)kGRKTimerTableInitialCapacity;
+		GRKTimerSlot *slots = realloc(_slots, capacity * sizeof(GRKTimerSlot));
+		if (!slots) {
+			[NSException raise:NSMallocException format:@"Unable to grow the timer table to %u timers.", capacity];
+		}
+		_slots = slots;
+		// Thread the new slots onto the free list, lowest index first.
+		for (uint32_t slot = capacity; slot > _capacity; --slot) {
+			_slots[slot - 1].nextFree = _firstFree;
+			_slots[slot - 1].generation = 1;
+			_firstFree = slot - 1;
+		}
+		_capacity = capacity;
+	}
+
+	uint32_t slot = _firstFree;
+	_firstFree = _slots[slot].nextFree;
+	_slots[slot].nextFree = kGRKTimerTableSlotInUse;
+
+	return slot;
+}
+
+// Must be called while synchronized on self. Stops the timer in the slot, and frees the slot.
+- (void)removeSlot:(uint32_t)slot
+{
+	[self unlinkSlot:slot];
+
+	if (_slots[slot].key) {
+		NSString *key = CFBridgingRelease(_slots[slot].key);
+		_slots[slot].key = NULL;
+		[self.slotIndexes removeObjectForKey:key];
+	}
+	else {
+		--_handleCount;
+	}
+
+	_slots[slot].generation = _slots[slot].generation == UINT32_MAX ? 1 : _slots[slot].generation + 1;
+	_slots[slot].nextFree = _firstFree;
+	_firstFree = slot;
+}
+
+@end
@@ -0,0 +1,52 @@
+//
+//  GRKTimingAggregator.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+#import "GRKTimingHistogram.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Aggregates durations into a `GRKTimingHistogram` per event name and category.
+
+ Each thread records into histograms of its own, so recording takes no locks and threads never contend. The per thread histograms are merged when drained.
+ A thread's histograms are kept until it exits, so memory grows with the number of threads and distinct event names and categories timed.
+ */
+@interface GRKTimingAggregator : NSObject
+
+/**
+ The number of per thread histograms held: one for each event name and category timed by each thread, until the last drain after the thread exits.
+ */
+@property (nonatomic, readonly) NSUInteger histogramCount;
+
+/**
+ Record a duration. This may be called from any thread.
+
+ @param nanoseconds The duration, in nanoseconds.
+ @param event       The name of the event.
+ @param category    The category of the event.
+ */
+- (void)recordDuration:(uint64_t)nanoseconds forEvent:(NSString *)event category:(nullable NSString *)category;
+
+/**
+ Merge every thread's histograms, and reset them.
+
+ @param block Called with the merged histogram of each event name and category with durations recorded since the last drain.
+ */
+- (void)drainWithBlock:(void (^)(NSString *event, NSString * _Nullable category, GRKTimingHistogram *histogram))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
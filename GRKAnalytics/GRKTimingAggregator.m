@@ -0,0 +1,177 @@
+//
+//  GRKTimingAggregator.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKTimingAggregator.h"
+#import <pthread.h>
+#import <stdatomic.h>
+
+// One thread's histograms.
+@interface GRKTimingShard : NSObject
+{
+	@public
+	// Set once the owning thread has exited, so its histograms can be let go of after their last drain.
+	atomic_bool _retired;
+}
+
+// Event -> category (or `NSNull`) -> histogram. Only accessed by the owning thread.
+@property (nonatomic, strong) GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, NSMutableDictionary *) *histograms;
+
+@end
+
+@implementation GRKTimingShard
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		_histograms = [NSMutableDictionary dictionary];
+	}
+
+	return self;
+}
+
+@end
+
+// A histogram of one shard, as known to the aggregator.
+@interface GRKTimingShardEntry : NSObject
+
+@property (nonatomic, strong) GRKTimingShard *shard;
+@property (nonatomic, copy) NSString *event;
+@property (nonatomic, strong) id category;
+@property (nonatomic, strong) GRKTimingHistogram *histogram;
+
+@end
+
+@implementation GRKTimingShardEntry
+
+@end
+
+// Called as a thread exits, with its (retained) shard.
+static void GRKTimingShardRetire(void *value)
+{
+	GRKTimingShard *shard = CFBridgingRelease(value);
+	atomic_store_explicit(&shard->_retired, true, memory_order_release);
+}
+
+@interface GRKTimingAggregator ()
+{
+	pthread_key_t _shardKey;
+}
+
+// Every shard histogram. Guarded by `self`.
+@property (nonatomic, strong) NSMutableArray<GRKTimingShardEntry *> *entries;
+
+@end
+
+@implementation GRKTimingAggregator
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		_entries = [NSMutableArray array];
+		pthread_key_create(&_shardKey, GRKTimingShardRetire);
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	// Live threads' shards are not retired by this, and are leaked.
+	pthread_key_delete(_shardKey);
+}
+
+#pragma mark - Accessors
+
+- (NSUInteger)histogramCount
+{
+	@synchronized (self) {
+		return self.entries.count;
+	}
+}
+
+#pragma mark - Recording
+
+- (void)recordDuration:(uint64_t)nanoseconds forEvent:(NSString *)event category:(nullable NSString *)category
+{
+	GRKTimingShard *shard = (__bridge GRKTimingShard *)pthread_getspecific(_shardKey);
+	if (!shard) {
+		shard = [[GRKTimingShard alloc] init];
+		pthread_setspecific(_shardKey, CFBridgingRetain(shard));
+	}
+
+	id categoryKey = category ?: [NSNull null];
+	NSMutableDictionary<id, GRKTimingHistogram *> *categories = shard.histograms[event];
+	GRKTimingHistogram *histogram = categories[categoryKey];
+	if (!histogram) {
+		if (!categories) {
+			categories = [NSMutableDictionary dictionary];
+			shard.histograms[event] = categories;
+		}
+		histogram = [[GRKTimingHistogram alloc] init];
+		categories[categoryKey] = histogram;
+
+		GRKTimingShardEntry *entry = [[GRKTimingShardEntry alloc] init];
+		entry.shard = shard;
+		entry.event = event;
+		entry.category = categoryKey;
+		entry.histogram = histogram;
+		@synchronized (self) {
+			[self.entries addObject:entry];
+		}
+	}
+
+	[histogram recordValue:nanoseconds];
+}
+
+#pragma mark - Draining
+
+- (void)drainWithBlock:(void (^)(NSString *event, NSString * _Nullable category, GRKTimingHistogram *histogram))block
+{
+	NSMutableDictionary<NSString *, NSMutableDictionary<id, GRKTimingHistogram *> *> *merged = [NSMutableDictionary dictionary];
+
+	@synchronized (self) {
+		NSMutableIndexSet *retiredIndexes = [NSMutableIndexSet indexSet];
+		[self.entries enumerateObjectsUsingBlock:^(GRKTimingShardEntry *entry, NSUInteger index, BOOL *stop) {
+			// Checked before moving the counts, so a retired shard's last recordings are moved with them.
+			if (atomic_load_explicit(&entry.shard->_retired, memory_order_acquire)) {
+				[retiredIndexes addIndex:index];
+			}
+
+			NSMutableDictionary<id, GRKTimingHistogram *> *categories = merged[entry.event];
+			if (!categories) {
+				categories = [NSMutableDictionary dictionary];
+				merged[entry.event] = categories;
+			}
+			GRKTimingHistogram *histogram = categories[entry.category];
+			if (!histogram) {
+				histogram = [[GRKTimingHistogram alloc] init];
+				categories[entry.category] = histogram;
+			}
+			[entry.histogram moveCountsToHistogram:histogram];
+		}];
+		[self.entries removeObjectsAtIndexes:retiredIndexes];
+	}
+
+	[merged enumerateKeysAndObjectsUsingBlock:^(NSString *event, NSMutableDictionary<id, GRKTimingHistogram *> *categories, BOOL *stop) {
+		[categories enumerateKeysAndObjectsUsingBlock:^(id category, GRKTimingHistogram *histogram, BOOL *innerStop) {
+			if (histogram.count > 0) {
+				block(event, category == [NSNull null] ? nil : category, histogram);
+			}
+		}];
+	}];
+}
+
+@end
@@ -0,0 +1,73 @@
+//
+//  GRKTimingHistogram.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import <Foundation/Foundation.h>
+#import "GRKLanguageFeatures.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The largest value a `GRKTimingHistogram` tells apart, in nanoseconds (a little over 73 minutes). Larger values are counted as this value.
+ */
+extern uint64_t const kGRKTimingHistogramMaximumValue;
+
+/**
+ A high dynamic range histogram of durations, in nanoseconds.
+
+ Values are counted in buckets whose width grows with their magnitude, so every value is held to within 1/32nd (about 3%) of itself, from a nanosecond up to `kGRKTimingHistogramMaximumValue`, in a fixed amount of memory (under 5 KB).
+ Each bucket counts up to 2^32 - 1 values between moves.
+ Recording is lock free, and may happen on any thread. Recording is cheapest when each histogram is only recorded into by a single thread, and read by merging it into another with `moveCountsToHistogram:`.
+ */
+@interface GRKTimingHistogram : NSObject
+
+/**
+ The number of values recorded.
+ */
+@property (nonatomic, readonly) uint64_t count;
+
+/**
+ The smallest value recorded, or `0` if no values have been recorded.
+ */
+@property (nonatomic, readonly) uint64_t minimum;
+
+/**
+ The largest value recorded, or `0` if no values have been recorded.
+ */
+@property (nonatomic, readonly) uint64_t maximum;
+
+/**
+ Record a value.
+
+ @param value The value to record, in nanoseconds.
+ */
+- (void)recordValue:(uint64_t)value;
+
+/**
+ The value at the given percentile: the largest value no more than `percentile` percent of recorded values exceed, to within the precision of the histogram.
+
+ @param percentile The percentile, from `0` to `100`.
+ @return The value at the percentile, in nanoseconds, or `0` if no values have been recorded.
+ */
+- (uint64_t)valueAtPercentile:(double)percentile;
+
+/**
+ Add this histogram's counts to the given histogram, and reset this one. Values recorded into this histogram meanwhile are either moved or kept, never lost.
+
+ @param histogram The histogram to add the counts to.
+ */
+- (void)moveCountsToHistogram:(GRKTimingHistogram *)histogram;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,171 @@
+//
+//  GRKTimingHistogram.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//  or send a letter to Creative Commons, PO Box 1866, Mountain View, CA 94042, USA.
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKTimingHistogram.h"
+#import <math.h>
+#import <stdatomic.h>
+
+// This is Gil Tene's HdrHistogram layout, with a unit of one nanosecond. Values below `kGRKTimingHistogramSubBucketCount`
+// are counted exactly. Above that, each power of two range is split into `kGRKTimingHistogramSubBucketCount / 2` equal
+// sub-buckets, so the width of a bucket is never more than 1/32nd of the values it holds.
+// The precision and the 32 bit counts keep a histogram to under 5 KB, as the aggregator keeps one per thread, event and category.
+// See http://hdrhistogram.org
+enum {
+	kGRKTimingHistogramSubBucketBits = 6,
+	kGRKTimingHistogramSubBucketCount = 1 << kGRKTimingHistogramSubBucketBits,
+	kGRKTimingHistogramSubBucketHalfCount = kGRKTimingHistogramSubBucketCount / 2,
+	kGRKTimingHistogramValueBits = 42,
+	kGRKTimingHistogramCountsLength = (kGRKTimingHistogramValueBits - kGRKTimingHistogramSubBucketBits + 1) * kGRKTimingHistogramSubBucketHalfCount + kGRKTimingHistogramSubBucketHalfCount,
+};
+
+uint64_t const kGRKTimingHistogramMaximumValue = (1ULL << kGRKTimingHistogramValueBits) - 1;
+
+static inline NSUInteger GRKTimingHistogramIndexForValue(uint64_t value)
+{
+	// The bucket is the number of significant bits above the sub-bucket range; values in bucket zero are exact.
+	unsigned int bucket = (unsigned int)(64 - __builtin_clzll(value | (kGRKTimingHistogramSubBucketCount - 1))) - kGRKTimingHistogramSubBucketBits;
+	NSUInteger subBucket = (NSUInteger)(value >> bucket);
+	return ((NSUInteger)bucket << (kGRKTimingHistogramSubBucketBits - 1)) + subBucket;
+}
+
+// The largest value counted at the given index.
+static inline uint64_t GRKTimingHistogramHighestValueAtIndex(NSUInteger index)
+{
+	unsigned int bucket = index < kGRKTimingHistogramSubBucketCount ? 0 : (unsigned int)(index >> (kGRKTimingHistogramSubBucketBits - 1)) - 1;
+	uint64_t subBucket = index - ((NSUInteger)bucket << (kGRKTimingHistogramSubBucketBits - 1));
+	return (subBucket << bucket) + ((1ULL << bucket) - 1);
+}
+
+static inline void GRKTimingHistogramStoreMinimum(atomic_uint_least64_t *minimum, uint64_t value)
+{
+	uint64_t current = atomic_load_explicit(minimum, memory_order_relaxed);
+	while (value < current && !atomic_compare_exchange_weak_explicit(minimum, &current, value, memory_order_relaxed, memory_order_relaxed)) {
+	}
+}
+
+static inline void GRKTimingHistogramStoreMaximum(atomic_uint_least64_t *maximum, uint64_t value)
+{
+	uint64_t current = atomic_load_explicit(maximum, memory_order_relaxed);
+	while (value > current && !atomic_compare_exchange_weak_explicit(maximum, &current, value, memory_order_relaxed, memory_order_relaxed)) {
+	}
+}
+
+@interface GRKTimingHistogram ()
+{
+	atomic_uint_least32_t _counts[kGRKTimingHistogramCountsLength];
+	// `UINT64_MAX` while empty.
+	atomic_uint_least64_t _minimum;
+	atomic_uint_least64_t _maximum;
+}
+
+@end
+
+@implementation GRKTimingHistogram
+
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		// The counts are zeroed by `alloc`.
+		atomic_init(&_minimum, UINT64_MAX);
+	}
+
+	return self;
+}
+
+#pragma mark - Accessors
+
+- (uint64_t)count
+{
+	// Summed rather than kept, so recording touches one count less, and the total always agrees with the counts.
+	uint64_t retVal = 0;
+	for (NSUInteger index = 0; index < kGRKTimingHistogramCountsLength; ++index) {
+		retVal += atomic_load_explicit(&_counts[index], memory_order_relaxed);
+	}
+
+	return retVal;
+}
+
+- (uint64_t)minimum
+{
+	uint64_t minimum = atomic_load_explicit(&_minimum, memory_order_relaxed);
+	return minimum == UINT64_MAX ? 0 : minimum;
+}
+
+- (uint64_t)maximum
+{
+	return atomic_load_explicit(&_maximum, memory_order_relaxed);
+}
+
+#pragma mark - Recording
+
+- (void)recordValue:(uint64_t)value
+{
+	value = MIN(value, kGRKTimingHistogramMaximumValue);
+
+	atomic_fetch_add_explicit(&_counts[GRKTimingHistogramIndexForValue(value)], 1, memory_order_relaxed);
+	GRKTimingHistogramStoreMinimum(&_minimum, value);
+	GRKTimingHistogramStoreMaximum(&_maximum, value);
+}
+
+- (void)moveCountsToHistogram:(GRKTimingHistogram *)histogram
+{
+	// At worst, a concurrent recording's value is in the minimum or maximum moved now, and its count is moved next time.
+	uint64_t minimum = atomic_exchange_explicit(&_minimum, UINT64_MAX, memory_order_relaxed);
+	uint64_t maximum = atomic_exchange_explicit(&_maximum, 0, memory_order_relaxed);
+	uint64_t moved = 0;
+
+	for (NSUInteger index = 0; index < kGRKTimingHistogramCountsLength; ++index) {
+		if (atomic_load_explicit(&_counts[index], memory_order_relaxed) > 0) {
+			uint32_t count = atomic_exchange_explicit(&_counts[index], 0, memory_order_relaxed);
+			atomic_fetch_add_explicit(&histogram->_counts[index], count, memory_order_relaxed);
+			moved += count;
+		}
+	}
+
+	if (moved > 0) {
+		GRKTimingHistogramStoreMinimum(&histogram->_minimum, minimum);
+		GRKTimingHistogramStoreMaximum(&histogram->_maximum, maximum);
+	}
+}
+
+#pragma mark - Percentiles
+
+- (uint64_t)valueAtPercentile:(double)percentile
+{
+	uint64_t total = self.count;
+	if (total == 0) {
+		return 0;
+	}
+
+	percentile = MIN(MAX(percentile, 0.0), 100.0);
+	uint64_t target = MAX((uint64_t)ceil(percentile / 100.0 * (double)total), (uint64_t)1);
+	uint64_t cumulative = 0;
+	uint64_t retVal = 0;
+
+	for (NSUInteger index = 0; index < kGRKTimingHistogramCountsLength; ++index) {
+		cumulative += atomic_load_explicit(&_counts[index], memory_order_relaxed);
+		if (cumulative >= target) {
+			retVal = GRKTimingHistogramHighestValueAtIndex(index);
+			break;
+		}
+	}
+
+	// The bucket's highest value may lie beyond anything actually recorded.
+	uint64_t maximum = self.maximum;
+	return maximum > 0 ? MIN(retVal, maximum) : retVal;
+}
+
+@end
@@ -43,6 +43,17 @@ static NSString *const kGRKAppCenterAnalyticsPropertyContentID NS_SWIFT_NAME(Ana
 
 @interface GRKAppCenterProvider : GRKAnalyticsProvider
 
+/**
+ User properties set within this many seconds of each other are gathered and applied together, in a single `[MSAppCenter setCustomProperties:]` call. So identifying a user and then setting several properties is one call to the SDK.
+ If zero, each user property is applied as it is set. Defaults to `1`.
+ */
+@property (atomic, assign) NSTimeInterval userPropertyFlushInterval;
+
+/**
+ Apply any gathered user properties now. This is also done when the app enters the background.
+ */
+- (void)flushUserProperties;
+
 @end
 
 NS_ASSUME_NONNULL_END
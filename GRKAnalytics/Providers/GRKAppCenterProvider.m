@@ -13,6 +13,8 @@
 
 #import "GRKAppCenterProvider.h"
 #import <GRKAnalytics/GRKLanguageFeatures.h>
+#import <GRKAnalytics/GRKOverlayDictionary.h>
+#import <GRKAnalytics/GRKFlushScheduler.h>
 
 #ifdef GRK_ANALYTICS_ENABLED
 
@@ -25,8 +27,182 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+#ifdef GRK_ANALYTICS_ENABLED
+
+// "The property names and values are limited to 125 characters each"; custom property keys are held to the same limit.
+static NSUInteger const kGRKAppCenterMaximumPropertyLength = 125;
+// "The number of properties per event is limited to 20"
+static NSUInteger const kGRKAppCenterPropertyBudget = 20;
+// Characters are copied through this fixed stack buffer, a chunk at a time, however long the key.
+static NSUInteger const kGRKAppCenterSanitizeChunkLength = 64;
+
+typedef uint16_t GRKAppCenterCharacters16 __attribute__((ext_vector_type(16)));
+typedef int16_t GRKAppCenterMask16 __attribute__((ext_vector_type(16)));
+
+// Whether all 16 characters are ASCII letters or digits, classified together.
+static inline BOOL GRKAppCenterIsASCIIAlphanumeric16(const unichar *characters)
+{
+	GRKAppCenterCharacters16 c;
+	memcpy(&c, characters, sizeof(c));
+	GRKAppCenterCharacters16 folded = c | 0x20;
+	GRKAppCenterMask16 mask = ((c >= '0') & (c <= '9')) | ((folded >= 'a') & (folded <= 'z'));
+
+	uint64_t words[sizeof(mask) / sizeof(uint64_t)];
+	memcpy(words, &mask, sizeof(mask));
+	return (words[0] & words[1] & words[2] & words[3]) == UINT64_MAX;
+}
+
+static BOOL GRKAppCenterIsLetter(unichar c)
+{
+	if (c < 0x80) {
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+	}
+
+	static NSCharacterSet *letters = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		letters = [NSCharacterSet letterCharacterSet];
+	});
+
+	return [letters characterIsMember:c];
+}
+
+static BOOL GRKAppCenterIsAlphanumeric(unichar c)
+{
+	if (c < 0x80) {
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+	}
+
+	static NSCharacterSet *alphanumerics = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		alphanumerics = [NSCharacterSet alphanumericCharacterSet];
+	});
+
+	return [alphanumerics characterIsMember:c];
+}
+
+static BOOL GRKAppCenterIsWhitespace(unichar c)
+{
+	if (c < 0x80) {
+		return c == ' ' || (c >= '\t' && c <= '\r');
+	}
+
+	static NSCharacterSet *whitespace = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		whitespace = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+	});
+
+	return [whitespace characterIsMember:c];
+}
+
+// The string, cut to at most `maxLength` characters without splitting a composed character sequence.
+static NSString *GRKAppCenterCroppedString(NSString *string, NSUInteger maxLength)
+{
+	if (string.length <= maxLength) {
+		return string;
+	}
+
+	return [string substringToIndex:[string rangeOfComposedCharacterSequenceAtIndex:maxLength].location];
+}
+
+// Appends a description of the value until the string holds `maxLength` characters. Collections are described an element at a time,
+// so a large one is never described in full only to be cut short.
+static void GRKAppCenterAppendDescription(NSMutableString *string, id value, NSUInteger maxLength)
+{
+	if (string.length >= maxLength) {
+		return;
+	}
+
+	if ([value isKindOfClass:NSString.class]) {
+		[string appendString:GRKAppCenterCroppedString(value, maxLength - string.length)];
+	}
+	else if ([value isKindOfClass:NSDictionary.class]) {
+		[string appendString:@"{"];
+		NSString *separator = @"";
+		for (id key in value) {
+			if (string.length >= maxLength) {
+				break;
+			}
+			[string appendString:separator];
+			GRKAppCenterAppendDescription(string, key, maxLength);
+			[string appendString:@" = "];
+			GRKAppCenterAppendDescription(string, ((NSDictionary *)value)[key], maxLength);
+			separator = @"; ";
+		}
+		[string appendString:@"}"];
+	}
+	else if ([value isKindOfClass:NSArray.class] || [value isKindOfClass:NSSet.class] || [value isKindOfClass:NSOrderedSet.class]) {
+		[string appendString:@"("];
+		NSString *separator = @"";
+		for (id element in value) {
+			if (string.length >= maxLength) {
+				break;
+			}
+			[string appendString:separator];
+			GRKAppCenterAppendDescription(string, element, maxLength);
+			separator = @", ";
+		}
+		[string appendString:@")"];
+	}
+	else {
+		[string appendString:GRKAppCenterCroppedString([value description] ?: @"", maxLength - string.length)];
+	}
+}
+
+// A description of the value of at most `maxLength` characters.
+static NSString *GRKAppCenterBoundedDescription(id value, NSUInteger maxLength)
+{
+	if ([value isKindOfClass:NSString.class]) {
+		return GRKAppCenterCroppedString(value, maxLength);
+	}
+
+	NSMutableString *retVal = [NSMutableString string];
+	GRKAppCenterAppendDescription(retVal, value, maxLength);
+
+	return GRKAppCenterCroppedString(retVal, maxLength);
+}
+
+@interface GRKAppCenterProvider () <GRKFlushable>
+@end
+
+#endif //GRK_ANALYTICS_ENABLED
+
+@interface GRKAppCenterProvider ()
+
+// Property -> value (or `NSNull` to clear), waiting to be applied in a single call. Guarded by `self`.
+@property (nonatomic, strong) GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *pendingUserProperties;
+// Incremented with each flush, so a stale flush timer can tell its properties have already been applied. Guarded by `self`.
+@property (nonatomic, assign) NSUInteger userPropertyGeneration;
+
+@end
+
 @implementation GRKAppCenterProvider
 
+#pragma mark - Lifecycle
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		_pendingUserProperties = [NSMutableDictionary dictionary];
+		_userPropertyFlushInterval = 1.0;
+		self.parameterBudget = kGRKAppCenterPropertyBudget;
+#ifdef GRK_ANALYTICS_ENABLED
+		[[GRKFlushScheduler sharedScheduler] registerFlushable:self];
+#endif //GRK_ANALYTICS_ENABLED
+	}
+	
+	return self;
+}
+
+- (void)dealloc
+{
+#ifdef GRK_ANALYTICS_ENABLED
+	[[GRKFlushScheduler sharedScheduler] unregisterFlushable:self];
+#endif //GRK_ANALYTICS_ENABLED
+}
+
 #ifdef GRK_ANALYTICS_ENABLED
 
 - (void)setEnabled:(BOOL)enabled
@@ -64,33 +240,112 @@ NS_ASSUME_NONNULL_BEGIN
 	property = [self sanitizeUserPropertyKey:property];
 	
 	if (property.length > 0) {
+		BOOL schedule = NO;
+		@synchronized (self) {
+			schedule = self.pendingUserProperties.count == 0;
+			// A later set or clear of the same key replaces the pending one.
+			self.pendingUserProperties[property] = value ?: [NSNull null];
+		}
 		
-		// "A custom property's value may be one of the following types: NSString, NSNumber, BOOL and NSDate."
-		// We only accept objects, so `BOOL` is not an option (use `NSNumber`).
-		// If the object is not one of these types we treat it as a String.
-		MSCustomProperties *msProperties = [[MSCustomProperties alloc] init];
-		if (value) {
-			if ([value isKindOfClass:NSNumber.class]) {
-				[msProperties setNumber:value forKey:property];
-			}
-			else if ([value isKindOfClass:NSDate.class]) {
-				[msProperties setDate:value forKey:property];
+		NSTimeInterval flushInterval = self.userPropertyFlushInterval;
+		if (flushInterval <= 0) {
+			[self flushUserProperties];
+		}
+		else if (schedule) {
+			[self scheduleUserPropertyFlushAfter:flushInterval];
+		}
+	}
+}
+
+#endif //GRK_ANALYTICS_ENABLED
+
+- (void)flushUserProperties
+{
+#ifdef GRK_ANALYTICS_ENABLED
+	NSDictionary<NSString *, id> *pendingUserProperties = nil;
+	@synchronized (self) {
+		if (self.pendingUserProperties.count > 0) {
+			pendingUserProperties = [self.pendingUserProperties copy];
+			[self.pendingUserProperties removeAllObjects];
+			self.userPropertyGeneration += 1;
+		}
+	}
+	
+	if (pendingUserProperties) {
+		[MSAppCenter setCustomProperties:[self customPropertiesForProperties:pendingUserProperties]];
+	}
+#endif //GRK_ANALYTICS_ENABLED
+}
+
+#ifdef GRK_ANALYTICS_ENABLED
+
+- (void)scheduleUserPropertyFlushAfter:(NSTimeInterval)interval
+{
+	NSUInteger generation = 0;
+	@synchronized (self) {
+		generation = self.userPropertyGeneration;
+	}
+	
+	__weak typeof(self) weakSelf = self;
+	dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+		typeof(self) strongSelf = weakSelf;
+		BOOL current = NO;
+		@synchronized (strongSelf) {
+			current = generation == strongSelf.userPropertyGeneration;
+		}
+		// A flush since this was scheduled has already applied the properties it was for.
+		if (current) {
+			[strongSelf flushUserProperties];
+		}
+	});
+}
+
+// "A custom property's value may be one of the following types: NSString, NSNumber, BOOL and NSDate."
+// We only accept objects, so `BOOL` is not an option (use `NSNumber`).
+// If the object is not one of these types we treat it as a String. `NSNull` clears the property.
+- (MSCustomProperties *)customPropertiesForProperties:(NSDictionary<NSString *, id> *)properties
+{
+	MSCustomProperties *msProperties = [[MSCustomProperties alloc] init];
+	
+	[properties enumerateKeysAndObjectsUsingBlock:^(NSString *property, id value, BOOL *stop) {
+		if (value == [NSNull null]) {
+			[msProperties clearPropertyForKey:property];
+		}
+		else if ([value isKindOfClass:NSNumber.class]) {
+			[msProperties setNumber:value forKey:property];
+		}
+		else if ([value isKindOfClass:NSDate.class]) {
+			[msProperties setDate:value forKey:property];
+		}
+		else {
+			NSString *stringValue = nil;
+			if ([value isKindOfClass:NSString.class]) {
+				stringValue = value;
 			}
 			else {
-				NSString *stringValue = nil;
-				if ([value isKindOfClass:NSString.class]) {
-					stringValue = value;
-				}
-				else {
-					stringValue = [value description];
-				}
-				
-				[msProperties setString:stringValue forKey:property];
+				stringValue = [value description];
 			}
+			
+			[msProperties setString:stringValue forKey:property];
 		}
-		else {
-			[msProperties clearPropertyForKey:property];
-		}
+	}];
+	
+	return msProperties;
+}
+
+#pragma mark GRKFlushable
+
+- (void)flushWithHitLimit:(NSUInteger)hitLimit completion:(void (^)(GRKFlushStepResult result, NSUInteger flushedCount))completion
+{
+	NSUInteger count = self.pendingHitCount;
+	[self flushUserProperties];
+	completion(GRKFlushStepResultDone, count);
+}
+
+- (NSUInteger)pendingHitCount
+{
+	@synchronized (self) {
+		return self.pendingUserProperties.count;
 	}
 }
 
@@ -100,17 +355,39 @@ NS_ASSUME_NONNULL_BEGIN
 		  category:(nullable NSString *)category
 		properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
 {
-	event = [self delegateEventForEvent:event];
+	[self trackEvent:event category:category properties:properties objects:NULL forKeys:NULL count:0];
+}
 
-	// "There is a maximum limit of 256 characters per event name..."
-	NSString *sanitizedEvent = [self sanitizeString:event maxLength:256];
+// Tracks the event with the given entries added to its properties. Room is left for the entries (and the category) when the properties are trimmed to `parameterBudget`.
+- (void)trackEvent:(NSString *)event
+		  category:(nullable NSString *)category
+		properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+		   objects:(const id _Nullable [_Nullable])objects
+		   forKeys:(const id _Nullable [_Nullable])keys
+			 count:(NSUInteger)count
+{
+	NSUInteger reservedParameterCount = 0;
+	for (NSUInteger index = 0; index < count; ++index) {
+		if (objects[index] && keys[index]) {
+			++reservedParameterCount;
+		}
+	}
+	BOOL addsCategory = category.length > 0 && !properties[self.categoryPropertyName];
+	if (addsCategory) {
+		++reservedParameterCount;
+	}
+	
+	GRKDeliveryPlan *plan = [self deliveryPlanForEvent:event properties:properties reservedParameterCount:reservedParameterCount];
+	NSString *sanitizedEvent = plan.event;
 	if (sanitizedEvent.length > 0) {
-		properties = [self delegatePropertiesForProperties:properties];
+		properties = [plan propertiesForProperties:properties];
+		[self recordDroppedProperties:plan.droppedPropertyCount];
 		
-		if (category.length > 0 && !properties[self.categoryPropertyName]) {
-			GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *mutableProperties = [properties mutableCopy];
-			mutableProperties[self.categoryPropertyName] = category;
-			properties = mutableProperties;
+		if (count > 0) {
+			properties = [GRKOverlayDictionary dictionaryWithBase:properties objects:objects forKeys:keys count:count];
+		}
+		if (addsCategory && !properties[self.categoryPropertyName]) {
+			properties = [GRKOverlayDictionary dictionaryWithBase:properties object:category forKey:self.categoryPropertyName];
 		}
 
 		MSEventProperties *sanitizedProperties = [self sanitizeProperties:properties];
@@ -130,26 +407,20 @@ NS_ASSUME_NONNULL_BEGIN
 							  success:(nullable NSNumber *)success
 						   properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
 {
-	properties = [self delegatePropertiesForProperties:properties];
-	
-	GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *mutableProperties = [properties mutableCopy];
-	mutableProperties[kGRKAppCenterAnalyticsPropertySignUpMethod] = method;
-	mutableProperties[self.successPropertyName] = success;
+	id keys[] = {kGRKAppCenterAnalyticsPropertySignUpMethod, self.successPropertyName};
+	id objects[] = {method, success};
 
-	[self trackEvent:kGRKAppCenterAnalyticsEventSignUp category:nil properties:mutableProperties];
+	[self trackEvent:kGRKAppCenterAnalyticsEventSignUp category:nil properties:properties objects:objects forKeys:keys count:2];
 }
 
 - (void)trackLoginWithMethod:(nullable NSString *)method
 					 success:(nullable NSNumber *)success
 				  properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
 {
-	properties = [self delegatePropertiesForProperties:properties];
-	
-	GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *mutableProperties = [properties mutableCopy];
-	mutableProperties[kGRKAppCenterAnalyticsPropertySignUpMethod] = method;
-	mutableProperties[self.successPropertyName] = success;
-	
-	[self trackEvent:kGRKAppCenterAnalyticsEventLogin category:nil properties:mutableProperties];
+	id keys[] = {kGRKAppCenterAnalyticsPropertySignUpMethod, self.successPropertyName};
+	id objects[] = {method, success};
+
+	[self trackEvent:kGRKAppCenterAnalyticsEventLogin category:nil properties:properties objects:objects forKeys:keys count:2];
 }
 
 - (void)trackPurchaseInCategory:(nullable NSString *)category
@@ -161,17 +432,10 @@ NS_ASSUME_NONNULL_BEGIN
 						 itemID:(nullable NSString *)identifier
 					 properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties;
 {
-	properties = [self delegatePropertiesForProperties:properties];
-	
-	GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *mutableProperties = [properties mutableCopy];
-	mutableProperties[kGRKAppCenterAnalyticsPropertyPrice] = price;
-	mutableProperties[kGRKAppCenterAnalyticsPropertyCurrency] = currency;
-	mutableProperties[self.successPropertyName] = success;
-	mutableProperties[kGRKAppCenterAnalyticsPropertyItemName] = itemName;
-	mutableProperties[kGRKAppCenterAnalyticsPropertyItemType] = itemType;
-	mutableProperties[kGRKAppCenterAnalyticsPropertyItemID] = identifier;
-
-	[self trackEvent:kGRKAppCenterAnalyticsEventPurchase category:category properties:mutableProperties];
+	id keys[] = {kGRKAppCenterAnalyticsPropertyPrice, kGRKAppCenterAnalyticsPropertyCurrency, self.successPropertyName, kGRKAppCenterAnalyticsPropertyItemName, kGRKAppCenterAnalyticsPropertyItemType, kGRKAppCenterAnalyticsPropertyItemID};
+	id objects[] = {price, currency, success, itemName, itemType, identifier};
+
+	[self trackEvent:kGRKAppCenterAnalyticsEventPurchase category:category properties:properties objects:objects forKeys:keys count:6];
 }
 
 - (void)trackContentViewWithName:(nullable NSString *)name
@@ -179,14 +443,10 @@ NS_ASSUME_NONNULL_BEGIN
 					   contentID:(nullable NSString *)identifier
 					  properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
 {
-	properties = [self delegatePropertiesForProperties:properties];
-	
-	GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *mutableProperties = [properties mutableCopy];
-	mutableProperties[kGRKAppCenterAnalyticsPropertyContentName] = name;
-	mutableProperties[kGRKAppCenterAnalyticsPropertyContentType] = type;
-	mutableProperties[kGRKAppCenterAnalyticsPropertyContentID] = identifier;
-	
-	[self trackEvent:kGRKAppCenterAnalyticsEventContentView category:nil properties:mutableProperties];
+	id keys[] = {kGRKAppCenterAnalyticsPropertyContentName, kGRKAppCenterAnalyticsPropertyContentType, kGRKAppCenterAnalyticsPropertyContentID};
+	id objects[] = {name, type, identifier};
+
+	[self trackEvent:kGRKAppCenterAnalyticsEventContentView category:nil properties:properties objects:objects forKeys:keys count:3];
 }
 
 #pragma mark - Errors
@@ -198,38 +458,76 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark - Helpers
 
-- (NSString *)sanitizeUserPropertyKey:(NSString *)propertyKey
+- (NSString *)sanitizeUserPropertyKey:(nullable NSString *)propertyKey
 {
-	propertyKey = [propertyKey stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-	NSString *retVal = @"";
-	
 	// "A valid key for custom property should match regular expression pattern ^[a-zA-Z][a-zA-Z0-9]*$."
-	// If we have a string to work with, we will ensure the leading character is a character from `letterCharacterSet` (prepending one if needed),
-	// then we will strip any characters not in the `alphanumericCharacterSet`
-	if (propertyKey.length > 0) {
-		NSUInteger length = propertyKey.length;
-		unichar resultBuffer[length + 1]; // +1 in case we need to prepend a character from `letterCharacterSet`
-		unichar inputBuffer[length];
-		[propertyKey getCharacters:inputBuffer range:NSMakeRange(0, length)];
-		
-		NSUInteger resultIndex = 0;
-		NSUInteger inputIndex = 0;
-		unichar firstChar = inputBuffer[inputIndex++];
-		resultBuffer[resultIndex++] = [[NSCharacterSet letterCharacterSet] characterIsMember:firstChar] ? firstChar : 'a';
-		
-		for (; inputIndex < length; ++inputIndex) {
-			unichar nextChar = inputBuffer[inputIndex];
-			if ([[NSCharacterSet alphanumericCharacterSet] characterIsMember:nextChar]) {
-				resultBuffer[resultIndex++] = nextChar;
+	// Leading whitespace is skipped, the leading character must be from `letterCharacterSet` (replaced with 'a' if not),
+	// then we will strip any characters not in the `alphanumericCharacterSet`. The result is capped at `kGRKAppCenterMaximumPropertyLength`.
+	// All buffers are fixed in size, and a key which is already valid is returned as is.
+	CFStringRef string = (__bridge CFStringRef)propertyKey;
+	NSUInteger length = propertyKey.length;
+	const unichar *characters = string ? CFStringGetCharactersPtr(string) : NULL;
+
+	unichar chunk[kGRKAppCenterSanitizeChunkLength];
+	unichar result[kGRKAppCenterMaximumPropertyLength];
+	NSUInteger resultLength = 0;
+	NSUInteger consumed = 0;
+	BOOL changed = NO;
+
+	while (consumed < length && resultLength < kGRKAppCenterMaximumPropertyLength) {
+		NSUInteger chunkLength = MIN(kGRKAppCenterSanitizeChunkLength, length - consumed);
+		const unichar *chunkCharacters = characters ? characters + consumed : chunk;
+		if (!characters) {
+			CFStringGetCharacters(string, CFRangeMake((CFIndex)consumed, (CFIndex)chunkLength), chunk);
+		}
+
+		NSUInteger index = 0;
+		while (index < chunkLength && resultLength < kGRKAppCenterMaximumPropertyLength) {
+			// Past the leading character, take 16 ASCII alphanumerics at a time.
+			if (resultLength > 0 && index + 16 <= chunkLength && resultLength + 16 <= kGRKAppCenterMaximumPropertyLength && GRKAppCenterIsASCIIAlphanumeric16(chunkCharacters + index)) {
+				memcpy(result + resultLength, chunkCharacters + index, 16 * sizeof(unichar));
+				resultLength += 16;
+				index += 16;
+				continue;
+			}
+
+			unichar c = chunkCharacters[index++];
+			if (resultLength == 0) {
+				if (GRKAppCenterIsWhitespace(c)) {
+					changed = YES;
+				}
+				else if (GRKAppCenterIsLetter(c)) {
+					result[resultLength++] = c;
+				}
+				else {
+					result[resultLength++] = 'a';
+					changed = YES;
+				}
+			}
+			else if (GRKAppCenterIsAlphanumeric(c)) {
+				result[resultLength++] = c;
+			}
+			else {
+				changed = YES;
 			}
 		}
-		
-		retVal = [[NSString alloc] initWithCharacters:resultBuffer length:resultIndex];
+		consumed += index;
 	}
-	
+
+	NSString *retVal = @"";
+	if (resultLength > 0) {
+		retVal = changed || consumed < length ? [[NSString alloc] initWithCharacters:result length:resultLength] : propertyKey;
+	}
+
 	return retVal;
 }
 
+- (nullable NSString *)sanitizedEventForEvent:(NSString *)event
+{
+	// "There is a maximum limit of 256 characters per event name..."
+	return [self sanitizeString:event maxLength:256];
+}
+
 - (NSString *)sanitizeString:(nullable NSString *)key maxLength:(NSUInteger)maxLength
 {
 	NSString *retVal = [self cropString:key maxLength:maxLength] ?: @"";
@@ -240,35 +538,37 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	// "The property names and values are limited to 125 characters each (truncated)."
 	// "The number of properties per event is limited to 20 (truncated)."
-	// We are not going to truncate anything here... let the MS framework handle it if they must.
+	// We hold to these limits here, rather than build properties the MS framework would only throw away.
 	
 	MSEventProperties *msProperties = nil;
 	
 	if (properties) {
 		msProperties = [[MSEventProperties alloc] init];
+		NSUInteger parameterBudget = self.parameterBudget;
+		NSUInteger examinedCount = 0;
 		
 		// "An event property's value may be one of the following types: NSString, double, int64_t, BOOL and NSDate."
 		// We only accept objects, so `BOOL` is not an option (use `NSNumber`).
 		// Since we are accepting objects, we treat NSNumber objects as doubles.
 		// If the object is not one of these types we treat it as a String.
-		for (NSString *key in [properties allKeys]) {
+		for (NSString *key in properties) {
+			// Properties are normally trimmed to the budget, by priority, by the delivery plan. Don't sanitize any which would be discarded anyway.
+			if (examinedCount >= parameterBudget) {
+				[self recordDroppedProperties:properties.count - examinedCount];
+				break;
+			}
+			++examinedCount;
+			
+			NSString *sanitizedKey = GRKAppCenterCroppedString(key, kGRKAppCenterMaximumPropertyLength);
 			id value = properties[key];
 			if ([value isKindOfClass:NSNumber.class]) {
-				[msProperties setDouble:[value doubleValue] forKey:key];
+				[msProperties setDouble:[value doubleValue] forKey:sanitizedKey];
 			}
 			else if ([value isKindOfClass:NSDate.class]) {
-				[msProperties setDate:value forKey:key];
+				[msProperties setDate:value forKey:sanitizedKey];
 			}
 			else {
-				NSString *stringValue = nil;
-				if ([value isKindOfClass:NSString.class]) {
-					stringValue = value;
-				}
-				else {
-					stringValue = [value description];
-				}
-				
-				[msProperties setString:stringValue forKey:key];
+				[msProperties setString:GRKAppCenterBoundedDescription(value, kGRKAppCenterMaximumPropertyLength) forKey:sanitizedKey];
 			}
 		}
 	}
@@ -12,6 +12,7 @@
 //
 
 #import "GRKFabricProvider.h"
+#import "GRKOverlayDictionary.h"
 
 #ifdef GRK_ANALYTICS_ENABLED
 
@@ -84,9 +85,7 @@ NS_ASSUME_NONNULL_BEGIN
         
 		if (category.length > 0 && !properties[self.categoryPropertyName])
         {
-            GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *mutableProperties = [properties mutableCopy];
-			mutableProperties[self.categoryPropertyName] = category;
-            properties = mutableProperties;
+            properties = [GRKOverlayDictionary dictionaryWithBase:properties object:category forKey:self.categoryPropertyName];
         }
         
         [Answers logCustomEventWithName:event customAttributes:properties];
@@ -128,9 +127,7 @@ NS_ASSUME_NONNULL_BEGIN
     
     if (category.length > 0)
     {
-        GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *mutableProperties = [properties mutableCopy];
-		mutableProperties[self.categoryPropertyName] = category;
-        properties = mutableProperties;
+        properties = [GRKOverlayDictionary dictionaryWithBase:properties object:category forKey:self.categoryPropertyName];
     }
     
     [Answers logPurchaseWithPrice:price currency:currency success:success itemName:itemName itemType:itemType itemId:identifier customAttributes:properties];
@@ -16,6 +16,10 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ A provider for Firebase Analytics.
+ Firebase logs at most 25 parameters with an event, so `parameterBudget` defaults to `25`; set `parameterPriorityKeys` to choose which properties are kept.
+ */
 @interface GRKFirebaseProvider : GRKAnalyticsProvider
 
 /**
@@ -29,6 +33,7 @@ NS_ASSUME_NONNULL_BEGIN
  @param config A Dictionary containing all the keys and values used by Firebase for its configuration.
  This should be the entire content of the `GoogleService-Info.plist` file.
  If `nil`, Firebase will not be configured, and it is assumed to have been configured directly.
+ The `FIROptions` are built directly from the dictionary. Only a configuration with keys which `FIROptions` can not be given directly (such as `IS_ANALYTICS_ENABLED` set to `NO`) is written to a temporary file and read back, and the file is removed afterwards.
  @return A new instance, with Firebase configured as specified. This can return `nil` if a non-nill configuration was given but initialization failed.
  */
 - (nullable instancetype)initWithConfiguration:(nullable NSDictionary *)config NS_DESIGNATED_INITIALIZER;
@@ -12,6 +12,7 @@
 //
 
 #import "GRKFirebaseProvider.h"
+#import "GRKOverlayDictionary.h"
 
 #ifdef GRK_ANALYTICS_ENABLED
 
@@ -22,6 +23,217 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+#ifdef GRK_ANALYTICS_ENABLED
+
+// Firebase logs at most this many parameters with an event, and silently discards the rest.
+static NSUInteger const kGRKFirebaseParameterBudget = 25;
+// The leading run of a string examined a word at a time is copied to the stack when the string does not expose its bytes.
+static NSUInteger const kGRKFirebaseSanitizeStackLength = 128;
+static char const * const kGRKFirebaseReservedPrefixes[] = {"firebase_", "google_", "ga_"};
+
+static uint64_t const kGRKFirebaseByteOnes = 0x0101010101010101ULL;
+static uint64_t const kGRKFirebaseByteHighs = 0x8080808080808080ULL;
+
+// For each byte of the word (all of which must be below 0x80), sets the high bit of the byte if it is within [low, high].
+static inline uint64_t GRKFirebaseBytesInRange(uint64_t word, uint8_t low, uint8_t high)
+{
+	return (word + kGRKFirebaseByteOnes * (uint8_t)(0x80 - low)) & ~(word + kGRKFirebaseByteOnes * (uint8_t)(0x7F - high)) & kGRKFirebaseByteHighs;
+}
+
+static inline BOOL GRKFirebaseIsLetter(unichar c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static inline BOOL GRKFirebaseIsNameCharacter(unichar c)
+{
+	return GRKFirebaseIsLetter(c) || (c >= '0' && c <= '9') || c == '_';
+}
+
+static BOOL GRKFirebaseIsWhitespace(unichar c)
+{
+	if (c < 0x80) {
+		return c == ' ' || (c >= '\t' && c <= '\r');
+	}
+
+	static NSCharacterSet *whitespace = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		whitespace = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+	});
+
+	return [whitespace characterIsMember:c];
+}
+
+// Whether a character is passed through unchanged: a name character for names, anything but whitespace and control characters for values.
+static inline BOOL GRKFirebaseIsPlainByte(uint8_t c, BOOL name)
+{
+	return name ? GRKFirebaseIsNameCharacter(c) : (c > ' ' && c < 0x7F);
+}
+
+// Returns the number of leading ASCII bytes which are passed through unchanged, examining eight at a time.
+static NSUInteger GRKFirebasePlainPrefixLength(const uint8_t *bytes, NSUInteger length, BOOL name)
+{
+	NSUInteger index = 0;
+
+	for (; index + sizeof(uint64_t) <= length; index += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, bytes + index, sizeof(word));
+		if (word & kGRKFirebaseByteHighs) {
+			break;
+		}
+
+		uint64_t plain;
+		if (name) {
+			plain = GRKFirebaseBytesInRange(word, 'a', 'z') | GRKFirebaseBytesInRange(word, 'A', 'Z') | GRKFirebaseBytesInRange(word, '0', '9') | GRKFirebaseBytesInRange(word, '_', '_');
+		}
+		else {
+			plain = GRKFirebaseBytesInRange(word, '!', '~');
+		}
+		if (plain != kGRKFirebaseByteHighs) {
+			break;
+		}
+	}
+
+	for (; index < length && GRKFirebaseIsPlainByte(bytes[index], name); ++index) {
+		// Finish byte by byte.
+	}
+
+	return index;
+}
+
+// Whether the given characters begin with a reserved prefix, considering only prefixes of exactly `length` characters if `exact`.
+static BOOL GRKFirebaseHasReservedPrefix(const unichar *characters, const uint8_t *bytes, NSUInteger length, BOOL exact)
+{
+	for (size_t i = 0; i < sizeof(kGRKFirebaseReservedPrefixes) / sizeof(kGRKFirebaseReservedPrefixes[0]); ++i) {
+		const char *prefix = kGRKFirebaseReservedPrefixes[i];
+		size_t prefixLength = strlen(prefix);
+		if (exact ? prefixLength != length : prefixLength > length) {
+			continue;
+		}
+
+		BOOL match = YES;
+		for (size_t j = 0; j < prefixLength && match; ++j) {
+			unichar c = characters ? characters[j] : bytes[j];
+			match = c < 0x80 && tolower(c) == prefix[j];
+		}
+		if (match) {
+			return YES;
+		}
+	}
+
+	return NO;
+}
+
+/*
+ Sanitizes a string in a single pass.
+ Runs of whitespace become a single "_", and leading and trailing whitespace is removed. The result is cropped to `maxLength`.
+ For names, characters other than [A-Za-z0-9_] are also removed, as are leading characters until a letter, and the reserved prefixes.
+ If nothing needs to change the given string is returned, and nothing is allocated.
+ */
+static NSString * _Nullable GRKFirebaseSanitize(NSString *string, NSUInteger maxLength, BOOL name)
+{
+	CFStringRef cfString = (__bridge CFStringRef)string;
+	NSUInteger length = (NSUInteger)CFStringGetLength(cfString);
+	if (length == 0) {
+		return name ? nil : string;
+	}
+	NSUInteger capacity = MIN(length, maxLength);
+
+	// Find the leading run of ASCII characters which pass through unchanged, a word at a time.
+	uint8_t stackBytes[kGRKFirebaseSanitizeStackLength];
+	NSUInteger byteLength = MIN(length, maxLength + 1);
+	const uint8_t *bytes = (const uint8_t *)CFStringGetCStringPtr(cfString, kCFStringEncodingASCII);
+	if (!bytes) {
+		// Converts up to the first character which is not ASCII.
+		byteLength = (NSUInteger)CFStringGetBytes(cfString, CFRangeMake(0, (CFIndex)MIN(byteLength, kGRKFirebaseSanitizeStackLength)), kCFStringEncodingASCII, 0, false, stackBytes, sizeof(stackBytes), NULL);
+		bytes = stackBytes;
+	}
+	NSUInteger prefix = GRKFirebasePlainPrefixLength(bytes, byteLength, name);
+	BOOL validHead = !name || (prefix > 0 && GRKFirebaseIsLetter(bytes[0]) && !GRKFirebaseHasReservedPrefix(NULL, bytes, prefix, NO));
+
+	if (validHead && prefix == length && length <= maxLength) {
+		return string;
+	}
+
+	unichar stackBuffer[kGRKFirebaseSanitizeStackLength];
+	unichar *buffer = capacity <= kGRKFirebaseSanitizeStackLength ? stackBuffer : malloc(capacity * sizeof(unichar));
+
+	// Keep the unchanged run, and carry on from where it ends.
+	NSUInteger count = 0;
+	if (validHead) {
+		count = MIN(prefix, capacity);
+		for (NSUInteger i = 0; i < count; ++i) {
+			buffer[i] = bytes[i];
+		}
+	}
+
+	BOOL changed = NO;
+	BOOL separator = NO;
+	CFStringInlineBuffer inlineBuffer;
+	CFStringInitInlineBuffer(cfString, &inlineBuffer, CFRangeMake(0, (CFIndex)length));
+	for (NSUInteger index = count; index < length; ++index) {
+		unichar c = CFStringGetCharacterFromInlineBuffer(&inlineBuffer, (CFIndex)index);
+
+		if (GRKFirebaseIsWhitespace(c)) {
+			// Leading whitespace is dropped, and a run of whitespace becomes a single separator.
+			separator = count > 0;
+			changed = YES;
+			continue;
+		}
+		if (name && !GRKFirebaseIsNameCharacter(c)) {
+			changed = YES;
+			continue;
+		}
+
+		if (separator) {
+			separator = NO;
+			if (count == capacity) {
+				changed = YES;
+				break;
+			}
+			buffer[count++] = '_';
+			if (name && GRKFirebaseHasReservedPrefix(buffer, NULL, count, YES)) {
+				count = 0;
+			}
+		}
+
+		if (name && count == 0 && !GRKFirebaseIsLetter(c)) {
+			changed = YES;
+			continue;
+		}
+		if (count == capacity) {
+			changed = YES;
+			break;
+		}
+
+		buffer[count++] = c;
+		// A reserved prefix always ends with "_", so it only needs checking as each "_" is added.
+		if (name && c == '_' && GRKFirebaseHasReservedPrefix(buffer, NULL, count, YES)) {
+			count = 0;
+			changed = YES;
+		}
+	}
+
+	// Don't crop in the middle of a surrogate pair.
+	if (count == capacity && count > 0 && count < length && CFStringIsSurrogateHighCharacter(buffer[count - 1])) {
+		--count;
+		changed = YES;
+	}
+
+	NSString *retVal = string;
+	if (changed || count < length) {
+		retVal = count > 0 ? [[NSString alloc] initWithCharacters:buffer length:count] : (name ? nil : @"");
+	}
+	if (buffer != stackBuffer) {
+		free(buffer);
+	}
+
+	return retVal;
+}
+
+#endif //GRK_ANALYTICS_ENABLED
+
 @implementation GRKFirebaseProvider
 
 #pragma mark - Lifecycle
@@ -34,28 +246,16 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable instancetype)initWithConfiguration:(nullable NSDictionary *)config
 {
 	if ((self = [super init])) {
+		_firebaseConfiguration = [config copy] ?: @{};
+		self.parameterBudget = kGRKFirebaseParameterBudget;
 #ifdef GRK_ANALYTICS_ENABLED
 	
 		BOOL success = NO;
 		if (config) {
-			// Write out the configuration to a temporary file, so we can use `FIROptions -initWithContentsOfFile:` to be more future-proof.
-			NSURL *directoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSProcessInfo processInfo] globallyUniqueString]] isDirectory:YES];
-			__autoreleasing NSError *error = nil;
-			if ([[NSFileManager defaultManager] createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:nil error:&error])
-			{
-				NSURL *fileURL = [directoryURL URLByAppendingPathComponent:[NSString stringWithFormat:@"%@", [[NSProcessInfo processInfo] globallyUniqueString]]];
-				error = nil;
-				NSData *configData = [NSPropertyListSerialization dataWithPropertyList:config format:NSPropertyListXMLFormat_v1_0 options:NSPropertyListImmutable error:&error];
-				if (configData) {
-					error = nil;
-					if ([configData writeToURL:fileURL options:NSDataWritingAtomic | NSDataWritingFileProtectionComplete error:&error]) {
-						FIROptions *firOptions = [[FIROptions alloc] initWithContentsOfFile:fileURL.path];
-						if (firOptions) {
-							[FIRApp configureWithOptions:firOptions];
-							success = YES;
-						}
-					}
-				}
+			FIROptions *firOptions = [self.class optionsWithConfiguration:config] ?: [self.class optionsFromFileWithConfiguration:config];
+			if (firOptions) {
+				[FIRApp configureWithOptions:firOptions];
+				success = YES;
 			}
 		}
 		else {
@@ -73,6 +273,110 @@ NS_ASSUME_NONNULL_BEGIN
 
 #ifdef GRK_ANALYTICS_ENABLED
 
+#pragma mark - Configuration
+
+// `GoogleService-Info.plist` key -> `FIROptions` property, for the keys which can be set directly.
++ (NSDictionary<NSString *, NSString *> *)optionsPropertiesByKey
+{
+	static NSDictionary<NSString *, NSString *> *optionsPropertiesByKey = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		optionsPropertiesByKey = @{
+			@"API_KEY": NSStringFromSelector(@selector(APIKey)),
+			@"BUNDLE_ID": NSStringFromSelector(@selector(bundleID)),
+			@"CLIENT_ID": NSStringFromSelector(@selector(clientID)),
+			@"TRACKING_ID": NSStringFromSelector(@selector(trackingID)),
+			@"PROJECT_ID": NSStringFromSelector(@selector(projectID)),
+			@"ANDROID_CLIENT_ID": NSStringFromSelector(@selector(androidClientID)),
+			@"DATABASE_URL": NSStringFromSelector(@selector(databaseURL)),
+			@"STORAGE_BUCKET": NSStringFromSelector(@selector(storageBucket)),
+		};
+	});
+
+	return optionsPropertiesByKey;
+}
+
+// Keys `FIROptions` reads from a file without changing the behavior of analytics (or which are set by `-initWithGoogleAppID:GCMSenderID:`).
++ (NSSet<NSString *> *)optionsIgnoredKeys
+{
+	static NSSet<NSString *> *optionsIgnoredKeys = nil;
+	static dispatch_once_t onceToken;
+	dispatch_once(&onceToken, ^{
+		optionsIgnoredKeys = [NSSet setWithArray:@[@"GOOGLE_APP_ID", @"GCM_SENDER_ID", @"PLIST_VERSION", @"REVERSED_CLIENT_ID", @"IS_ADS_ENABLED", @"IS_APPINVITE_ENABLED", @"IS_GCM_ENABLED", @"IS_SIGNIN_ENABLED"]];
+	});
+
+	return optionsIgnoredKeys;
+}
+
+/**
+ Builds options straight from the configuration, without touching the disk.
+
+ @param config The configuration.
+ @return The options, or `nil` if the configuration has keys which can only be applied by reading it from a file.
+ */
++ (nullable FIROptions *)optionsWithConfiguration:(NSDictionary *)config
+{
+	NSString *googleAppID = config[@"GOOGLE_APP_ID"];
+	NSString *senderID = config[@"GCM_SENDER_ID"];
+	if (![googleAppID isKindOfClass:NSString.class] || ![senderID isKindOfClass:NSString.class]) {
+		return nil;
+	}
+
+	NSDictionary<NSString *, NSString *> *propertiesByKey = [self optionsPropertiesByKey];
+	NSSet<NSString *> *ignoredKeys = [self optionsIgnoredKeys];
+	for (NSString *key in config) {
+		id value = config[key];
+		BOOL mapped = propertiesByKey[key] && [value isKindOfClass:NSString.class];
+		// Analytics is enabled unless the configuration says otherwise, so only a `NO` needs the file.
+		BOOL ignored = [ignoredKeys containsObject:key] || ([key isEqualToString:@"IS_ANALYTICS_ENABLED"] && [value respondsToSelector:@selector(boolValue)] && [value boolValue]);
+		if (!mapped && !ignored) {
+			return nil;
+		}
+	}
+
+	FIROptions *firOptions = [[FIROptions alloc] initWithGoogleAppID:googleAppID GCMSenderID:senderID];
+	[propertiesByKey enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *property, BOOL *stop) {
+		NSString *value = config[key];
+		if (value) {
+			[firOptions setValue:value forKey:property];
+		}
+	}];
+
+	return firOptions;
+}
+
+/**
+ Builds options by writing the configuration to a temporary file, and reading it back with `FIROptions -initWithContentsOfFile:`, so keys without a `FIROptions` property are still honored. The file is removed once read.
+
+ @param config The configuration.
+ @return The options, or `nil` if the file could not be written or read.
+ */
++ (nullable FIROptions *)optionsFromFileWithConfiguration:(NSDictionary *)config
+{
+	FIROptions *firOptions = nil;
+	NSURL *directoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSProcessInfo processInfo] globallyUniqueString]] isDirectory:YES];
+	__autoreleasing NSError *error = nil;
+	if ([[NSFileManager defaultManager] createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:nil error:&error])
+	{
+		NSURL *fileURL = [directoryURL URLByAppendingPathComponent:[NSString stringWithFormat:@"%@", [[NSProcessInfo processInfo] globallyUniqueString]]];
+		error = nil;
+		NSData *configData = [NSPropertyListSerialization dataWithPropertyList:config format:NSPropertyListXMLFormat_v1_0 options:NSPropertyListImmutable error:&error];
+		if (configData) {
+			error = nil;
+			if ([configData writeToURL:fileURL options:NSDataWritingAtomic | NSDataWritingFileProtectionComplete error:&error]) {
+				firOptions = [[FIROptions alloc] initWithContentsOfFile:fileURL.path];
+			}
+		}
+		[[NSFileManager defaultManager] removeItemAtURL:directoryURL error:NULL];
+	}
+
+	return firOptions;
+}
+
+#endif //GRK_ANALYTICS_ENABLED
+
+#ifdef GRK_ANALYTICS_ENABLED
+
 - (void)setEnabled:(BOOL)enabled
 {
 	[super setEnabled:enabled];
@@ -101,7 +405,7 @@ NS_ASSUME_NONNULL_BEGIN
 	// The name of the user property to set. Should contain 1 to 24 alphanumeric characters
 	// or underscores and must start with an alphabetic character. The "firebase_", "google_", and
 	// "ga_" prefixes are reserved and should not be used for user property names.
-	NSString *sanitizedName = [self sanitizeString:property maxLength:24];
+	NSString *sanitizedName = [self sanitizeName:property maxLength:24];
 	if (sanitizedName.length > 0) {
 		// Values can be up to 36 characters long. Setting the value to nil removes the user property.
 		NSString *sanitizedValue = [self cropString:[value description] maxLength:36];
@@ -116,24 +420,17 @@ NS_ASSUME_NONNULL_BEGIN
 		  category:(nullable NSString *)category
 		properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
 {
-	event = [self delegateEventForEvent:event];
-
-	// The name of the event. Should contain 1 to 40 alphanumeric characters or
-	// underscores. The name must start with an alphabetic character. Some event names are
-	// reserved. See FIREventNames.h for the list of reserved event names. The "firebase_",
-	// "google_", and "ga_" prefixes are reserved and should not be used. Note that event names are
-	// case-sensitive and that logging two events whose names differ only in case will result in
-	// two distinct events.
-	NSString *sanitizedEvent = [self sanitizeString:event maxLength:40];
+	BOOL addsCategory = category.length > 0 && !properties[self.categoryPropertyName];
+	GRKDeliveryPlan *plan = [self deliveryPlanForEvent:event properties:properties reservedParameterCount:addsCategory ? 1 : 0];
+	NSString *sanitizedEvent = plan.event;
 	if (sanitizedEvent.length > 0)
 	{
-		properties = [self delegatePropertiesForProperties:properties];
+		properties = [plan propertiesForProperties:properties];
+		[self recordDroppedProperties:plan.droppedPropertyCount];
 		
-		if (category.length > 0 && !properties[self.categoryPropertyName])
+		if (addsCategory && !properties[self.categoryPropertyName])
 		{
-			GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *mutableProperties = [properties mutableCopy];
-			mutableProperties[self.categoryPropertyName] = category;
-			properties = mutableProperties;
+			properties = [GRKOverlayDictionary dictionaryWithBase:properties object:category forKey:self.categoryPropertyName];
 		}
 
 		NSDictionary<NSString *, id> *sanitizedProperties = [self sanitizeProperties:properties];
@@ -155,13 +452,13 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	[self setUserProperty:kFIRUserPropertySignUpMethod toValue:method];
 
-	properties = [self delegatePropertiesForProperties:properties];
+	GRKDeliveryPlan *plan = [self deliveryPlanForEvent:kFIREventSignUp properties:properties reservedParameterCount:success != nil ? 1 : 0];
+	properties = [plan propertiesForProperties:properties];
+	[self recordDroppedProperties:plan.droppedPropertyCount];
 
 	if (success != nil)
 	{
-		GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *mutableProperties = [properties mutableCopy];
-		mutableProperties[self.successPropertyName] = success;
-		properties = mutableProperties;
+		properties = [GRKOverlayDictionary dictionaryWithBase:properties object:success forKey:self.successPropertyName];
 	}
 
 	NSDictionary<NSString *, id> *sanitizedProperties = [self sanitizeProperties:properties];
@@ -174,13 +471,13 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	[self setUserProperty:kFIRUserPropertySignUpMethod toValue:method];
 	
-	properties = [self delegatePropertiesForProperties:properties];
+	GRKDeliveryPlan *plan = [self deliveryPlanForEvent:kFIREventLogin properties:properties reservedParameterCount:success != nil ? 1 : 0];
+	properties = [plan propertiesForProperties:properties];
+	[self recordDroppedProperties:plan.droppedPropertyCount];
 
 	if (success != nil)
 	{
-		GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) *mutableProperties = [properties mutableCopy];
-		mutableProperties[self.successPropertyName] = success;
-		properties = mutableProperties;
+		properties = [GRKOverlayDictionary dictionaryWithBase:properties object:success forKey:self.successPropertyName];
 	}
 
 	NSDictionary<NSString *, id> *sanitizedProperties = [self sanitizeProperties:properties];
@@ -216,17 +513,27 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark - Helpers
 
-- (nullable NSString *)sanitizeString:(nullable NSString *)key maxLength:(NSUInteger)maxLength
+// The name of the event. Should contain 1 to 40 alphanumeric characters or
+// underscores. The name must start with an alphabetic character. Some event names are
+// reserved. See FIREventNames.h for the list of reserved event names. The "firebase_",
+// "google_", and "ga_" prefixes are reserved and should not be used. Note that event names are
+// case-sensitive and that logging two events whose names differ only in case will result in
+// two distinct events.
+- (nullable NSString *)sanitizedEventForEvent:(NSString *)event
 {
-	NSString *retVal = nil;
-	
-	if (key) {
-		NSMutableArray *components = [NSMutableArray arrayWithArray:[key componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]]];
-		[components removeObjectsInArray:@[@""]];
-		retVal = [components componentsJoinedByString:@"_"];
-		retVal = [self cropString:retVal maxLength:maxLength];
-	}
-	return retVal;
+	return [self sanitizeName:event maxLength:40];
+}
+
+// Names of events, parameters and user properties must start with an alphabetic character, contain only
+// alphanumeric characters and underscores, and not use the reserved prefixes.
+- (nullable NSString *)sanitizeName:(nullable NSString *)name maxLength:(NSUInteger)maxLength
+{
+	return name ? GRKFirebaseSanitize(name, maxLength, YES) : nil;
+}
+
+- (nullable NSString *)sanitizeString:(nullable NSString *)string maxLength:(NSUInteger)maxLength
+{
+	return string ? GRKFirebaseSanitize(string, maxLength, NO) : nil;
 }
 
 // The dictionary of event parameters. Passing nil indicates that the event has
@@ -241,8 +548,17 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	if (properties) {
 		retVal = [GRK_GENERIC_NSMUTABLEDICTIONARY(NSString *, id) dictionary];
+		NSUInteger parameterBudget = self.parameterBudget;
+		NSUInteger examinedCount = 0;
 		
-		for (NSString *key in [properties allKeys]) {
+		for (NSString *key in properties) {
+			// Properties are normally trimmed to the budget by the delivery plan, but don't sanitize any which would be discarded anyway.
+			if (retVal.count >= parameterBudget) {
+				[self recordDroppedProperties:properties.count - examinedCount];
+				break;
+			}
+			++examinedCount;
+			
 			id sanitizedValue = nil;
 			
 			id value = properties[key];
@@ -254,7 +570,7 @@ NS_ASSUME_NONNULL_BEGIN
 			}
 			
 			if (sanitizedValue) {
-				NSString *sanitizedKey = [self sanitizeString:key maxLength:40];
+				NSString *sanitizedKey = [self sanitizeName:key maxLength:40];
 				if (sanitizedKey) {
 					retVal[sanitizedKey] = sanitizedValue;
 				}
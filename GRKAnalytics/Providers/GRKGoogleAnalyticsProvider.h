@@ -44,14 +44,35 @@ extern NSString * const kGRKPurchaseEventDefaultCategory;
  *
  * @return An initialized instance of the provider which can be passed to `GRKAnalytics addProvider:` class method. 
  */
-- (instancetype)initWithTrackingID:(nullable NSString *)trackingID NS_DESIGNATED_INITIALIZER;
+- (instancetype)initWithTrackingID:(nullable NSString *)trackingID;
+
+/**
+ * Initialize a provider which sends to several Google Analytics properties.
+ * Each hit is built once and sent to every tracker, so the cost of tracking does not grow with the number of properties.
+ * Typical usage would be something like `[GRKGoogleAnalyticsProvider alloc] initWithTrackingIDs:@[@"UA-xxxxx-y", @"UA-xxxxx-z"]]`
+ *
+ * @param trackingIDs The tracking IDs provided by Google Analytics which identify the properties. If `nil` or empty the `[[GAI sharedInstance] defaultTracker]` will be used, and should be initialized prior to creating this provider.
+ *
+ * @return An initialized instance of the provider which can be passed to `GRKAnalytics addProvider:` class method.
+ * @see setFields:forTrackingID:
+ */
+- (instancetype)initWithTrackingIDs:(nullable GRK_GENERIC_NSARRAY(NSString *) *)trackingIDs NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Sets fields to be sent with every hit to one tracker only, taking precedence over the fields of the hit.
+ * For example, a custom dimension whose index differs between properties, or a different `kGAIAppName`.
+ *
+ * @param fields     The fields, keyed by GAI field name. If `nil` or empty the tracker's fields are removed.
+ * @param trackingID The tracking ID of the tracker.
+ */
+- (void)setFields:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)fields forTrackingID:(NSString *)trackingID;
 
 /**
  * This is overridden from `GRKAnalyticsProvider`.
  * Google Analytic events have four parameters, typically: Category, Action, Label, Value.
  * @param event The "Action" of the Google Event.
  * @param category The "Category" of the Google Event. If `nil` the default `kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory` category will be assumed.
- * @param properties Additional properties to associate with the event. This will find the first key:value pair in the given `properties` dictionary whose value is an NSNumber object, using the key as the "Label" and the value as the "Value". Additionally, properties whose keys match keys in `customDimensionKeys` or `customMetricKeys` will be associated appropriately. NOTE: Google Analytics does not provide a mechanism for associating arbitrary properties, so any unbound properties will be ignored.
+ * @param properties Additional properties to associate with the event. This will find a key:value pair in the given `properties` dictionary whose value is an NSNumber object (see `labelValueKeys`), using the key as the "Label" and the value as the "Value". Additionally, properties whose keys match keys in `customDimensionKeys` or `customMetricKeys` will be associated appropriately. NOTE: Google Analytics does not provide a mechanism for associating arbitrary properties, so any unbound properties will be ignored.
  */
 - (void)trackEvent:(NSString *)event
           category:(nullable NSString *)category
@@ -60,7 +81,7 @@ extern NSString * const kGRKPurchaseEventDefaultCategory;
 /**
  * This is overridden from `GRKAnalyticsProvider`.
  * @param success If `YES` a Transaction and Item will be created and sent. If `NO` a generic `kGRKEventPurchaseFailure` event will be sent. 
- * @param properties Additional properties to associate with the event. This will find the first key:value pair in the given `properties` dictionary whose value is an NSNumber object, ignoring the key, the value will be used for the quantity of items in the purchase. The given price should be the individual item price. Additionally, properties whose keys match keys in `customDimensionKeys` or `customMetricKeys` will be associated appropriately. NOTE: Google Analytics does not provide a mechanism for associating arbitrary properties, so any unbound properties will be ignored.
+ * @param properties Additional properties to associate with the event. This will find a key:value pair in the given `properties` dictionary whose value is an NSNumber object (see `labelValueKeys`), ignoring the key, the value will be used for the quantity of items in the purchase. The given price should be the individual item price. Additionally, properties whose keys match keys in `customDimensionKeys` or `customMetricKeys` will be associated appropriately. NOTE: Google Analytics does not provide a mechanism for associating arbitrary properties, so any unbound properties will be ignored.
  */
 - (void)trackPurchaseInCategory:(nullable NSString *)category
                           price:(nullable NSDecimalNumber *)price
@@ -75,7 +96,7 @@ extern NSString * const kGRKPurchaseEventDefaultCategory;
  * This is overridden from `GRKAnalyticsProvider`.
  * Creates a "Screen View"
  * @param name Used as the kGAIScreenName
- * @param properties Additional properties to associate with the event. This will find the first key:value pair in the given `properties` dictionary whose value is an NSNumber object, using the key as the "kGAIEventLabel", the value will be ignored. The given price should be the individual item price. Additionally, properties whose keys match keys in `customDimensionKeys` or `customMetricKeys` will be associated appropriately. NOTE: Google Analytics does not provide a mechanism for associating arbitrary properties, so any unbound properties will be ignored.
+ * @param properties Additional properties to associate with the event. This will find a key:value pair in the given `properties` dictionary whose value is an NSNumber object (see `labelValueKeys`), using the key as the "kGAIEventLabel", the value will be ignored. The given price should be the individual item price. Additionally, properties whose keys match keys in `customDimensionKeys` or `customMetricKeys` will be associated appropriately. NOTE: Google Analytics does not provide a mechanism for associating arbitrary properties, so any unbound properties will be ignored.
  */
 - (void)trackContentViewWithName:(nullable NSString *)name
                      contentType:(nullable NSString *)type
@@ -100,6 +121,21 @@ extern NSString * const kGRKPurchaseEventDefaultCategory;
  */
 @property (nonatomic, strong) NSOrderedSet *customMetricKeys;
 
+/**
+ * Property keys to use, in order of priority, for the "Label" and "Value" of hits.
+ * The first of these keys found in the `properties` of a tracking call with an NSNumber value is used, the key as the "Label" and the value as the "Value".
+ * A key designated for the event with `setLabelValueKey:forEvent:` takes precedence over these. If none of the keys are found, the NSNumber property with the lexicographically smallest key is used.
+ */
+@property (atomic, copy, nullable) GRK_GENERIC_NSARRAY(NSString *) *labelValueKeys;
+
+/**
+ * Designates the property key to use for the "Label" and "Value" of hits for the given event.
+ *
+ * @param key   The property key whose NSNumber value should be used. If `nil` the designation is removed.
+ * @param event The event name (the "Action" of the Google Event, or the screen name of a content view).
+ */
+- (void)setLabelValueKey:(nullable NSString *)key forEvent:(NSString *)event;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -12,6 +12,8 @@
 //
 
 #import "GRKGoogleAnalyticsProvider.h"
+#import "GRKLayeredDictionary.h"
+#import "GRKFlushScheduler.h"
 
 #ifdef GRK_ANALYTICS_ENABLED
 
@@ -26,6 +28,13 @@ static CGFloat const kGRKPurchaseAppleTax = 0.3f;
 
 NS_ASSUME_NONNULL_BEGIN
 
+#ifdef GRK_ANALYTICS_ENABLED
+
+@interface GRKGoogleAnalyticsProvider () <GRKFlushable>
+@end
+
+#endif //GRK_ANALYTICS_ENABLED
+
 NSString * const kGRKUserEventCategory = @"User";
 NSString * const kGRKEventUserAccountCreated = @"UserAccountCreated";
 NSString * const kGRKEventUserLogin = @"UserLogin";
@@ -40,11 +49,19 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
 
 #ifdef GRK_ANALYTICS_ENABLED
 
-@property (nonatomic, strong) id <GAITracker>tracker;
+// The trackers, and the tracking ID of each, in the same order.
+@property (nonatomic, copy) NSArray<id<GAITracker>> *trackers;
+@property (nonatomic, copy) NSArray<NSString *> *trackingIDs;
 
 #endif //GRK_ANALYTICS_ENABLED
 
-@property(nonatomic, copy) void (^dispatchHandler)(NSUInteger result);
+// Tracking ID -> fields sent only to that tracker.
+@property (atomic, copy) GRK_GENERIC_NSDICTIONARY(NSString *, NSDictionary *) *trackerFields;
+// Event name -> the property key designated for its label and value.
+@property (atomic, copy) GRK_GENERIC_NSDICTIONARY(NSString *, NSString *) *eventLabelValueKeys;
+// Property key -> GAI field name, compiled from `customDimensionKeys` and `customMetricKeys` as they are set.
+@property (atomic, copy) GRK_GENERIC_NSDICTIONARY(NSString *, NSString *) *customDimensionFields;
+@property (atomic, copy) GRK_GENERIC_NSDICTIONARY(NSString *, NSString *) *customMetricFields;
 
 @end
 
@@ -54,6 +71,9 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
 - (void)dealloc
 {
     [[NSNotificationCenter defaultCenter] removeObserver:self];
+#ifdef GRK_ANALYTICS_ENABLED
+    [[GRKFlushScheduler sharedScheduler] unregisterFlushable:self];
+#endif //GRK_ANALYTICS_ENABLED
 }
 
 - (instancetype)init
@@ -62,6 +82,11 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
 }
 
 - (instancetype)initWithTrackingID:(nullable NSString *)trackingID
+{
+    return [self initWithTrackingIDs:trackingID.length > 0 ? @[trackingID] : nil];
+}
+
+- (instancetype)initWithTrackingIDs:(nullable GRK_GENERIC_NSARRAY(NSString *) *)trackingIDs
 {
 #ifdef GRK_ANALYTICS_ENABLED
 
@@ -70,16 +95,33 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
     
     if ((self = [super init]))
     {
-        if (trackingID.length > 0)
+        NSMutableArray *trackers = [NSMutableArray array];
+        NSMutableArray *resolvedTrackingIDs = [NSMutableArray array];
+        for (NSString *trackingID in [NSOrderedSet orderedSetWithArray:trackingIDs ?: @[]])
         {
-            _tracker = [[GAI sharedInstance] trackerWithTrackingId:trackingID];
+            id<GAITracker> tracker = [[GAI sharedInstance] trackerWithTrackingId:trackingID];
+            if (tracker)
+            {
+                [trackers addObject:tracker];
+                [resolvedTrackingIDs addObject:trackingID];
+            }
         }
-        else
+        
+        if (trackers.count == 0)
         {
-            _tracker = [[GAI sharedInstance] defaultTracker];
+            id<GAITracker> tracker = [[GAI sharedInstance] defaultTracker];
+            if (tracker)
+            {
+                [trackers addObject:tracker];
+                [resolvedTrackingIDs addObject:[tracker get:kGAITrackingId] ?: @""];
+            }
         }
         
+        _trackers = trackers;
+        _trackingIDs = resolvedTrackingIDs;
+        
         [self registerNotifications];
+        [[GRKFlushScheduler sharedScheduler] registerFlushable:self];
     }
 
     return self;
@@ -92,6 +134,36 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
 
 }
 
+#pragma mark - Trackers
+
+- (void)setFields:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)fields forTrackingID:(NSString *)trackingID
+{
+    if (trackingID)
+    {
+        @synchronized (self)
+        {
+            NSMutableDictionary *trackerFields = [NSMutableDictionary dictionaryWithDictionary:self.trackerFields];
+            trackerFields[trackingID] = fields.count > 0 ? [fields copy] : nil;
+            self.trackerFields = trackerFields;
+        }
+    }
+}
+
+#pragma mark - Label and Value
+
+- (void)setLabelValueKey:(nullable NSString *)key forEvent:(NSString *)event
+{
+    if (event)
+    {
+        @synchronized (self)
+        {
+            NSMutableDictionary *eventLabelValueKeys = [NSMutableDictionary dictionaryWithDictionary:self.eventLabelValueKeys];
+            eventLabelValueKeys[event] = key;
+            self.eventLabelValueKeys = eventLabelValueKeys;
+        }
+    }
+}
+
 #ifdef GRK_ANALYTICS_ENABLED
 
 #pragma mark - Meta
@@ -114,6 +186,22 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
     [[GAI sharedInstance] setDispatchInterval:dispatchInterval];
 }
 
+- (void)setCustomDimensionKeys:(NSOrderedSet *)customDimensionKeys
+{
+    _customDimensionKeys = customDimensionKeys;
+    self.customDimensionFields = [self fieldsForKeys:customDimensionKeys fieldName:^NSString *(NSUInteger index) {
+        return [GAIFields customDimensionForIndex:index];
+    }];
+}
+
+- (void)setCustomMetricKeys:(NSOrderedSet *)customMetricKeys
+{
+    _customMetricKeys = customMetricKeys;
+    self.customMetricFields = [self fieldsForKeys:customMetricKeys fieldName:^NSString *(NSUInteger index) {
+        return [GAIFields customMetricForIndex:index];
+    }];
+}
+
 #pragma mark - User
 
 #pragma mark User Identity
@@ -132,7 +220,11 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
 
 - (void)setUserProperty:(NSString *)property toValue:(nullable id)value
 {
-    [self.tracker set:property value:[value description]];
+    NSString *stringValue = [value description];
+    for (id<GAITracker> tracker in self.trackers)
+    {
+        [tracker set:property value:stringValue];
+    }
 }
 
 #pragma mark - Events
@@ -147,9 +239,9 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
         
         NSString *label = nil;
         NSNumber *value = nil;
-        [self extractLabel:&label andValue:&value fromProperties:properties];
+        NSDictionary *fields = [self fieldsFromProperties:properties event:event label:&label value:&value];
         GAIDictionaryBuilder *builder = [GAIDictionaryBuilder createEventWithCategory:category action:event label:label value:value];
-        properties = [self eventPropertiesWithBuilder:builder properties:properties];
+        properties = [self eventPropertiesWithBuilder:builder fields:fields];
 
         [self queue:properties];
     }
@@ -168,7 +260,7 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
                            properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
 {
     GAIDictionaryBuilder *builder = [GAIDictionaryBuilder createEventWithCategory:kGRKUserEventCategory action:kGRKEventUserAccountCreated label:kGRKUserEventLabelSuccess value:(success != nil && success.boolValue) ? @YES : @NO];
-    properties = [self eventPropertiesWithBuilder:builder properties:properties];
+    properties = [self eventPropertiesWithBuilder:builder fields:[self fieldsFromProperties:properties event:nil label:nil value:nil]];
     
     [self queue:properties];
 }
@@ -178,7 +270,7 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
                   properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
 {
     GAIDictionaryBuilder *builder = [GAIDictionaryBuilder createEventWithCategory:kGRKUserEventCategory action:kGRKEventUserLogin label:kGRKUserEventLabelSuccess value:(success != nil && success.boolValue) ? @YES : @NO];
-    properties = [self eventPropertiesWithBuilder:builder properties:properties];
+    properties = [self eventPropertiesWithBuilder:builder fields:[self fieldsFromProperties:properties event:nil label:nil value:nil]];
     
     [self queue:properties];
 }
@@ -194,7 +286,7 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
 {
     NSString *affiliation = category ?: kGRKPurchaseEventDefaultCategory;
     NSNumber *value = nil;
-    [self extractLabel:nil andValue:&value fromProperties:properties];
+    NSDictionary *fields = [self fieldsFromProperties:properties event:nil label:nil value:&value];
     NSNumber *quantity = value ?: @1;
 
     if (success != nil && success.boolValue)
@@ -212,7 +304,7 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
                                                                                              tax:tax
                                                                                         shipping:shipping
                                                                                     currencyCode:currency];
-        NSDictionary *transactionPoperties = [self eventPropertiesWithBuilder:transactionBuilder properties:properties];
+        NSDictionary *transactionPoperties = [self eventPropertiesWithBuilder:transactionBuilder fields:fields];
         [self queue:transactionPoperties];
         
         
@@ -223,13 +315,13 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
                                                                                         price:@(itemPrice)
                                                                                      quantity:quantity
                                                                                  currencyCode:currency];
-        NSDictionary *itemPoperties = [self eventPropertiesWithBuilder:itemBuilder properties:properties];
+        NSDictionary *itemPoperties = [self eventPropertiesWithBuilder:itemBuilder fields:fields];
         [self queue:itemPoperties];
     }
     else
     {
         GAIDictionaryBuilder *builder = [GAIDictionaryBuilder createEventWithCategory:affiliation action:kGRKEventPurchaseFailure label:identifier value:quantity];
-        properties = [self eventPropertiesWithBuilder:builder properties:properties];
+        properties = [self eventPropertiesWithBuilder:builder fields:fields];
         
         [self queue:properties];
     }
@@ -242,24 +334,24 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
 {
     if (name)
     {
-        [self.tracker set:kGAIScreenName value:name];
+        for (id<GAITracker> tracker in self.trackers)
+        {
+            [tracker set:kGAIScreenName value:name];
+        }
 
         NSString *label = nil;
+        NSDictionary *fields = [self fieldsFromProperties:properties event:name label:&label value:nil];
         if (identifier)
         {
             label = identifier;
         }
-        else
-        {
-            [self extractLabel:&label andValue:nil fromProperties:properties];
-        }
 
         GAIDictionaryBuilder *builder = [GAIDictionaryBuilder createScreenView];
         if (label) {
             [builder set:label forKey:kGAIEventLabel];
         }
     
-        properties = [self eventPropertiesWithBuilder:builder properties:properties];
+        properties = [self eventPropertiesWithBuilder:builder fields:fields];
         
         [self queue:properties];
 
@@ -278,9 +370,9 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
         category = category.length > 0 ? category : kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory;
         
         NSString *label = nil;
-        [self extractLabel:&label andValue:nil fromProperties:properties];
+        NSDictionary *fields = [self fieldsFromProperties:properties event:event label:&label value:nil];
         GAIDictionaryBuilder *builder = [GAIDictionaryBuilder createTimingWithCategory:category interval:@((int)(timeInterval * 1000)) name:event label:label];
-        properties = [self eventPropertiesWithBuilder:builder properties:properties];
+        properties = [self eventPropertiesWithBuilder:builder fields:fields];
         
         [self queue:properties];
     }
@@ -293,7 +385,7 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
     if (error)
     {
         GAIDictionaryBuilder *builder = [GAIDictionaryBuilder createExceptionWithDescription:[error description] withFatal:@NO];
-        properties = [self eventPropertiesWithBuilder:builder properties:properties];
+        properties = [self eventPropertiesWithBuilder:builder fields:[self fieldsFromProperties:properties event:nil label:nil value:nil]];
         
         [self queue:properties];
     }
@@ -305,78 +397,117 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
 {
     if (self.enabled && properies.count > 0)
     {
-        [self.tracker send:properies];
+        // The hit is built once and shared by every tracker, with only the fields of a tracker layered over it.
+        NSDictionary *hit = [properies copy];
+        NSDictionary *trackerFields = self.trackerFields;
+        NSArray<NSString *> *trackingIDs = self.trackingIDs;
+        [self.trackers enumerateObjectsUsingBlock:^(id<GAITracker> tracker, NSUInteger index, BOOL *stop) {
+            NSDictionary *fields = trackerFields[trackingIDs[index]];
+            [tracker send:fields ? [GRKLayeredDictionary dictionaryWithTop:fields base:hit] : hit];
+        }];
     }
 }
 
-- (NSDictionary *)eventPropertiesWithBuilder:(GAIDictionaryBuilder *)builder properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+- (NSDictionary *)eventPropertiesWithBuilder:(GAIDictionaryBuilder *)builder fields:(NSDictionary *)fields
 {
-    NSDictionary *customDimensions = [self extractCustomDimensionsFromProperties:properties];
-    [builder setAll:customDimensions];
-
-    NSDictionary *customMetrics = [self extractCustomMetricsFromProperties:properties];
-    [builder setAll:customMetrics];
+    [builder setAll:fields];
     
     NSMutableDictionary *retVal = [builder build];
     
     return  retVal;
 }
 
-- (NSDictionary *)extractCustomDimensionsFromProperties:(GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+- (NSDictionary *)fieldsForKeys:(nullable NSOrderedSet *)keys fieldName:(NSString *(^)(NSUInteger index))fieldName
 {
-    NSMutableDictionary *retVal = [NSMutableDictionary dictionary];
+    NSMutableDictionary *retVal = [NSMutableDictionary dictionaryWithCapacity:keys.count];
     
-    for (NSString *key in [properties allKeys])
-    {
-        NSUInteger index = [self.customDimensionKeys indexOfObject:key];
-        if (index != NSNotFound)
-        {
-            NSString *propertyKey = [GAIFields customDimensionForIndex:index + 1];
-            id value = properties[key];
-            retVal[propertyKey] = value;
-        }
-    }
+    [keys enumerateObjectsUsingBlock:^(id key, NSUInteger index, BOOL *stop) {
+        // NOTE: GAI field indexes are 1-based
+        retVal[key] = fieldName(index + 1);
+    }];
     
     return retVal;
 }
 
-- (NSDictionary *)extractCustomMetricsFromProperties:(GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+//Resolves the label and value from the designated keys by direct lookup: the key designated for the event, then the `labelValueKeys` in order.
+//Failing those, the NSNumber property with the lexicographically smallest key is used, so the choice doesn't depend on the dictionary's layout.
+//This is found in the same single pass over the properties which collects the custom dimension and metric fields.
+- (NSDictionary *)fieldsFromProperties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties event:(nullable NSString *)event label:(NSString * _Nullable * _Nullable)label value:(NSNumber * _Nullable * _Nullable)value
 {
+    NSDictionary *dimensionFields = self.customDimensionFields;
+    NSDictionary *metricFields = self.customMetricFields;
+    BOOL hasFields = dimensionFields.count > 0 || metricFields.count > 0;
+    
+    __block NSString *numberKey = nil;
+    __block NSNumber *number = nil;
+    if (label || value)
+    {
+        numberKey = [self designatedLabelValueKeyForEvent:event properties:properties];
+        number = numberKey ? properties[numberKey] : nil;
+    }
+    BOOL needsNumber = (label || value) && !number;
+    
     NSMutableDictionary *retVal = [NSMutableDictionary dictionary];
+    if (hasFields || needsNumber)
+    {
+        [properties enumerateKeysAndObjectsUsingBlock:^(NSString *key, id object, BOOL *stop) {
+            if (hasFields)
+            {
+                NSString *field = dimensionFields[key];
+                if (field)
+                {
+                    retVal[field] = object;
+                }
+                field = metricFields[key];
+                if (field)
+                {
+                    retVal[field] = object;
+                }
+            }
+            
+            if (needsNumber && [object isKindOfClass:NSNumber.class] && (!numberKey || [key compare:numberKey] == NSOrderedAscending))
+            {
+                numberKey = key;
+                number = object;
+            }
+        }];
+    }
     
-    for (NSString *key in [properties allKeys])
+    if (number)
     {
-        NSUInteger index = [self.customMetricKeys indexOfObject:key];
-        if (index != NSNotFound)
-        {
-            NSString *propertyKey = [GAIFields customMetricForIndex:index + 1];
-            id value = properties[key];
-            retVal[propertyKey] = value;
+        if (label) {
+            *label = numberKey;
+        }
+        if (value) {
+            *value = number;
         }
     }
     
     return retVal;
 }
 
-//Looks for a key:value pair whose value is an NSNumber and returns the key and value, if there's such a pair.
-//In the existence of more than one such pair the results are undefined.
-- (void)extractLabel:(NSString **)label andValue:(NSNumber **)value fromProperties:(GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+- (nullable NSString *)designatedLabelValueKeyForEvent:(nullable NSString *)event properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
 {
-    for (NSString *key in [properties allKeys])
+    if (properties.count == 0)
+    {
+        return nil;
+    }
+    
+    NSString *key = event ? self.eventLabelValueKeys[event] : nil;
+    if (key && [properties[key] isKindOfClass:NSNumber.class])
     {
-        id valueObj = properties[key];
-        if ([valueObj isKindOfClass:NSNumber.class])
+        return key;
+    }
+    
+    for (key in self.labelValueKeys)
+    {
+        if ([properties[key] isKindOfClass:NSNumber.class])
         {
-            if (label) {
-                *label = key;
-            }
-            
-            if (value) {
-                *value = (NSNumber *)valueObj;
-            }
-            return;
+            return key;
         }
     }
+    
+    return nil;
 }
 
 #pragma mark Notifications
@@ -384,54 +515,12 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
 - (void)registerNotifications
 {
 #if TARGET_OS_IPHONE
-    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(appDidEnterBackgroundNotification:) name:UIApplicationDidEnterBackgroundNotification object:nil];
     [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(appWillEnterForegroundNotification:) name:UIApplicationWillEnterForegroundNotification object:nil];
-#else
-    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(appWillTerminateNotification:) name:NSApplicationWillTerminateNotification object:nil];
 #endif
 }
 
-
 #if TARGET_OS_IPHONE
 
-- (void)appDidEnterBackgroundNotification:(NSNotification *)notification
-{
-    if (self.enabled)
-    {
-        [self sendHitsInBackground];
-    }
-}
-
-// This method sends any queued hits when the app enters the background.
-- (void)sendHitsInBackground
-{
-    __block BOOL taskExpired = NO;
-    
-    __block UIBackgroundTaskIdentifier taskId = [[UIApplication sharedApplication] beginBackgroundTaskWithExpirationHandler:^{
-        taskExpired = YES;
-    }];
-    
-    if (taskId == UIBackgroundTaskInvalid)
-    {
-        return;
-    }
-    
-    __weak typeof(self) weakSelf = self;
-    self.dispatchHandler = ^(NSUInteger result) {
-        //Send hits until no hits are left, a dispatch error occurs, or the background task expires.
-        if (result == kGAIDispatchGood && !taskExpired)
-        {
-            [[GAI sharedInstance] dispatchWithCompletionHandler:weakSelf.dispatchHandler];
-        }
-        else
-        {
-            [[UIApplication sharedApplication] endBackgroundTask:taskId];
-        }
-    };
-    
-    [[GAI sharedInstance] dispatchWithCompletionHandler:self.dispatchHandler];
-}
-
 - (void)appWillEnterForegroundNotification:(NSNotification *)notification
 {
     //Restores the dispatch interval because dispatchWithCompletionHandler
@@ -439,20 +528,35 @@ NSString * const kGRKGoogleAnalyticsProviderPropertyKeyDefaultCategory = @"defau
     [[GAI sharedInstance] setDispatchInterval:self.dispatchInterval];
 }
 
-#else
-//Mac
+#endif //TARGET_OS_IPHONE
+
+#pragma mark GRKFlushable
 
-- (void)appWillTerminateNotification:(NSNotification *)notification
+- (void)flushWithHitLimit:(NSUInteger)hitLimit completion:(void (^)(GRKFlushStepResult result, NSUInteger flushedCount))completion
 {
-    if (self.enabled)
+    if (!self.enabled)
     {
-        //Flush events before the app quits
-        [[GAI sharedInstance] dispatch];
+        completion(GRKFlushStepResultDone, 0);
+        return;
     }
+    
+    //GAI dispatches every queued hit at once, and does not say how many there were.
+    [[GAI sharedInstance] dispatchWithCompletionHandler:^(GAIDispatchResult result) {
+        switch (result)
+        {
+            case kGAIDispatchGood:
+                completion(GRKFlushStepResultMore, NSNotFound);
+                break;
+            case kGAIDispatchNoData:
+                completion(GRKFlushStepResultDone, 0);
+                break;
+            default:
+                completion(GRKFlushStepResultFailed, NSNotFound);
+                break;
+        }
+    }];
 }
 
-#endif //TARGET_OS_IPHONE
-
 #endif //GRK_ANALYTICS_ENABLED
 
 @end
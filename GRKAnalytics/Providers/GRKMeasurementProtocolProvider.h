@@ -0,0 +1,126 @@
+//
+//  GRKMeasurementProtocolProvider.h
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKAnalyticsProvider.h"
+#import "GRKLanguageFeatures.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The default endpoint: `https://www.google-analytics.com/batch`
+ */
+extern NSString * const kGRKMeasurementProtocolProviderDefaultEndpoint;
+
+/**
+ * A Google Analytics provider which needs no SDK. Hits are encoded as Measurement Protocol payloads straight into a reusable byte buffer, and sent several at a time to the `/batch` endpoint.
+ * Requests are sent one at a time over a single keep-alive connection. Failed requests are retried with jittered exponential backoff.
+ * The provider registers with `+[GRKFlushScheduler sharedScheduler]`, so pending hits are flushed when the app enters the background.
+ * @see https://developers.google.com/analytics/devguides/collection/protocol/v1/
+ */
+@interface GRKMeasurementProtocolProvider : GRKAnalyticsProvider
+
+/**
+ * The URL batches are sent to. Defaults to `kGRKMeasurementProtocolProviderDefaultEndpoint`.
+ * Point this at a local collector for tests and benchmarks.
+ */
+@property (atomic, copy) NSURL *endpointURL;
+
+/**
+ * The maximum number of hits sent in a single request. Defaults to, and may not exceed, `20`.
+ */
+@property (atomic, assign) NSUInteger maximumHitsPerRequest;
+
+/**
+ * The maximum size, in bytes, of a single request body. Defaults to, and may not exceed, `16384`.
+ * Hits larger than `8192` bytes are dropped, as the Measurement Protocol would reject them.
+ */
+@property (atomic, assign) NSUInteger maximumRequestBytes;
+
+/**
+ * If this value is positive, a partial batch is sent once its oldest hit has waited this many seconds. Full batches are sent immediately.
+ * Defaults to `30`.
+ */
+@property (atomic, assign) NSTimeInterval dispatchInterval;
+
+/**
+ * The number of times a failed request is retried before its hits are dropped. Defaults to `5`.
+ * Requests rejected by the endpoint (with a 4xx status) are not retried.
+ */
+@property (atomic, assign) NSUInteger maximumRetryCount;
+
+/**
+ * The delay before the first retry, in seconds. Each further retry doubles it, up to `maximumRetryInterval`, and the actual delay is a random value between half and all of it.
+ * Defaults to `1`.
+ */
+@property (atomic, assign) NSTimeInterval retryInterval;
+
+/**
+ * The longest delay between retries, in seconds. Defaults to `60`.
+ */
+@property (atomic, assign) NSTimeInterval maximumRetryInterval;
+
+/**
+ * The maximum number of hits held while waiting to be sent. Once reached, the oldest batches are dropped. Defaults to `1000`.
+ */
+@property (atomic, assign) NSUInteger maximumPendingHits;
+
+/**
+ * The number of hits dropped because they were too large, the pending hits overflowed, or their request could not be sent.
+ */
+@property (atomic, readonly) NSUInteger droppedHitCount;
+
+/**
+ * Predefined custom dimension keys. Properties with these keys are sent as custom dimensions, with the (1-based) index of the key.
+ * @see `-[GRKGoogleAnalyticsProvider customDimensionKeys]`
+ */
+@property (atomic, copy, nullable) GRK_GENERIC_NSARRAY(NSString *) *customDimensionKeys;
+
+/**
+ * Predefined custom metric keys. Properties with these keys are sent as custom metrics, with the (1-based) index of the key.
+ * @see `-[GRKGoogleAnalyticsProvider customMetricKeys]`
+ */
+@property (atomic, copy, nullable) GRK_GENERIC_NSARRAY(NSString *) *customMetricKeys;
+
+/**
+ * Initialize a provider for use with the Google Analytics Measurement Protocol.
+ * Typical usage would be something like `[GRKMeasurementProtocolProvider alloc] initWithTrackingID:@"UA-xxxxx-y" clientID:nil configuration:nil]`
+ *
+ * @param trackingID    The tracking ID provided by Google Analytics which identifies this property.
+ * @param clientID      The identifier of this installation. If `nil` a random identifier is created once, and kept in the standard user defaults.
+ * @param configuration The configuration of the URL session requests are sent with. If `nil` an ephemeral configuration is used.
+ *
+ * @return An initialized instance of the provider which can be passed to `GRKAnalytics addProvider:` class method.
+ */
+- (instancetype)initWithTrackingID:(NSString *)trackingID clientID:(nullable NSString *)clientID configuration:(nullable NSURLSessionConfiguration *)configuration NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Initialize a provider with a persistent client ID and an ephemeral URL session configuration.
+ *
+ * @param trackingID The tracking ID provided by Google Analytics which identifies this property.
+ *
+ * @return An initialized instance of the provider which can be passed to `GRKAnalytics addProvider:` class method.
+ */
+- (instancetype)initWithTrackingID:(NSString *)trackingID;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Send every pending hit now, ignoring `dispatchInterval`.
+ *
+ * @param completion Called, on an arbitrary queue, once no hits are pending or a request fails.
+ */
+- (void)dispatchWithCompletion:(nullable void (^)(BOOL success))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
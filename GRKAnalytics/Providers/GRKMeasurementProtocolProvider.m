@@ -0,0 +1,773 @@
+//
+//  GRKMeasurementProtocolProvider.m
+//  GRKAnalytics
+//
+//  Created by Levi Brown on October, 17 2026.
+//  Copyright (c) 2026 Levi Brown <mailto:levigroker@gmail.com> This work is
+//  licensed under the Creative Commons Attribution 4.0 International License. To
+//  view a copy of this license, visit https://creativecommons.org/licenses/by/4.0/
+//
+//  The above attribution and the included license must accompany any version of
+//  the source code, binary distributable, or derivatives.
+//
+
+#import "GRKMeasurementProtocolProvider.h"
+#import "GRKFlushScheduler.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+NSString * const kGRKMeasurementProtocolProviderDefaultEndpoint = @"https://www.google-analytics.com/batch";
+
+static NSString * const kGRKMeasurementProtocolProviderClientIDKey = @"GRKMeasurementProtocolProviderClientID";
+static NSString * const kGRKMeasurementProtocolProviderDefaultCategory = @"default";
+
+// Limits imposed by the Measurement Protocol.
+enum { kGRKMeasurementProtocolMaximumHitsPerBatch = 20 };
+static NSUInteger const kGRKMeasurementProtocolMaximumBatchBytes = 16384;
+static NSUInteger const kGRKMeasurementProtocolMaximumHitBytes = 8192;
+// Room kept in each hit for the queue time ("&qt=" and up to 20 digits) and the separating newline, which are only written when the batch is sealed.
+static NSUInteger const kGRKMeasurementProtocolQueueTimeBytes = 25;
+
+#pragma mark - Encoding
+
+// Appends the bytes as they are. Only for names and values which need no encoding.
+static void GRKMeasurementProtocolAppendLiteral(NSMutableData *data, const char *literal)
+{
+	[data appendBytes:literal length:strlen(literal)];
+}
+
+// Appends the UTF-8 bytes of the string, percent-encoding everything but unreserved characters.
+static void GRKMeasurementProtocolAppendEncoded(NSMutableData *data, NSString *string)
+{
+	static const char hexDigits[] = "0123456789ABCDEF";
+	uint8_t input[256];
+	uint8_t output[sizeof(input) * 3];
+	NSRange remaining = NSMakeRange(0, string.length);
+
+	while (remaining.length > 0) {
+		NSUInteger inputLength = 0;
+		if (![string getBytes:input maxLength:sizeof(input) usedLength:&inputLength encoding:NSUTF8StringEncoding options:NSStringEncodingConversionAllowLossy range:remaining remainingRange:&remaining] || inputLength == 0) {
+			break;
+		}
+
+		NSUInteger outputLength = 0;
+		for (NSUInteger i = 0; i < inputLength; ++i) {
+			uint8_t byte = input[i];
+			if ((byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z') || (byte >= '0' && byte <= '9') || byte == '-' || byte == '.' || byte == '_' || byte == '~') {
+				output[outputLength++] = byte;
+			}
+			else {
+				output[outputLength++] = '%';
+				output[outputLength++] = (uint8_t)hexDigits[byte >> 4];
+				output[outputLength++] = (uint8_t)hexDigits[byte & 0x0F];
+			}
+		}
+		[data appendBytes:output length:outputLength];
+	}
+}
+
+// Appends "&name=value".
+static void GRKMeasurementProtocolAppendParameter(NSMutableData *data, const char *name, NSString *value)
+{
+	uint8_t separator = '&';
+	[data appendBytes:&separator length:1];
+	GRKMeasurementProtocolAppendLiteral(data, name);
+	uint8_t equals = '=';
+	[data appendBytes:&equals length:1];
+	GRKMeasurementProtocolAppendEncoded(data, value);
+}
+
+static void GRKMeasurementProtocolAppendIntegerParameter(NSMutableData *data, const char *name, long long value)
+{
+	char buffer[48];
+	int length = snprintf(buffer, sizeof(buffer), "&%s=%lld", name, value);
+	if (length > 0 && (size_t)length < sizeof(buffer)) {
+		[data appendBytes:buffer length:(NSUInteger)length];
+	}
+}
+
+static NSString *GRKMeasurementProtocolStringValue(id value)
+{
+	if ([value isKindOfClass:NSString.class]) {
+		return value;
+	}
+	if ([value isKindOfClass:NSNumber.class]) {
+		return [value stringValue];
+	}
+
+	return [value description];
+}
+
+#pragma mark - GRKMeasurementProtocolBatch
+
+// The body of a single request, and the hits it carries.
+@interface GRKMeasurementProtocolBatch : NSObject
+
+@property (nonatomic, strong) NSData *body;
+@property (nonatomic, assign) NSUInteger hitCount;
+@property (nonatomic, assign) NSUInteger attempts;
+
+@end
+
+@implementation GRKMeasurementProtocolBatch
+@end
+
+#pragma mark - GRKMeasurementProtocolProvider
+
+@interface GRKMeasurementProtocolProvider () <GRKFlushable>
+
+@property (nonatomic, copy) NSString *trackingID;
+@property (nonatomic, copy) NSString *clientID;
+@property (nonatomic, strong) NSURLSession *session;
+// Everything below is only used on this queue.
+@property (nonatomic, strong) dispatch_queue_t queue;
+// The parameters every hit starts with, already encoded.
+@property (nonatomic, strong) NSData *hitPrefix;
+// Hits of the batch being filled, back to back. Reused from batch to batch.
+@property (nonatomic, strong) NSMutableData *hitBuffer;
+@property (nonatomic, assign) NSUInteger hitCount;
+// Incremented with each sealed batch, so a stale dispatch timer can tell its batch has already gone.
+@property (nonatomic, assign) NSUInteger hitGeneration;
+// Sealed batches, oldest first. The first is in flight while `sending`.
+@property (nonatomic, strong) NSMutableArray<GRKMeasurementProtocolBatch *> *batches;
+@property (nonatomic, assign) BOOL sending;
+// Incremented when a retry is scheduled or pre-empted, so a stale retry timer can tell.
+@property (nonatomic, assign) NSUInteger retryGeneration;
+@property (nonatomic, assign) BOOL retryScheduled;
+// Called with the outcome of the next request.
+@property (nonatomic, strong) NSMutableArray<void (^)(BOOL success, NSUInteger sentCount)> *requestCompletions;
+// Custom dimension values set with `setUserProperty:toValue:`, sent with every hit.
+@property (nonatomic, copy) GRK_GENERIC_NSDICTIONARY(NSString *, NSString *) *userDimensions;
+// Property key -> parameter name, compiled from `customDimensionKeys` and `customMetricKeys` as they are set.
+@property (atomic, copy) GRK_GENERIC_NSDICTIONARY(NSString *, NSString *) *customDimensionParameters;
+@property (atomic, copy) GRK_GENERIC_NSDICTIONARY(NSString *, NSString *) *customMetricParameters;
+@property (atomic, assign) NSUInteger pendingCount;
+// Set while the provider is disabled. (The `enabled` state of a provider which was never set is `NO`, so it cannot be used for this.)
+@property (atomic, assign) BOOL discardsHits;
+@property (atomic, readwrite) NSUInteger droppedHitCount;
+
+@end
+
+@implementation GRKMeasurementProtocolProvider
+{
+	// End offset in `hitBuffer`, and timestamp, of each hit of the batch being filled.
+	NSUInteger _hitEnds[kGRKMeasurementProtocolMaximumHitsPerBatch];
+	NSTimeInterval _hitTimestamps[kGRKMeasurementProtocolMaximumHitsPerBatch];
+}
+
+@synthesize customDimensionKeys = _customDimensionKeys;
+@synthesize customMetricKeys = _customMetricKeys;
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithTrackingID:(NSString *)trackingID
+{
+    return [self initWithTrackingID:trackingID clientID:nil configuration:nil];
+}
+
+- (instancetype)initWithTrackingID:(NSString *)trackingID clientID:(nullable NSString *)clientID configuration:(nullable NSURLSessionConfiguration *)configuration
+{
+    NSAssert(trackingID.length > 0, @"No tracking ID was specified.");
+
+    if ((self = [super init]))
+    {
+        _trackingID = [trackingID copy];
+        _clientID = [clientID copy] ?: [self persistentClientID];
+        _endpointURL = [NSURL URLWithString:kGRKMeasurementProtocolProviderDefaultEndpoint];
+        _maximumHitsPerRequest = kGRKMeasurementProtocolMaximumHitsPerBatch;
+        _maximumRequestBytes = kGRKMeasurementProtocolMaximumBatchBytes;
+        _dispatchInterval = 30.0;
+        _maximumRetryCount = 5;
+        _retryInterval = 1.0;
+        _maximumRetryInterval = 60.0;
+        _maximumPendingHits = 1000;
+
+        NSURLSessionConfiguration *sessionConfiguration = [configuration copy] ?: [NSURLSessionConfiguration ephemeralSessionConfiguration];
+        // Requests are sent one at a time, so a single connection is kept alive and reused.
+        sessionConfiguration.HTTPMaximumConnectionsPerHost = 1;
+        _session = [NSURLSession sessionWithConfiguration:sessionConfiguration];
+
+        NSString *label = [NSString stringWithFormat:@"com.levigroker.GRKAnalytics.%@", NSStringFromClass(self.class)];
+        _queue = dispatch_queue_create(label.UTF8String, DISPATCH_QUEUE_SERIAL);
+        _hitBuffer = [NSMutableData dataWithCapacity:kGRKMeasurementProtocolMaximumBatchBytes];
+        _batches = [NSMutableArray array];
+        _requestCompletions = [NSMutableArray array];
+        _userDimensions = @{};
+        _customDimensionParameters = @{};
+        _customMetricParameters = @{};
+        _hitPrefix = [self hitPrefixWithUserID:nil];
+
+        [[GRKFlushScheduler sharedScheduler] registerFlushable:self];
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    [[GRKFlushScheduler sharedScheduler] unregisterFlushable:self];
+    [_session finishTasksAndInvalidate];
+}
+
+#pragma mark - Meta
+
+- (void)setEnabled:(BOOL)enabled
+{
+    [super setEnabled:enabled];
+    self.discardsHits = !enabled;
+
+    if (!enabled)
+    {
+        dispatch_async(self.queue, ^{
+            self.hitBuffer.length = 0;
+            self.hitCount = 0;
+            self.hitGeneration += 1;
+            // The batch in flight (if any) is removed when its request completes.
+            NSRange unsent = self.sending ? NSMakeRange(1, self.batches.count - 1) : NSMakeRange(0, self.batches.count);
+            [self.batches removeObjectsInRange:unsent];
+            self.pendingCount = self.sending ? self.batches.firstObject.hitCount : 0;
+        });
+    }
+}
+
+#pragma mark - Accessors
+
+- (GRK_GENERIC_NSARRAY(NSString *) *)customDimensionKeys
+{
+    @synchronized (self)
+    {
+        return _customDimensionKeys;
+    }
+}
+
+- (void)setCustomDimensionKeys:(nullable GRK_GENERIC_NSARRAY(NSString *) *)customDimensionKeys
+{
+    @synchronized (self)
+    {
+        _customDimensionKeys = [customDimensionKeys copy];
+        self.customDimensionParameters = [self parametersForKeys:customDimensionKeys prefix:@"cd"];
+    }
+}
+
+- (GRK_GENERIC_NSARRAY(NSString *) *)customMetricKeys
+{
+    @synchronized (self)
+    {
+        return _customMetricKeys;
+    }
+}
+
+- (void)setCustomMetricKeys:(nullable GRK_GENERIC_NSARRAY(NSString *) *)customMetricKeys
+{
+    @synchronized (self)
+    {
+        _customMetricKeys = [customMetricKeys copy];
+        self.customMetricParameters = [self parametersForKeys:customMetricKeys prefix:@"cm"];
+    }
+}
+
+#pragma mark - User
+
+#pragma mark User Identity
+
+- (void)identifyUserWithID:(nullable NSString *)userID andEmailAddress:(nullable NSString *)email
+{
+    dispatch_async(self.queue, ^{
+        self.hitPrefix = [self hitPrefixWithUserID:userID];
+    });
+}
+
+#pragma mark User Properties
+
+- (void)setUserProperty:(NSString *)property toValue:(nullable id)value
+{
+    NSString *parameter = self.customDimensionParameters[property];
+    if (parameter)
+    {
+        NSString *string = value ? GRKMeasurementProtocolStringValue(value) : nil;
+        dispatch_async(self.queue, ^{
+            NSMutableDictionary *userDimensions = [self.userDimensions mutableCopy];
+            userDimensions[parameter] = string;
+            self.userDimensions = userDimensions;
+        });
+    }
+}
+
+#pragma mark - Events
+
+- (void)trackEvent:(NSString *)event
+          category:(nullable NSString *)category
+        properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    [self trackEvents:@[[GRKAnalyticsEvent eventWithName:event category:category properties:properties]]];
+}
+
+#pragma mark Event Specific Cases
+
+- (void)trackAppBecameActiveWithCategory:(nullable NSString *)category
+                              properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    [self trackEvent:kGRKAnalyticsProviderDefaultEventKeyAppBecameActive category:category properties:properties];
+}
+
+- (void)trackContentViewWithName:(nullable NSString *)name
+                     contentType:(nullable NSString *)type
+                       contentID:(nullable NSString *)identifier
+                      properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    if (name.length > 0)
+    {
+        NSTimeInterval timestamp = [NSProcessInfo processInfo].systemUptime;
+        dispatch_async(self.queue, ^{
+            NSUInteger hitStart = [self beginHitWithType:"screenview"];
+            GRKMeasurementProtocolAppendParameter(self.hitBuffer, "cd", name);
+            [self appendCustomParametersForProperties:properties];
+            [self endHitAt:hitStart timestamp:timestamp];
+        });
+    }
+}
+
+#pragma mark - Timing
+
+- (void)trackTimingEvent:(NSString *)event
+                category:(nullable NSString *)category
+            timeInterval:(NSTimeInterval)timeInterval
+              properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    [self trackEvents:@[[GRKAnalyticsEvent timingEventWithName:event category:category timeInterval:timeInterval properties:properties]]];
+}
+
+#pragma mark - Batches
+
+- (void)trackEvents:(GRK_GENERIC_NSARRAY(GRKAnalyticsEvent *) *)events
+{
+    dispatch_async(self.queue, ^{
+        for (GRKAnalyticsEvent *event in events)
+        {
+            if (event.name.length == 0)
+            {
+                continue;
+            }
+
+            NSString *category = event.category.length > 0 ? event.category : kGRKMeasurementProtocolProviderDefaultCategory;
+            NSUInteger hitStart = 0;
+            switch (event.type)
+            {
+                case GRKAnalyticsEventTypeEvent:
+                {
+                    hitStart = [self beginHitWithType:"event"];
+                    GRKMeasurementProtocolAppendParameter(self.hitBuffer, "ec", category);
+                    GRKMeasurementProtocolAppendParameter(self.hitBuffer, "ea", event.name);
+                    NSString *labelKey = [self labelKeyForProperties:event.properties];
+                    if (labelKey)
+                    {
+                        GRKMeasurementProtocolAppendParameter(self.hitBuffer, "el", labelKey);
+                        GRKMeasurementProtocolAppendIntegerParameter(self.hitBuffer, "ev", [event.properties[labelKey] longLongValue]);
+                    }
+                    break;
+                }
+                case GRKAnalyticsEventTypeTiming:
+                    hitStart = [self beginHitWithType:"timing"];
+                    GRKMeasurementProtocolAppendParameter(self.hitBuffer, "utc", category);
+                    GRKMeasurementProtocolAppendParameter(self.hitBuffer, "utv", event.name);
+                    GRKMeasurementProtocolAppendIntegerParameter(self.hitBuffer, "utt", (long long)(event.timeInterval * 1000.0));
+                    break;
+            }
+            [self appendCustomParametersForProperties:event.properties];
+            [self endHitAt:hitStart timestamp:event.timestamp];
+        }
+    });
+}
+
+#pragma mark - Errors
+
+- (void)trackError:(NSError *)error properties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    NSString *description = [NSString stringWithFormat:@"%@ (%ld): %@", error.domain, (long)error.code, error.localizedDescription];
+    NSTimeInterval timestamp = [NSProcessInfo processInfo].systemUptime;
+    dispatch_async(self.queue, ^{
+        NSUInteger hitStart = [self beginHitWithType:"exception"];
+        GRKMeasurementProtocolAppendParameter(self.hitBuffer, "exd", description);
+        GRKMeasurementProtocolAppendLiteral(self.hitBuffer, "&exf=0");
+        [self appendCustomParametersForProperties:properties];
+        [self endHitAt:hitStart timestamp:timestamp];
+    });
+}
+
+#pragma mark - Dispatching
+
+- (void)dispatchWithCompletion:(nullable void (^)(BOOL success))completion
+{
+    [self flushWithHitLimit:NSUIntegerMax completion:^(GRKFlushStepResult result, NSUInteger flushedCount) {
+        if (result == GRKFlushStepResultMore)
+        {
+            [self dispatchWithCompletion:completion];
+        }
+        else if (completion)
+        {
+            completion(result == GRKFlushStepResultDone);
+        }
+    }];
+}
+
+#pragma mark GRKFlushable
+
+// Hits are sent in whole batches, so a step may send a few more hits than `hitLimit`.
+- (void)flushWithHitLimit:(NSUInteger)hitLimit completion:(void (^)(GRKFlushStepResult result, NSUInteger flushedCount))completion
+{
+    dispatch_async(self.queue, ^{
+        [self sealBatch];
+
+        if (self.batches.count == 0)
+        {
+            completion(GRKFlushStepResultDone, 0);
+            return;
+        }
+
+        [self.requestCompletions addObject:^(BOOL success, NSUInteger sentCount) {
+            if (!success)
+            {
+                completion(GRKFlushStepResultFailed, 0);
+            }
+            else
+            {
+                completion(self.batches.count > 0 || self.hitCount > 0 ? GRKFlushStepResultMore : GRKFlushStepResultDone, sentCount);
+            }
+        }];
+
+        // A flush does not wait out a retry delay.
+        if (self.retryScheduled)
+        {
+            self.retryScheduled = NO;
+            self.retryGeneration += 1;
+        }
+        [self sendNextBatch];
+    });
+}
+
+- (NSUInteger)pendingHitCount
+{
+    return self.pendingCount;
+}
+
+#pragma mark - Helpers
+
+- (NSString *)persistentClientID
+{
+    NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
+    NSString *clientID = [defaults stringForKey:kGRKMeasurementProtocolProviderClientIDKey];
+
+    if (clientID.length == 0)
+    {
+        clientID = [NSUUID UUID].UUIDString;
+        [defaults setObject:clientID forKey:kGRKMeasurementProtocolProviderClientIDKey];
+    }
+
+    return clientID;
+}
+
+- (NSData *)hitPrefixWithUserID:(nullable NSString *)userID
+{
+    NSMutableData *prefix = [NSMutableData data];
+    GRKMeasurementProtocolAppendLiteral(prefix, "v=1");
+    GRKMeasurementProtocolAppendParameter(prefix, "tid", self.trackingID);
+    GRKMeasurementProtocolAppendParameter(prefix, "cid", self.clientID);
+    if (userID.length > 0)
+    {
+        GRKMeasurementProtocolAppendParameter(prefix, "uid", userID);
+    }
+
+    NSDictionary *info = [NSBundle mainBundle].infoDictionary;
+    NSString *applicationName = info[@"CFBundleName"];
+    if (applicationName.length > 0)
+    {
+        GRKMeasurementProtocolAppendParameter(prefix, "an", applicationName);
+    }
+    NSString *applicationVersion = info[@"CFBundleShortVersionString"];
+    if (applicationVersion.length > 0)
+    {
+        GRKMeasurementProtocolAppendParameter(prefix, "av", applicationVersion);
+    }
+
+    return prefix;
+}
+
+- (GRK_GENERIC_NSDICTIONARY(NSString *, NSString *) *)parametersForKeys:(nullable GRK_GENERIC_NSARRAY(NSString *) *)keys prefix:(NSString *)prefix
+{
+    NSMutableDictionary *parameters = [NSMutableDictionary dictionaryWithCapacity:keys.count];
+
+    [keys enumerateObjectsUsingBlock:^(NSString *key, NSUInteger index, BOOL *stop) {
+        if (!parameters[key])
+        {
+            parameters[key] = [NSString stringWithFormat:@"%@%lu", prefix, (unsigned long)(index + 1)];
+        }
+    }];
+
+    return parameters;
+}
+
+// The key of the numeric property used as the label (with its value as the value), choosing the lexicographically smallest key so the choice is stable.
+- (nullable NSString *)labelKeyForProperties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    __block NSString *labelKey = nil;
+    NSDictionary *customDimensionParameters = self.customDimensionParameters;
+    NSDictionary *customMetricParameters = self.customMetricParameters;
+
+    [properties enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+        if ([value isKindOfClass:NSNumber.class] && !customDimensionParameters[key] && !customMetricParameters[key] && (!labelKey || [key compare:labelKey] == NSOrderedAscending))
+        {
+            labelKey = key;
+        }
+    }];
+
+    return labelKey;
+}
+
+- (void)appendCustomParametersForProperties:(nullable GRK_GENERIC_NSDICTIONARY(NSString *, id) *)properties
+{
+    NSDictionary *customDimensionParameters = self.customDimensionParameters;
+    NSDictionary *customMetricParameters = self.customMetricParameters;
+    NSMutableData *hitBuffer = self.hitBuffer;
+    NSMutableSet *sentDimensions = nil;
+
+    if (customDimensionParameters.count > 0 || customMetricParameters.count > 0)
+    {
+        for (NSString *key in properties)
+        {
+            NSString *parameter = customDimensionParameters[key] ?: customMetricParameters[key];
+            if (parameter)
+            {
+                GRKMeasurementProtocolAppendParameter(hitBuffer, parameter.UTF8String, GRKMeasurementProtocolStringValue(properties[key]));
+                if (self.userDimensions[parameter])
+                {
+                    sentDimensions = sentDimensions ?: [NSMutableSet set];
+                    [sentDimensions addObject:parameter];
+                }
+            }
+        }
+    }
+
+    [self.userDimensions enumerateKeysAndObjectsUsingBlock:^(NSString *parameter, NSString *value, BOOL *stop) {
+        if (![sentDimensions containsObject:parameter])
+        {
+            GRKMeasurementProtocolAppendParameter(hitBuffer, parameter.UTF8String, value);
+        }
+    }];
+}
+
+#pragma mark Batching
+
+// Starts a hit at the end of the hit buffer, returning its start offset.
+- (NSUInteger)beginHitWithType:(const char *)type
+{
+    NSUInteger hitStart = self.hitBuffer.length;
+    [self.hitBuffer appendData:self.hitPrefix];
+    GRKMeasurementProtocolAppendLiteral(self.hitBuffer, "&t=");
+    GRKMeasurementProtocolAppendLiteral(self.hitBuffer, type);
+
+    return hitStart;
+}
+
+- (void)endHitAt:(NSUInteger)hitStart timestamp:(NSTimeInterval)timestamp
+{
+    NSUInteger hitLength = self.hitBuffer.length - hitStart;
+    NSUInteger maximumBytes = MIN(self.maximumRequestBytes, kGRKMeasurementProtocolMaximumBatchBytes);
+
+    if (self.discardsHits)
+    {
+        self.hitBuffer.length = hitStart;
+        return;
+    }
+
+    if (hitLength + kGRKMeasurementProtocolQueueTimeBytes > MIN(maximumBytes, kGRKMeasurementProtocolMaximumHitBytes))
+    {
+        self.hitBuffer.length = hitStart;
+        self.droppedHitCount += 1;
+        return;
+    }
+
+    // If the hit does not fit the batch, seal the batch without it, and start the next batch with it.
+    if (self.hitCount > 0 && self.hitBuffer.length + (self.hitCount + 1) * kGRKMeasurementProtocolQueueTimeBytes > maximumBytes)
+    {
+        [self sealBatch];
+        [self.hitBuffer replaceBytesInRange:NSMakeRange(0, hitStart) withBytes:NULL length:0];
+        [self sendNextBatch];
+    }
+
+    if (self.hitCount == 0)
+    {
+        [self scheduleDispatch];
+    }
+
+    _hitEnds[self.hitCount] = self.hitBuffer.length;
+    _hitTimestamps[self.hitCount] = timestamp;
+    self.hitCount += 1;
+    self.pendingCount += 1;
+
+    if (self.hitCount >= MIN(MAX(self.maximumHitsPerRequest, 1), (NSUInteger)kGRKMeasurementProtocolMaximumHitsPerBatch))
+    {
+        [self sealBatch];
+        [self sendNextBatch];
+    }
+}
+
+- (void)scheduleDispatch
+{
+    NSTimeInterval dispatchInterval = self.dispatchInterval;
+
+    if (dispatchInterval > 0)
+    {
+        NSUInteger generation = self.hitGeneration;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(dispatchInterval * NSEC_PER_SEC)), self.queue, ^{
+            if (generation == self.hitGeneration)
+            {
+                [self sealBatch];
+                [self sendNextBatch];
+            }
+        });
+    }
+}
+
+// Copies the recorded hits of the hit buffer into the body of a new batch, stamping each with its queue time. The hit buffer is emptied, unless an unrecorded hit follows the recorded ones.
+- (void)sealBatch
+{
+    NSUInteger hitCount = self.hitCount;
+
+    if (hitCount == 0)
+    {
+        return;
+    }
+
+    NSMutableData *body = [NSMutableData dataWithCapacity:_hitEnds[hitCount - 1] + hitCount * kGRKMeasurementProtocolQueueTimeBytes];
+    const uint8_t *bytes = self.hitBuffer.bytes;
+    NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+    NSUInteger hitStart = 0;
+
+    for (NSUInteger i = 0; i < hitCount; ++i)
+    {
+        [body appendBytes:bytes + hitStart length:_hitEnds[i] - hitStart];
+        GRKMeasurementProtocolAppendIntegerParameter(body, "qt", (long long)(MAX(now - _hitTimestamps[i], 0) * 1000.0));
+        if (i + 1 < hitCount)
+        {
+            GRKMeasurementProtocolAppendLiteral(body, "\n");
+        }
+        hitStart = _hitEnds[i];
+    }
+
+    if (_hitEnds[hitCount - 1] == self.hitBuffer.length)
+    {
+        self.hitBuffer.length = 0;
+    }
+    self.hitCount = 0;
+    self.hitGeneration += 1;
+
+    GRKMeasurementProtocolBatch *batch = [[GRKMeasurementProtocolBatch alloc] init];
+    batch.body = body;
+    batch.hitCount = hitCount;
+    [self.batches addObject:batch];
+
+    // Drop the oldest batches (but not the one in flight) once too many hits are waiting.
+    NSUInteger maximumPendingHits = self.maximumPendingHits;
+    while (self.pendingCount > maximumPendingHits && self.batches.count > (self.sending ? 2 : 1))
+    {
+        NSUInteger index = self.sending ? 1 : 0;
+        NSUInteger droppedCount = self.batches[index].hitCount;
+        [self.batches removeObjectAtIndex:index];
+        self.pendingCount -= droppedCount;
+        self.droppedHitCount += droppedCount;
+    }
+}
+
+#pragma mark Sending
+
+- (void)sendNextBatch
+{
+    if (self.sending || self.retryScheduled)
+    {
+        return;
+    }
+
+    GRKMeasurementProtocolBatch *batch = self.batches.firstObject;
+    if (!batch)
+    {
+        return;
+    }
+
+    self.sending = YES;
+    batch.attempts += 1;
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:self.endpointURL];
+    request.HTTPMethod = @"POST";
+    request.HTTPBody = batch.body;
+    [request setValue:@"application/x-www-form-urlencoded" forHTTPHeaderField:@"Content-Type"];
+
+    __weak typeof(self) weakSelf = self;
+    NSURLSessionDataTask *task = [self.session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        NSInteger statusCode = [response isKindOfClass:NSHTTPURLResponse.class] ? ((NSHTTPURLResponse *)response).statusCode : 0;
+        typeof(self) strongSelf = weakSelf;
+        if (!strongSelf)
+        {
+            return;
+        }
+        dispatch_async(strongSelf.queue, ^{
+            [strongSelf completeBatch:batch statusCode:error ? 0 : statusCode];
+        });
+    }];
+    [task resume];
+}
+
+- (void)completeBatch:(GRKMeasurementProtocolBatch *)batch statusCode:(NSInteger)statusCode
+{
+    self.sending = NO;
+
+    BOOL success = statusCode >= 200 && statusCode < 300;
+    // Anything but a rejection of the request itself is worth retrying.
+    BOOL retry = !success && !(statusCode >= 400 && statusCode < 500) && batch.attempts <= self.maximumRetryCount;
+
+    if (!retry && self.batches.firstObject == batch)
+    {
+        [self.batches removeObjectAtIndex:0];
+        self.pendingCount -= batch.hitCount;
+        if (!success)
+        {
+            self.droppedHitCount += batch.hitCount;
+        }
+    }
+
+    NSArray *requestCompletions = [self.requestCompletions copy];
+    [self.requestCompletions removeAllObjects];
+    for (void (^requestCompletion)(BOOL, NSUInteger) in requestCompletions)
+    {
+        requestCompletion(success, success ? batch.hitCount : 0);
+    }
+
+    if (retry)
+    {
+        [self scheduleRetryForBatch:batch];
+    }
+    else
+    {
+        [self sendNextBatch];
+    }
+}
+
+- (void)scheduleRetryForBatch:(GRKMeasurementProtocolBatch *)batch
+{
+    NSTimeInterval interval = MIN(self.retryInterval * pow(2.0, (double)(batch.attempts - 1)), self.maximumRetryInterval);
+    // "Equal jitter": somewhere between half and all of the interval, so clients which failed together do not retry together.
+    NSTimeInterval delay = interval * (0.5 + 0.5 * ((double)arc4random_uniform(1000) / 1000.0));
+    NSUInteger generation = ++self.retryGeneration;
+    self.retryScheduled = YES;
+
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), self.queue, ^{
+        if (generation == self.retryGeneration)
+        {
+            self.retryScheduled = NO;
+            [self sendNextBatch];
+        }
+    });
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -12,9 +12,45 @@
 @interface GRKAppCenterProvider ()
 
 - (NSString *)sanitizeUserPropertyKey:(nullable NSString *)propertyKey;
+- (NSMutableDictionary<NSString *, id> *)pendingUserProperties;
 
 @end
 
+// The sanitizer as it was before it was bounded, for comparison.
+static NSString *GRKLegacySanitizeUserPropertyKey(NSString *propertyKey)
+{
+	propertyKey = [propertyKey stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+	NSString *retVal = @"";
+	
+	if (propertyKey.length > 0) {
+		NSUInteger length = propertyKey.length;
+		unichar resultBuffer[length + 1];
+		unichar inputBuffer[length];
+		[propertyKey getCharacters:inputBuffer range:NSMakeRange(0, length)];
+		
+		NSUInteger resultIndex = 0;
+		NSUInteger inputIndex = 0;
+		unichar firstChar = inputBuffer[inputIndex++];
+		resultBuffer[resultIndex++] = [[NSCharacterSet letterCharacterSet] characterIsMember:firstChar] ? firstChar : 'a';
+		
+		for (; inputIndex < length; ++inputIndex) {
+			unichar nextChar = inputBuffer[inputIndex];
+			if ([[NSCharacterSet alphanumericCharacterSet] characterIsMember:nextChar]) {
+				resultBuffer[resultIndex++] = nextChar;
+			}
+		}
+		
+		retVal = [[NSString alloc] initWithCharacters:resultBuffer length:resultIndex];
+	}
+	
+	return retVal;
+}
+
+static NSArray<NSString *> *GRKBenchmarkPropertyKeys(void)
+{
+	return @[@"userName", @"subscription_tier", @" Favorite Color ", @"lastPurchaseDateOfTheMostRecentOrderPlacedByTheUser", @"Größe", @"1stVisit"];
+}
+
 @interface AppCenterProviderTests : XCTestCase
 
 @property (nonatomic,strong) GRKAppCenterProvider *provider;
@@ -116,4 +152,109 @@
 	XCTAssertTrue([outString isEqualToString:expectedString], @"Expected \"%@\" but received \"%@\".", expectedString, outString);
 }
 
+- (void)testSanitizeUserPropertyKey900 {
+	
+	NSString *inString = [NSMutableString stringWithString:@"subscriptionTier2"];
+	
+	NSString *outString = [self.provider sanitizeUserPropertyKey:inString];
+	
+	XCTAssertTrue(outString == inString, @"Expected the valid key to be returned unaltered.");
+}
+
+- (void)testSanitizeUserPropertyKey1000 {
+	
+	NSString *inString = [@"" stringByPaddingToLength:100000 withString:@"abc.def " startingAtIndex:0];
+	
+	NSString *outString = [self.provider sanitizeUserPropertyKey:inString];
+	
+	XCTAssertTrue(outString.length == 125, @"Expected length 125 but found %d.", (int)outString.length);
+	XCTAssertTrue([outString hasPrefix:@"abcdefabcdef"], @"Unexpected output \"%@\".", outString);
+}
+
+- (void)testSanitizeUserPropertyKeyMatchesLegacy100 {
+	
+	for (NSString *inString in GRKBenchmarkPropertyKeys()) {
+		NSString *expectedString = GRKLegacySanitizeUserPropertyKey(inString);
+		NSString *outString = [self.provider sanitizeUserPropertyKey:inString];
+		XCTAssertEqualObjects(outString, expectedString, @"Unexpected result for \"%@\".", inString);
+	}
+}
+
+- (void)testSanitizeUserPropertyKeyPerformance100 {
+	
+	NSArray<NSString *> *keys = GRKBenchmarkPropertyKeys();
+	
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 10000; ++i) {
+			for (NSString *key in keys) {
+				[self.provider sanitizeUserPropertyKey:key];
+			}
+		}
+	}];
+}
+
+- (void)testSanitizeUserPropertyKeyLegacyPerformance100 {
+	
+	NSArray<NSString *> *keys = GRKBenchmarkPropertyKeys();
+	
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 10000; ++i) {
+			for (NSString *key in keys) {
+				GRKLegacySanitizeUserPropertyKey(key);
+			}
+		}
+	}];
+}
+
+- (void)testCoalesceUserProperties100 {
+
+	self.provider.userPropertyFlushInterval = 60.0;
+	[self.provider identifyUserWithID:@"user" andEmailAddress:@"user@example.com"];
+	for (NSUInteger i = 0; i < 10; ++i) {
+		[self.provider setUserProperty:[NSString stringWithFormat:@"property%d", (int)i] toValue:@(i)];
+	}
+	[self.provider setUserProperty:@"property0" toValue:@"replaced"];
+	[self.provider setUserProperty:@"property1" toValue:nil];
+
+	NSDictionary<NSString *, id> *pending = [self.provider.pendingUserProperties copy];
+	XCTAssertTrue(pending.count == 11, @"Expected 11 pending properties but found %d.", (int)pending.count);
+	XCTAssertTrue([pending[@"property0"] isEqual:@"replaced"], @"Expected the later value to replace the earlier one.");
+	XCTAssertTrue(pending[@"property1"] == [NSNull null], @"Expected the clear to replace the earlier value.");
+
+	[self.provider flushUserProperties];
+	XCTAssertTrue(self.provider.pendingUserProperties.count == 0, @"Expected the flush to apply every pending property.");
+}
+
+- (void)testCoalesceUserProperties200 {
+
+	self.provider.userPropertyFlushInterval = 0.05;
+	[self.provider setUserProperty:@"property" toValue:@"value"];
+	XCTAssertTrue(self.provider.pendingUserProperties.count == 1, @"Expected the property to wait for the flush window.");
+
+	[[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.5]];
+	XCTAssertTrue(self.provider.pendingUserProperties.count == 0, @"Expected the flush window to apply the property.");
+
+	self.provider.userPropertyFlushInterval = 0;
+	[self.provider setUserProperty:@"property" toValue:@"value"];
+	XCTAssertTrue(self.provider.pendingUserProperties.count == 0, @"Expected the property to be applied immediately.");
+}
+
+- (void)testPropertyBudget100 {
+
+	XCTAssertTrue(self.provider.parameterBudget == 20, @"Expected a budget of 20 but found %d.", (int)self.provider.parameterBudget);
+
+	NSMutableDictionary<NSString *, id> *properties = [NSMutableDictionary dictionary];
+	for (NSUInteger i = 0; i < 25; ++i) {
+		properties[[NSString stringWithFormat:@"property%02d", (int)i]] = @[@(i), [@"" stringByPaddingToLength:1000 withString:@"x" startingAtIndex:0]];
+	}
+
+	// The category takes one of the 20 places.
+	[self.provider trackEvent:@"event" category:@"category" properties:properties];
+	XCTAssertTrue(self.provider.droppedPropertyCount == 6, @"Expected 6 dropped properties but found %d.", (int)self.provider.droppedPropertyCount);
+
+	// As do the method and success of a login.
+	[self.provider trackLoginWithMethod:@"method" success:@YES properties:properties];
+	XCTAssertTrue(self.provider.droppedPropertyCount == 13, @"Expected 13 dropped properties but found %d.", (int)self.provider.droppedPropertyCount);
+}
+
 @end
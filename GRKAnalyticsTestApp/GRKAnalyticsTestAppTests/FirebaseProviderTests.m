@@ -0,0 +1,173 @@
+//
+//  FirebaseProviderTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "GRKFirebaseProvider.h"
+
+@interface GRKFirebaseProvider ()
+
+- (nullable NSString *)sanitizeName:(nullable NSString *)name maxLength:(NSUInteger)maxLength;
+- (nullable NSString *)sanitizeString:(nullable NSString *)string maxLength:(NSUInteger)maxLength;
++ (nullable id)optionsWithConfiguration:(NSDictionary *)config;
++ (nullable id)optionsFromFileWithConfiguration:(NSDictionary *)config;
+
+@end
+
+@interface FirebaseProviderTests : XCTestCase
+
+@property (nonatomic,strong) GRKFirebaseProvider *provider;
+
+@end
+
+@implementation FirebaseProviderTests
+
+- (void)setUp {
+    [super setUp];
+	
+	self.provider = [[GRKFirebaseProvider alloc] init];
+}
+
+- (void)tearDown {
+
+	self.provider = nil;
+	
+    [super tearDown];
+}
+
+- (void)testSanitizeNameValid100 {
+
+	NSString *inString = [NSMutableString stringWithString:@"button_tap_2"];
+
+	NSString *outString = [self.provider sanitizeName:inString maxLength:40];
+
+	XCTAssertTrue(outString == inString, @"Expected the valid name to be returned unaltered.");
+}
+
+- (void)testSanitizeName100 {
+
+	NSDictionary<NSString *, NSString *> *expectations = @{
+		@"  button   tap  " : @"button_tap",
+		@"Button-Tap" : @"ButtonTap",
+		@"2fa_enabled" : @"fa_enabled",
+		@"_private" : @"private",
+		@"firebase_event" : @"event",
+		@"Google_event" : @"event",
+		@"ga_ga_event" : @"event",
+		@"ga event" : @"event",
+		@"café latte" : @"caf_latte",
+		@"a b" : @"a_b",
+	};
+
+	[expectations enumerateKeysAndObjectsUsingBlock:^(NSString *inString, NSString *expectedString, BOOL *stop) {
+		NSString *outString = [self.provider sanitizeName:inString maxLength:40];
+		XCTAssertEqualObjects(outString, expectedString, @"Unexpected result for \"%@\".", inString);
+	}];
+}
+
+- (void)testSanitizeNameEmpty100 {
+
+	XCTAssertNil([self.provider sanitizeName:nil maxLength:40]);
+	XCTAssertNil([self.provider sanitizeName:@"" maxLength:40]);
+	XCTAssertNil([self.provider sanitizeName:@"123" maxLength:40]);
+	XCTAssertNil([self.provider sanitizeName:@"google_" maxLength:40]);
+}
+
+- (void)testSanitizeNameLength100 {
+
+	XCTAssertEqualObjects([self.provider sanitizeName:@"abcdefghijklmnopqrstuvwxyz" maxLength:10], @"abcdefghij");
+	XCTAssertEqualObjects([self.provider sanitizeName:@"abc defgh" maxLength:5], @"abc_d");
+	XCTAssertEqualObjects([self.provider sanitizeName:@"abc d" maxLength:3], @"abc");
+}
+
+- (void)testSanitizeString100 {
+
+	NSString *inString = [NSMutableString stringWithString:@"hello-world!"];
+	XCTAssertTrue([self.provider sanitizeString:inString maxLength:100] == inString, @"Expected the valid string to be returned unaltered.");
+
+	XCTAssertEqualObjects([self.provider sanitizeString:@"  hello \n world!  " maxLength:100], @"hello_world!");
+	XCTAssertEqualObjects([self.provider sanitizeString:@"café" maxLength:100], @"café");
+	XCTAssertEqualObjects([self.provider sanitizeString:@"   " maxLength:100], @"");
+	XCTAssertEqualObjects([self.provider sanitizeString:@"abcdefghijklmnopqrstuvwxyz" maxLength:20], @"abcdefghijklmnopqrst");
+	XCTAssertNil([self.provider sanitizeString:nil maxLength:100]);
+}
+
+- (void)testSanitizePerformance100 {
+
+	NSArray<NSString *> *strings = @[@"button_tap", @"screen view", @"Purchase-Completed", @"a reasonably long parameter value with some spaces in it"];
+
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 10000; ++i) {
+			for (NSString *string in strings) {
+				[self.provider sanitizeName:string maxLength:40];
+				[self.provider sanitizeString:string maxLength:100];
+			}
+		}
+	}];
+}
+
+- (NSDictionary *)configuration {
+
+	return @{
+		@"API_KEY": @"AIzaSyTestTestTestTestTestTestTestTest",
+		@"BUNDLE_ID": @"com.levigroker.GRKAnalyticsTestApp",
+		@"CLIENT_ID": @"123456789012-test.apps.googleusercontent.com",
+		@"GCM_SENDER_ID": @"123456789012",
+		@"GOOGLE_APP_ID": @"1:123456789012:ios:0123456789abcdef",
+		@"PLIST_VERSION": @"1",
+		@"PROJECT_ID": @"grkanalytics-test",
+		@"IS_ANALYTICS_ENABLED": @YES,
+	};
+}
+
+- (void)testOptionsWithConfiguration100 {
+
+	NSDictionary *configuration = [self configuration];
+	id inMemory = [GRKFirebaseProvider optionsWithConfiguration:configuration];
+	id fromFile = [GRKFirebaseProvider optionsFromFileWithConfiguration:configuration];
+
+	XCTAssertNotNil(inMemory, @"Expected the configuration to be applied without a file.");
+	XCTAssertNotNil(fromFile, @"Expected the configuration to be read from a file.");
+	for (NSString *property in @[@"APIKey", @"bundleID", @"clientID", @"GCMSenderID", @"googleAppID", @"projectID"]) {
+		XCTAssertEqualObjects([inMemory valueForKey:property], [fromFile valueForKey:property], @"Mismatched %@", property);
+	}
+}
+
+- (void)testOptionsWithUnmappedConfiguration100 {
+
+	NSMutableDictionary *configuration = [[self configuration] mutableCopy];
+	configuration[@"IS_ANALYTICS_ENABLED"] = @NO;
+	XCTAssertNil([GRKFirebaseProvider optionsWithConfiguration:configuration], @"Expected a disabled analytics configuration to need a file.");
+
+	configuration[@"IS_ANALYTICS_ENABLED"] = @YES;
+	configuration[@"SOME_FUTURE_KEY"] = @"value";
+	XCTAssertNil([GRKFirebaseProvider optionsWithConfiguration:configuration], @"Expected an unknown key to need a file.");
+}
+
+- (void)testOptionsPerformanceInMemory {
+
+	NSDictionary *configuration = [self configuration];
+
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 100; ++i) {
+			[GRKFirebaseProvider optionsWithConfiguration:configuration];
+		}
+	}];
+}
+
+- (void)testOptionsPerformanceFromFile {
+
+	NSDictionary *configuration = [self configuration];
+
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 100; ++i) {
+			[GRKFirebaseProvider optionsFromFileWithConfiguration:configuration];
+		}
+	}];
+}
+
+@end
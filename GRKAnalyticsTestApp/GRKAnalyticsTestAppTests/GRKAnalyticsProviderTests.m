@@ -8,6 +8,48 @@
 
 #import <XCTest/XCTest.h>
 #import "GRKAnalyticsProvider.h"
+#import "GRKLayeredDictionary.h"
+
+@interface GRKRecordingProvider : GRKAnalyticsProvider
+
+@property (nonatomic,strong) NSMutableArray *trackedEvents;
+
+@end
+
+@implementation GRKRecordingProvider
+
+- (void)trackEvent:(NSString *)event category:(NSString *)category properties:(NSDictionary *)properties
+{
+	if (!self.trackedEvents) {
+		self.trackedEvents = [NSMutableArray array];
+	}
+	[self.trackedEvents addObject:@[event, category ?: [NSNull null], properties ?: @{}]];
+}
+
+@end
+
+@interface GRKCountingDelegate : NSObject <GRKAnalyticsProviderDelegate>
+
+@property (nonatomic,assign) NSUInteger eventCount;
+@property (nonatomic,assign) NSUInteger propertyCount;
+
+@end
+
+@implementation GRKCountingDelegate
+
+- (NSString *)provider:(GRKAnalyticsProvider *)provider eventForEvent:(NSString *)key
+{
+	self.eventCount += 1;
+	return [key uppercaseString];
+}
+
+- (NSString *)provider:(GRKAnalyticsProvider *)provider propertyForProperty:(NSString *)key
+{
+	self.propertyCount += 1;
+	return [key isEqualToString:@"a"] ? @"alpha" : nil;
+}
+
+@end
 
 @interface GRKAnalyticsProviderTests : XCTestCase
 
@@ -144,4 +186,124 @@
 	XCTAssertTrue(outString.length == expectedLength, @"outString.length (%d) unexpectedly not equal to expectedLength (%d).", (int)outString.length, (int)expectedLength);
 }
 
+- (void)testTrackEvents100 {
+
+	GRKRecordingProvider *provider = [[GRKRecordingProvider alloc] init];
+	NSArray *events = @[
+		[GRKAnalyticsEvent eventWithName:@"first" category:@"a" properties:@{@"key" : @"value"}],
+		[GRKAnalyticsEvent timingEventWithName:@"second" category:nil timeInterval:1.5 properties:nil],
+	];
+
+	[provider trackEvents:events];
+
+	XCTAssertTrue(provider.trackedEvents.count == 2, @"Expected 2 events but found %d.", (int)provider.trackedEvents.count);
+	XCTAssertEqualObjects(provider.trackedEvents[0], (@[@"first", @"a", @{@"key" : @"value"}]));
+	XCTAssertEqualObjects(provider.trackedEvents[1], (@[@"second", [NSNull null], @{GRKAnalyticsEventKeyEventDuration : @1.5}]));
+}
+
+- (void)testDeliveryPlan100 {
+
+	GRKCountingDelegate *delegate = [[GRKCountingDelegate alloc] init];
+	self.provider.delegate = delegate;
+
+	GRKDeliveryPlan *plan = [self.provider deliveryPlanForEvent:@"event" properties:@{@"a": @1, @"b": @2}];
+	XCTAssertEqualObjects(plan.event, @"EVENT");
+	XCTAssertEqualObjects([plan propertiesForProperties:@{@"a": @1, @"b": @2}], (@{@"alpha": @1, @"b": @2}));
+
+	// The same event and key set, with different values, uses the cached plan.
+	GRKDeliveryPlan *cachedPlan = [self.provider deliveryPlanForEvent:[@"eve" stringByAppendingString:@"nt"] properties:@{@"b": @3, @"a": @4}];
+	XCTAssertTrue(cachedPlan == plan, @"Expected the cached plan.");
+	XCTAssertTrue(delegate.eventCount == 1, @"Expected 1 event translation but found %d.", (int)delegate.eventCount);
+	XCTAssertTrue(delegate.propertyCount == 2, @"Expected 2 property translations but found %d.", (int)delegate.propertyCount);
+
+	// A different key set makes a new plan.
+	GRKDeliveryPlan *otherPlan = [self.provider deliveryPlanForEvent:@"event" properties:@{@"a": @1}];
+	XCTAssertTrue(otherPlan != plan, @"Unexpectedly received the cached plan for a different key set.");
+
+	[self.provider invalidateDeliveryPlans];
+	GRKDeliveryPlan *newPlan = [self.provider deliveryPlanForEvent:@"event" properties:@{@"a": @1, @"b": @2}];
+	XCTAssertTrue(newPlan != plan, @"Unexpectedly received the cached plan after invalidation.");
+}
+
+- (void)testDeliveryPlanWithoutDelegate100 {
+
+	NSDictionary *properties = @{@"a": @1};
+	GRKDeliveryPlan *plan = [self.provider deliveryPlanForEvent:@"event" properties:properties];
+
+	XCTAssertEqualObjects(plan.event, @"event");
+	XCTAssertTrue([plan propertiesForProperties:properties] == properties, @"Expected the properties to be returned unaltered.");
+}
+
+- (void)testParameterBudget100 {
+
+	self.provider.parameterBudget = 3;
+	self.provider.parameterPriorityKeys = @[@"schema", @"missing"];
+
+	NSDictionary *superProperties = @{@"s1": @1, @"s2": @2, @"schema": @3};
+	NSDictionary *eventProperties = @{@"e2": @4, @"e1": @5};
+	NSDictionary *properties = [GRKLayeredDictionary dictionaryWithTop:eventProperties base:superProperties];
+
+	// The priority key first, then the event's own properties in key order; super properties don't fit.
+	GRKDeliveryPlan *plan = [self.provider deliveryPlanForEvent:@"event" properties:properties];
+	XCTAssertEqualObjects(plan.admittedKeys, ([NSSet setWithArray:@[@"schema", @"e1", @"e2"]]));
+	XCTAssertTrue(plan.droppedPropertyCount == 2, @"Expected 2 dropped properties but found %d.", (int)plan.droppedPropertyCount);
+	XCTAssertEqualObjects([plan propertiesForProperties:properties], (@{@"schema": @3, @"e1": @5, @"e2": @4}));
+
+	// Reserving a parameter leaves room for one less property.
+	GRKDeliveryPlan *reservedPlan = [self.provider deliveryPlanForEvent:@"event" properties:properties reservedParameterCount:1];
+	XCTAssertTrue(reservedPlan != plan, @"Unexpectedly received the plan made without a reservation.");
+	XCTAssertEqualObjects(reservedPlan.admittedKeys, ([NSSet setWithArray:@[@"schema", @"e1"]]));
+
+	// Within the budget, everything is delivered as is.
+	GRKDeliveryPlan *smallPlan = [self.provider deliveryPlanForEvent:@"event" properties:eventProperties];
+	XCTAssertNil(smallPlan.admittedKeys);
+	XCTAssertTrue([smallPlan propertiesForProperties:eventProperties] == eventProperties, @"Expected the properties to be returned unaltered.");
+
+	[self.provider recordDroppedProperties:plan.droppedPropertyCount];
+	[self.provider recordDroppedProperties:reservedPlan.droppedPropertyCount];
+	XCTAssertTrue(self.provider.droppedPropertyCount == 5, @"Expected 5 dropped properties but found %d.", (int)self.provider.droppedPropertyCount);
+}
+
+- (void)testParameterBudgetLayers100 {
+
+	self.provider.parameterBudget = 2;
+
+	// The same keys, split differently between the event's own properties and super properties.
+	NSDictionary *properties = [GRKLayeredDictionary dictionaryWithTop:@{@"b": @1, @"c": @2} base:@{@"a": @3}];
+	NSDictionary *swappedProperties = [GRKLayeredDictionary dictionaryWithTop:@{@"a": @3} base:@{@"b": @1, @"c": @2}];
+
+	GRKDeliveryPlan *plan = [self.provider deliveryPlanForEvent:@"event" properties:properties];
+	XCTAssertEqualObjects(plan.admittedKeys, ([NSSet setWithArray:@[@"b", @"c"]]));
+
+	GRKDeliveryPlan *swappedPlan = [self.provider deliveryPlanForEvent:@"event" properties:swappedProperties];
+	XCTAssertTrue(swappedPlan != plan, @"Unexpectedly received the plan made for a different split of the properties.");
+	XCTAssertEqualObjects(swappedPlan.admittedKeys, ([NSSet setWithArray:@[@"a", @"b"]]));
+
+	// The same split again finds the cached plan.
+	NSDictionary *sameProperties = [GRKLayeredDictionary dictionaryWithTop:@{@"c": @4, @"b": @5} base:@{@"a": @6}];
+	XCTAssertTrue([self.provider deliveryPlanForEvent:@"event" properties:sameProperties] == plan, @"Expected the cached plan.");
+}
+
+- (void)testDelegateTranslations100 {
+
+	GRKCountingDelegate *delegate = [[GRKCountingDelegate alloc] init];
+	self.provider.delegate = delegate;
+
+	for (NSUInteger i = 0; i < 3; ++i) {
+		XCTAssertEqualObjects([self.provider delegatePropertyForProperty:@"a"], @"alpha");
+		XCTAssertEqualObjects([self.provider delegatePropertyForProperty:@"b"], @"b");
+		XCTAssertEqualObjects([self.provider delegateEventForEvent:@"event"], @"EVENT");
+	}
+	XCTAssertTrue(delegate.propertyCount == 2, @"Expected 2 property translations but found %d.", (int)delegate.propertyCount);
+	XCTAssertTrue(delegate.eventCount == 1, @"Expected 1 event translation but found %d.", (int)delegate.eventCount);
+
+	NSDictionary *properties = [self.provider delegatePropertiesForProperties:@{@"a": @1, @"b": @2}];
+	XCTAssertEqualObjects(properties, (@{@"alpha": @1, @"b": @2}));
+	XCTAssertTrue(delegate.propertyCount == 2, @"Expected 2 property translations but found %d.", (int)delegate.propertyCount);
+
+	[self.provider invalidateDelegateTranslations];
+	XCTAssertEqualObjects([self.provider delegatePropertyForProperty:@"a"], @"alpha");
+	XCTAssertTrue(delegate.propertyCount == 3, @"Expected 3 property translations but found %d.", (int)delegate.propertyCount);
+}
+
 @end
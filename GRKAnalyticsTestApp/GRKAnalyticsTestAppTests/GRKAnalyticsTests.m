@@ -0,0 +1,261 @@
+//
+//  GRKAnalyticsTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "GRKAnalytics.h"
+
+// Logs each call as `event:<name>` or `property:<name>=<value>`, and notes whether it was called on `trackingThread`.
+// The properties of the last event of each name and category are kept under `<name>/<category>`.
+@interface GRKLoggingProvider : GRKAnalyticsProvider
+
+@property (atomic, weak) NSThread *trackingThread;
+@property (atomic, assign) BOOL calledOnTrackingThread;
+
+- (NSArray<NSString *> *)log;
+- (NSDictionary<NSString *, NSDictionary *> *)eventProperties;
+
+@end
+
+@interface GRKLoggingProvider ()
+
+@property (nonatomic, strong) NSMutableArray<NSString *> *entries;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSDictionary *> *properties;
+
+@end
+
+@implementation GRKLoggingProvider
+
+- (instancetype)init {
+
+	if ((self = [super init])) {
+		_entries = [NSMutableArray array];
+		_properties = [NSMutableDictionary dictionary];
+	}
+
+	return self;
+}
+
+- (NSArray<NSString *> *)log {
+
+	@synchronized (self.entries) {
+		return [self.entries copy];
+	}
+}
+
+- (NSDictionary<NSString *, NSDictionary *> *)eventProperties {
+
+	@synchronized (self.entries) {
+		return [self.properties copy];
+	}
+}
+
+- (void)addEntry:(NSString *)entry {
+
+	if ([NSThread currentThread] == self.trackingThread) {
+		self.calledOnTrackingThread = YES;
+	}
+	@synchronized (self.entries) {
+		[self.entries addObject:entry];
+	}
+}
+
+- (void)trackEvent:(NSString *)event category:(NSString *)category properties:(NSDictionary *)properties {
+
+	[self addEntry:[NSString stringWithFormat:@"event:%@", event]];
+	@synchronized (self.entries) {
+		self.properties[[NSString stringWithFormat:@"%@/%@", event, category]] = properties ?: @{};
+	}
+}
+
+- (void)setUserProperty:(NSString *)property toValue:(id)value {
+
+	[self addEntry:[NSString stringWithFormat:@"property:%@=%@", property, value]];
+}
+
+@end
+
+@interface GRKAnalyticsTests : XCTestCase
+
+@end
+
+@implementation GRKAnalyticsTests
+
+- (void)tearDown {
+
+	[GRKAnalytics waitForPendingDeliveriesWithTimeout:10.0];
+	for (GRKAnalyticsProvider *provider in [GRKAnalytics orderedProviders]) {
+		[GRKAnalytics removeProvider:provider];
+	}
+	[GRKAnalytics setAsynchronousDeliveryEnabled:NO];
+	[GRKAnalytics setDeliveryOverflowPolicy:GRKEventRingBufferOverflowPolicyDropNewest];
+	[GRKAnalytics setTimingAggregationInterval:0];
+
+	[super tearDown];
+}
+
+- (void)testAsynchronousDelivery100 {
+
+	NSMutableArray<GRKLoggingProvider *> *providers = [NSMutableArray array];
+	for (NSUInteger i = 0; i < 3; ++i) {
+		GRKLoggingProvider *provider = [[GRKLoggingProvider alloc] init];
+		provider.trackingThread = [NSThread currentThread];
+		[providers addObject:provider];
+		[GRKAnalytics addProvider:provider];
+	}
+	[GRKAnalytics setAsynchronousDeliveryEnabled:YES];
+
+	NSMutableArray<NSString *> *expected = [NSMutableArray array];
+	for (NSUInteger i = 0; i < 100; ++i) {
+		NSString *event = [NSString stringWithFormat:@"%d", (int)i];
+		[GRKAnalytics trackEvent:event];
+		[expected addObject:[@"event:" stringByAppendingString:event]];
+	}
+
+	XCTAssertTrue([GRKAnalytics waitForPendingDeliveriesWithTimeout:10.0], @"Timed out waiting for deliveries.");
+
+	for (GRKLoggingProvider *provider in providers) {
+		XCTAssertEqualObjects(provider.log, expected);
+		XCTAssertFalse(provider.calledOnTrackingThread, @"Provider unexpectedly called on the tracking thread.");
+	}
+}
+
+- (void)testConcurrentProviders100 {
+
+	NSUInteger const providerCount = 64;
+	NSMutableArray<GRKLoggingProvider *> *providers = [NSMutableArray array];
+	for (NSUInteger i = 0; i < providerCount; ++i) {
+		[providers addObject:[[GRKLoggingProvider alloc] init]];
+	}
+
+	// Odd providers are added and removed while events are tracked; even ones are added and kept.
+	dispatch_apply(providerCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+		GRKLoggingProvider *provider = providers[i];
+		[GRKAnalytics addProvider:provider];
+		[GRKAnalytics trackEvent:[NSString stringWithFormat:@"%d", (int)i]];
+		if (i % 2 == 1) {
+			[GRKAnalytics removeProvider:provider];
+		}
+	});
+
+	NSArray<GRKAnalyticsProvider *> *orderedProviders = [GRKAnalytics orderedProviders];
+	XCTAssertTrue(orderedProviders.count == providerCount / 2, @"Expected %d providers but found %d.", (int)(providerCount / 2), (int)orderedProviders.count);
+	NSSet *expected = [NSSet setWithArray:[providers objectsAtIndexes:[providers indexesOfObjectsPassingTest:^BOOL(GRKLoggingProvider *provider, NSUInteger index, BOOL *stop) {
+		return index % 2 == 0;
+	}]]];
+	XCTAssertEqualObjects([NSSet setWithArray:orderedProviders], expected);
+
+	// Providers are kept in the order they were added, however they were added.
+	GRKLoggingProvider *last = [[GRKLoggingProvider alloc] init];
+	[GRKAnalytics addProvider:last];
+	[GRKAnalytics removeProvider:orderedProviders.firstObject];
+	[GRKAnalytics addProvider:orderedProviders.firstObject];
+	NSMutableArray<GRKAnalyticsProvider *> *expectedOrder = [[orderedProviders subarrayWithRange:NSMakeRange(1, orderedProviders.count - 1)] mutableCopy];
+	[expectedOrder addObject:last];
+	[expectedOrder addObject:orderedProviders.firstObject];
+	for (NSUInteger i = 0; i < 3; ++i) {
+		XCTAssertEqualObjects([GRKAnalytics orderedProviders], expectedOrder);
+	}
+
+	// Every provider kept receives every event tracked after it was added, so the last one added receives this one.
+	[GRKAnalytics trackEvent:@"final"];
+	for (GRKAnalyticsProvider *provider in expectedOrder) {
+		XCTAssertEqualObjects(((GRKLoggingProvider *)provider).log.lastObject, @"event:final");
+	}
+}
+
+- (void)testTimingSummaries100 {
+
+	GRKLoggingProvider *provider = [[GRKLoggingProvider alloc] init];
+	[GRKAnalytics addProvider:provider];
+	// Long enough that only the explicit flush below delivers summaries.
+	[GRKAnalytics setTimingAggregationInterval:3600.0];
+
+	dispatch_apply(4, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+		for (NSUInteger i = 0; i < 100; ++i) {
+			[GRKAnalytics trackTimeEndForTimer:[GRKAnalytics startTimer] event:@"render" category:@"cell" properties:@{@"ignored": @YES}];
+			[GRKAnalytics trackTimeEndForTimer:[GRKAnalytics startTimer] event:@"lookup" category:nil properties:nil];
+		}
+	});
+	XCTAssertTrue(provider.log.count == 0, @"Expected the timings to be aggregated, not delivered.");
+
+	[GRKAnalytics flushTimingSummaries];
+
+	// One summary per event name and category, merged from every thread.
+	NSArray<NSString *> *expectedLog = @[@"event:render", @"event:lookup"];
+	XCTAssertEqualObjects([NSSet setWithArray:provider.log], [NSSet setWithArray:expectedLog]);
+	XCTAssertTrue(provider.log.count == expectedLog.count, @"Expected %d summaries but found %d.", (int)expectedLog.count, (int)provider.log.count);
+
+	NSArray<NSString *> *ordered = @[kGRKAnalyticsTimingSummaryPropertyMinimum, kGRKAnalyticsTimingSummaryPropertyP50, kGRKAnalyticsTimingSummaryPropertyP90, kGRKAnalyticsTimingSummaryPropertyP99, kGRKAnalyticsTimingSummaryPropertyP999, kGRKAnalyticsTimingSummaryPropertyMaximum];
+	for (NSString *key in @[@"render/cell", @"lookup/(null)"]) {
+		NSDictionary *summary = provider.eventProperties[key];
+		XCTAssertTrue([summary[kGRKAnalyticsTimingSummaryPropertyCount] integerValue] == 400, @"Expected 400 timings in %@ but found %@.", key, summary[kGRKAnalyticsTimingSummaryPropertyCount]);
+		XCTAssertNil(summary[@"ignored"], @"Expected the timing's own properties to be left out of %@.", key);
+		for (NSUInteger i = 1; i < ordered.count; ++i) {
+			XCTAssertTrue([summary[ordered[i - 1]] doubleValue] <= [summary[ordered[i]] doubleValue], @"Expected %@ <= %@ in %@: %@", ordered[i - 1], ordered[i], key, summary);
+		}
+	}
+
+	// Flushing again has nothing to summarise.
+	[GRKAnalytics flushTimingSummaries];
+	XCTAssertTrue(provider.log.count == expectedLog.count, @"Expected no further summaries.");
+}
+
+- (void)testDropOldestKeepsConfiguration100 {
+
+	GRKLoggingProvider *provider = [[GRKLoggingProvider alloc] init];
+	[GRKAnalytics addProvider:provider];
+	[GRKAnalytics setAsynchronousDeliveryEnabled:YES];
+	[GRKAnalytics setDeliveryOverflowPolicy:GRKEventRingBufferOverflowPolicyDropOldest];
+
+	// Events may be evicted under pressure, but every property change must arrive, in order with the events around it.
+	// Ordering is checked by the index of each entry: event `i` is `2i`, the property set after it `2i + 1`.
+	NSUInteger const eventCount = 20000;
+	for (NSUInteger i = 0; i < eventCount; ++i) {
+		[GRKAnalytics trackEvent:[NSString stringWithFormat:@"%d", (int)(2 * i)]];
+		if (i % 100 == 0) {
+			[GRKAnalytics setUserProperty:@"index" toValue:@(2 * i + 1)];
+		}
+	}
+
+	XCTAssertTrue([GRKAnalytics waitForPendingDeliveriesWithTimeout:30.0], @"Timed out waiting for deliveries.");
+
+	NSInteger previous = -1;
+	NSUInteger propertyCount = 0;
+	for (NSString *entry in provider.log) {
+		NSRange separator = [entry rangeOfCharacterFromSet:[NSCharacterSet characterSetWithCharactersInString:@":="] options:NSBackwardsSearch];
+		NSInteger index = [entry substringFromIndex:separator.location + 1].integerValue;
+		XCTAssertTrue(index > previous, @"Entry %@ delivered out of order.", entry);
+		previous = index;
+		if ([entry hasPrefix:@"property:"]) {
+			++propertyCount;
+		}
+	}
+	XCTAssertTrue(propertyCount == eventCount / 100, @"Expected %d property changes but found %d.", (int)(eventCount / 100), (int)propertyCount);
+}
+
+- (void)testSpanEndedOnAnotherThread100 {
+
+	GRKSpan span = [GRKAnalytics startSpan:@"load"];
+	XCTAssertTrue([GRKAnalytics currentSpanContext].spanID == span.context.spanID, @"Expected the span to be current.");
+
+	XCTestExpectation *expectation = [self expectationWithDescription:@"end"];
+	dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+		[GRKAnalytics endSpan:span];
+		[expectation fulfill];
+	});
+	[self waitForExpectationsWithTimeout:5.0 handler:nil];
+
+	// This thread still holds the ended span's context, but must not parent new spans with it.
+	GRKSpan next = [GRKAnalytics startSpan:@"next"];
+	XCTAssertTrue(next.parentSpanID == 0, @"Expected a new root, not a child of the ended span.");
+	XCTAssertTrue(next.context.traceID != span.context.traceID, @"Expected a new trace.");
+	[GRKAnalytics endSpan:next];
+	XCTAssertTrue([GRKAnalytics currentSpanContext].traceID == 0, @"Expected no current span.");
+}
+
+@end
@@ -0,0 +1,151 @@
+//
+//  GRKEventRingBufferTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "GRKEventRingBuffer.h"
+
+@interface GRKEventRingBufferTests : XCTestCase
+
+@end
+
+@implementation GRKEventRingBufferTests
+
+- (void)testCapacity100 {
+
+	GRKEventRingBuffer *buffer = [[GRKEventRingBuffer alloc] initWithCapacity:5];
+
+	XCTAssertTrue(buffer.capacity == 8, @"Expected capacity 8 but found %d.", (int)buffer.capacity);
+}
+
+- (void)testOrder100 {
+
+	GRKEventRingBuffer *buffer = [[GRKEventRingBuffer alloc] initWithCapacity:4];
+
+	for (NSUInteger i = 0; i < 4; ++i) {
+		XCTAssertTrue([buffer enqueue:@(i)], @"Unexpectedly failed to enqueue %d.", (int)i);
+	}
+
+	for (NSUInteger i = 0; i < 4; ++i) {
+		NSNumber *number = [buffer dequeue];
+		XCTAssertEqualObjects(number, @(i));
+	}
+
+	XCTAssertNil([buffer dequeue], @"Unexpectedly dequeued from an empty buffer.");
+}
+
+- (void)testOverflowDropNewest100 {
+
+	GRKEventRingBuffer *buffer = [[GRKEventRingBuffer alloc] initWithCapacity:2];
+	buffer.overflowPolicy = GRKEventRingBufferOverflowPolicyDropNewest;
+
+	XCTAssertTrue([buffer enqueue:@1]);
+	XCTAssertTrue([buffer enqueue:@2]);
+	XCTAssertFalse([buffer enqueue:@3], @"Unexpectedly enqueued into a full buffer.");
+
+	XCTAssertTrue(buffer.overflowCount == 1, @"Expected overflowCount 1 but found %d.", (int)buffer.overflowCount);
+	XCTAssertTrue(buffer.droppedCount == 1, @"Expected droppedCount 1 but found %d.", (int)buffer.droppedCount);
+	XCTAssertEqualObjects([buffer dequeue], @1);
+	XCTAssertEqualObjects([buffer dequeue], @2);
+}
+
+- (void)testOverflowDropOldest100 {
+
+	GRKEventRingBuffer *buffer = [[GRKEventRingBuffer alloc] initWithCapacity:2];
+	buffer.overflowPolicy = GRKEventRingBufferOverflowPolicyDropOldest;
+	NSMutableArray *discarded = [NSMutableArray array];
+	buffer.discardHandler = ^(id object) {
+		[discarded addObject:object];
+	};
+
+	XCTAssertTrue([buffer enqueue:@1]);
+	XCTAssertTrue([buffer enqueue:@2]);
+	XCTAssertTrue([buffer enqueue:@3], @"Unexpectedly failed to enqueue into a full buffer.");
+
+	XCTAssertEqualObjects(discarded, @[@1]);
+	XCTAssertTrue(buffer.droppedCount == 1, @"Expected droppedCount 1 but found %d.", (int)buffer.droppedCount);
+	XCTAssertEqualObjects([buffer dequeue], @2);
+	XCTAssertEqualObjects([buffer dequeue], @3);
+}
+
+- (void)testPositions100 {
+
+	GRKEventRingBuffer *buffer = [[GRKEventRingBuffer alloc] initWithCapacity:2];
+	buffer.overflowPolicy = GRKEventRingBufferOverflowPolicyDropOldest;
+
+	XCTAssertTrue(buffer.nextPosition == 0, @"Expected position 0 but found %llu.", buffer.nextPosition);
+	[buffer enqueue:@0];
+	[buffer enqueue:@1];
+	[buffer enqueue:@2];
+	XCTAssertTrue(buffer.nextPosition == 3, @"Expected position 3 but found %llu.", buffer.nextPosition);
+
+	// The object discarded to make room keeps its position; the survivors keep theirs.
+	NSMutableArray *positions = [NSMutableArray array];
+	[buffer drainWithPositions:^(id object, uint64_t position) {
+		XCTAssertEqualObjects(object, @(position));
+		[positions addObject:@(position)];
+	}];
+	XCTAssertEqualObjects(positions, (@[@1, @2]));
+}
+
+- (void)testOverflowBlock100 {
+
+	GRKEventRingBuffer *buffer = [[GRKEventRingBuffer alloc] initWithCapacity:2];
+	buffer.overflowPolicy = GRKEventRingBufferOverflowPolicyBlock;
+	buffer.blockTimeout = 0.01;
+
+	XCTAssertTrue([buffer enqueue:@1]);
+	XCTAssertTrue([buffer enqueue:@2]);
+	XCTAssertFalse([buffer enqueue:@3], @"Unexpectedly enqueued into a full buffer.");
+	XCTAssertTrue(buffer.droppedCount == 1, @"Expected droppedCount 1 but found %d.", (int)buffer.droppedCount);
+}
+
+- (void)testOverflowBlock200 {
+
+	GRKEventRingBuffer *buffer = [[GRKEventRingBuffer alloc] initWithCapacity:2];
+	buffer.overflowPolicy = GRKEventRingBufferOverflowPolicyBlock;
+	buffer.blockTimeout = 5;
+
+	XCTAssertTrue([buffer enqueue:@1]);
+	XCTAssertTrue([buffer enqueue:@2]);
+
+	dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.05 * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+		[buffer dequeue];
+	});
+
+	XCTAssertTrue([buffer enqueue:@3], @"Unexpectedly failed to enqueue after room was made.");
+	XCTAssertTrue(buffer.droppedCount == 0, @"Expected droppedCount 0 but found %d.", (int)buffer.droppedCount);
+}
+
+- (void)testConcurrentProducers100 {
+
+	NSUInteger const producerCount = 8;
+	NSUInteger const objectCount = 10000;
+	GRKEventRingBuffer *buffer = [[GRKEventRingBuffer alloc] initWithCapacity:producerCount * objectCount];
+
+	dispatch_apply(producerCount, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^(size_t producer) {
+		for (NSUInteger i = 0; i < objectCount; ++i) {
+			[buffer enqueue:@[@(producer), @(i)]];
+		}
+	});
+
+	// Each producer's objects must come out in the order that producer enqueued them.
+	NSMutableArray *next = [NSMutableArray array];
+	for (NSUInteger i = 0; i < producerCount; ++i) {
+		[next addObject:@0];
+	}
+
+	NSUInteger count = [buffer drain:^(NSArray *object) {
+		NSUInteger producer = [object[0] unsignedIntegerValue];
+		XCTAssertEqualObjects(object[1], next[producer]);
+		next[producer] = @([next[producer] unsignedIntegerValue] + 1);
+	}];
+
+	XCTAssertTrue(count == producerCount * objectCount, @"Expected %d objects but found %d.", (int)(producerCount * objectCount), (int)count);
+}
+
+@end
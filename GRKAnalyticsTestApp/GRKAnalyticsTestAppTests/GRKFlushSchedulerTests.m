@@ -0,0 +1,167 @@
+//
+//  GRKFlushSchedulerTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "GRKFlushScheduler.h"
+
+// Sends up to `stepSize` of its pending hits per step, asynchronously. A negative `pending` count never completes a step.
+@interface GRKTestFlushable : NSObject <GRKFlushable>
+
+@property (atomic, assign) NSInteger pending;
+@property (atomic, assign) NSUInteger stepSize;
+@property (atomic, assign) BOOL fails;
+
+@end
+
+@implementation GRKTestFlushable
+
+- (void)flushWithHitLimit:(NSUInteger)hitLimit completion:(void (^)(GRKFlushStepResult result, NSUInteger flushedCount))completion {
+
+	if (self.pending < 0) {
+		return;
+	}
+
+	dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+		if (self.fails) {
+			completion(GRKFlushStepResultFailed, 0);
+			return;
+		}
+		NSUInteger count = MIN(MIN(self.stepSize, hitLimit), (NSUInteger)self.pending);
+		self.pending -= count;
+		completion(self.pending > 0 ? GRKFlushStepResultMore : GRKFlushStepResultDone, count);
+	});
+}
+
+- (NSUInteger)pendingHitCount {
+
+	return self.pending < 0 ? NSNotFound : (NSUInteger)self.pending;
+}
+
+@end
+
+@interface GRKFlushSchedulerTests : XCTestCase
+
+@end
+
+@implementation GRKFlushSchedulerTests
+
+- (GRKFlushResult *)flushScheduler:(GRKFlushScheduler *)scheduler timeBudget:(NSTimeInterval)timeBudget hitBudget:(NSUInteger)hitBudget cancellationToken:(GRKFlushCancellationToken *)cancellationToken {
+
+	__block GRKFlushResult *flushResult = nil;
+	XCTestExpectation *expectation = [self expectationWithDescription:@"flush"];
+	[scheduler flushWithTimeBudget:timeBudget hitBudget:hitBudget cancellationToken:cancellationToken completion:^(GRKFlushResult *result) {
+		flushResult = result;
+		[expectation fulfill];
+	}];
+	[self waitForExpectationsWithTimeout:5.0 handler:nil];
+
+	return flushResult;
+}
+
+- (void)testComplete100 {
+
+	GRKFlushScheduler *scheduler = [[GRKFlushScheduler alloc] init];
+	GRKTestFlushable *first = [[GRKTestFlushable alloc] init];
+	first.pending = 25;
+	first.stepSize = 10;
+	GRKTestFlushable *second = [[GRKTestFlushable alloc] init];
+	second.pending = 3;
+	second.stepSize = 10;
+	[scheduler registerFlushable:first];
+	[scheduler registerFlushable:second];
+	[scheduler registerFlushable:first];
+
+	GRKFlushResult *result = [self flushScheduler:scheduler timeBudget:5.0 hitBudget:NSUIntegerMax cancellationToken:nil];
+
+	XCTAssertTrue(result.status == GRKFlushStatusComplete, @"Unexpected status %d.", (int)result.status);
+	XCTAssertTrue(result.flushedCount == 28, @"Expected 28 flushed but found %d.", (int)result.flushedCount);
+	XCTAssertTrue(result.remainingCount == 0, @"Expected 0 remaining but found %d.", (int)result.remainingCount);
+}
+
+- (void)testHitBudget100 {
+
+	GRKFlushScheduler *scheduler = [[GRKFlushScheduler alloc] init];
+	GRKTestFlushable *flushable = [[GRKTestFlushable alloc] init];
+	flushable.pending = 100;
+	flushable.stepSize = 20;
+	[scheduler registerFlushable:flushable];
+
+	GRKFlushResult *result = [self flushScheduler:scheduler timeBudget:5.0 hitBudget:30 cancellationToken:nil];
+
+	XCTAssertTrue(result.status == GRKFlushStatusHitBudgetExhausted, @"Unexpected status %d.", (int)result.status);
+	XCTAssertTrue(result.flushedCount == 30, @"Expected 30 flushed but found %d.", (int)result.flushedCount);
+	XCTAssertTrue(result.remainingCount == 70, @"Expected 70 remaining but found %d.", (int)result.remainingCount);
+}
+
+- (void)testDeadline100 {
+
+	GRKFlushScheduler *scheduler = [[GRKFlushScheduler alloc] init];
+	GRKTestFlushable *flushable = [[GRKTestFlushable alloc] init];
+	flushable.pending = -1;
+	[scheduler registerFlushable:flushable];
+
+	GRKFlushResult *result = [self flushScheduler:scheduler timeBudget:0.1 hitBudget:NSUIntegerMax cancellationToken:nil];
+
+	XCTAssertTrue(result.status == GRKFlushStatusDeadlineReached, @"Unexpected status %d.", (int)result.status);
+	XCTAssertTrue(result.remainingCount == NSNotFound, @"Expected an unknown remaining count.");
+}
+
+- (void)testCancel100 {
+
+	GRKFlushScheduler *scheduler = [[GRKFlushScheduler alloc] init];
+	GRKTestFlushable *flushable = [[GRKTestFlushable alloc] init];
+	flushable.pending = -1;
+	[scheduler registerFlushable:flushable];
+
+	GRKFlushCancellationToken *token = [[GRKFlushCancellationToken alloc] init];
+	dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+		[token cancel];
+	});
+
+	GRKFlushResult *result = [self flushScheduler:scheduler timeBudget:60.0 hitBudget:NSUIntegerMax cancellationToken:token];
+
+	XCTAssertTrue(result.status == GRKFlushStatusCancelled, @"Unexpected status %d.", (int)result.status);
+}
+
+- (void)testFailure100 {
+
+	GRKFlushScheduler *scheduler = [[GRKFlushScheduler alloc] init];
+	GRKTestFlushable *failing = [[GRKTestFlushable alloc] init];
+	failing.pending = 5;
+	failing.fails = YES;
+	GRKTestFlushable *flushable = [[GRKTestFlushable alloc] init];
+	flushable.pending = 5;
+	flushable.stepSize = 5;
+	[scheduler registerFlushable:failing];
+	[scheduler registerFlushable:flushable];
+
+	GRKFlushResult *result = [self flushScheduler:scheduler timeBudget:5.0 hitBudget:NSUIntegerMax cancellationToken:nil];
+
+	XCTAssertTrue(result.status == GRKFlushStatusComplete, @"Unexpected status %d.", (int)result.status);
+	XCTAssertTrue(result.failedCount == 1, @"Expected 1 failure but found %d.", (int)result.failedCount);
+	XCTAssertTrue(result.flushedCount == 5, @"Expected 5 flushed but found %d.", (int)result.flushedCount);
+	XCTAssertTrue(result.remainingCount == 5, @"Expected 5 remaining but found %d.", (int)result.remainingCount);
+}
+
+- (void)testUnregister100 {
+
+	GRKFlushScheduler *scheduler = [[GRKFlushScheduler alloc] init];
+	GRKTestFlushable *flushable = [[GRKTestFlushable alloc] init];
+	flushable.pending = 5;
+	flushable.stepSize = 5;
+	[scheduler registerFlushable:flushable];
+	[scheduler unregisterFlushable:flushable];
+
+	GRKFlushResult *result = [self flushScheduler:scheduler timeBudget:5.0 hitBudget:NSUIntegerMax cancellationToken:nil];
+
+	XCTAssertTrue(result.status == GRKFlushStatusComplete, @"Unexpected status %d.", (int)result.status);
+	XCTAssertTrue(result.flushedCount == 0, @"Expected 0 flushed but found %d.", (int)result.flushedCount);
+	XCTAssertTrue(flushable.pending == 5, @"Expected the unregistered flushable to be left alone.");
+}
+
+@end
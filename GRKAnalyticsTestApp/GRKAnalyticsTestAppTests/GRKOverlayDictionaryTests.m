@@ -0,0 +1,105 @@
+//
+//  GRKOverlayDictionaryTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "GRKOverlayDictionary.h"
+
+@interface GRKOverlayDictionaryTests : XCTestCase
+
+@end
+
+@implementation GRKOverlayDictionaryTests
+
+- (void)testSingleOverride100 {
+
+	NSDictionary *base = @{@"a": @1, @"b": @2};
+
+	NSDictionary *added = [GRKOverlayDictionary dictionaryWithBase:base object:@3 forKey:@"c"];
+	XCTAssertTrue(added.count == 3, @"Expected count 3 but found %d.", (int)added.count);
+	XCTAssertEqualObjects(added, (@{@"a": @1, @"b": @2, @"c": @3}));
+
+	NSDictionary *replaced = [GRKOverlayDictionary dictionaryWithBase:base object:@3 forKey:@"b"];
+	XCTAssertTrue(replaced.count == 2, @"Expected count 2 but found %d.", (int)replaced.count);
+	XCTAssertEqualObjects(replaced, (@{@"a": @1, @"b": @3}));
+}
+
+- (void)testNilObjectHidesKey100 {
+
+	NSDictionary *base = @{@"a": @1, @"b": @2};
+
+	NSDictionary *hidden = [GRKOverlayDictionary dictionaryWithBase:base object:nil forKey:@"b"];
+	XCTAssertTrue(hidden.count == 1, @"Expected count 1 but found %d.", (int)hidden.count);
+	XCTAssertEqualObjects(hidden, @{@"a": @1});
+	XCTAssertEqualObjects(hidden.allKeys, @[@"a"]);
+
+	NSDictionary *absent = [GRKOverlayDictionary dictionaryWithBase:base object:nil forKey:@"c"];
+	XCTAssertEqualObjects(absent, base);
+}
+
+- (void)testMultipleOverrides100 {
+
+	id keys[] = {@"b", @"c", nil, @"b", @"a"};
+	id objects[] = {@3, @4, @5, @6, nil};
+
+	NSDictionary *properties = [GRKOverlayDictionary dictionaryWithBase:@{@"a": @1, @"b": @2} objects:objects forKeys:keys count:5];
+
+	XCTAssertTrue(properties.count == 2, @"Expected count 2 but found %d.", (int)properties.count);
+	XCTAssertEqualObjects(properties, (@{@"b": @6, @"c": @4}));
+	XCTAssertEqualObjects([NSSet setWithArray:properties.allKeys], ([NSSet setWithArray:@[@"b", @"c"]]));
+}
+
+- (void)testTooManyOverrides100 {
+
+	NSUInteger count = GRKOverlayDictionaryMaximumOverrides + 1;
+	NSMutableArray *keys = [NSMutableArray array];
+	NSMutableDictionary *expected = [NSMutableDictionary dictionaryWithDictionary:@{@"base": @0}];
+	for (NSUInteger i = 0; i < count; ++i) {
+		NSString *key = [NSString stringWithFormat:@"key%d", (int)i];
+		[keys addObject:key];
+		expected[key] = @(i);
+	}
+
+	id keyArray[count];
+	id objectArray[count];
+	for (NSUInteger i = 0; i < count; ++i) {
+		keyArray[i] = keys[i];
+		objectArray[i] = @(i);
+	}
+
+	NSDictionary *properties = [GRKOverlayDictionary dictionaryWithBase:@{@"base": @0} objects:objectArray forKeys:keyArray count:count];
+	XCTAssertEqualObjects(properties, expected);
+}
+
+- (void)testMutableCopy100 {
+
+	NSDictionary *properties = [GRKOverlayDictionary dictionaryWithBase:@{@"a": @1} object:@2 forKey:@"b"];
+	NSMutableDictionary *mutableProperties = [properties mutableCopy];
+	mutableProperties[@"c"] = @3;
+
+	XCTAssertEqualObjects(mutableProperties, (@{@"a": @1, @"b": @2, @"c": @3}));
+	XCTAssertTrue([properties copy] == properties, @"Expected the overlay to be immutable.");
+}
+
+- (void)testCopyMutableBase100 {
+
+	NSMutableDictionary *base = [NSMutableDictionary dictionaryWithDictionary:@{@"a": @1, @"b": @0}];
+	id keys[] = {@"b", @"c"};
+	id objects[] = {@2, nil};
+	NSDictionary *properties = [GRKOverlayDictionary dictionaryWithBase:base objects:objects forKeys:keys count:2];
+	NSDictionary *copy = [properties copy];
+	XCTAssertTrue(copy != properties, @"Expected an overlay of a mutable base to be copied.");
+
+	// The copy is a snapshot, unaffected by later changes to the base.
+	base[@"c"] = @3;
+	base[@"d"] = @4;
+	XCTAssertEqualObjects(copy, (@{@"a": @1, @"b": @2}));
+	XCTAssertTrue(copy.count == 2, @"Expected 2 entries but found %d.", (int)copy.count);
+	XCTAssertTrue([copy copy] == copy, @"Expected the copy to be immutable.");
+}
+
+@end
@@ -0,0 +1,115 @@
+//
+//  GRKPropertyStoreTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "GRKPropertyStore.h"
+#import "GRKLayeredDictionary.h"
+
+@interface GRKPropertyStoreTests : XCTestCase
+
+@end
+
+@implementation GRKPropertyStoreTests
+
+- (void)testAddRemove100 {
+
+	GRKPropertyStore *store = [[GRKPropertyStore alloc] init];
+	[store addProperties:@{@"a": @1, @"b": @2}];
+	[store addProperties:@{@"b": @3}];
+	[store removePropertiesForKeys:@[@"a"]];
+
+	XCTAssertEqualObjects(store.currentProperties, @{@"b": @3});
+}
+
+- (void)testVersionsAreImmutable100 {
+
+	GRKPropertyStore *store = [[GRKPropertyStore alloc] init];
+	[store addProperties:@{@"a": @1}];
+	NSDictionary *before = store.currentProperties;
+	[store addProperties:@{@"a": @2}];
+
+	XCTAssertEqualObjects(before, @{@"a": @1});
+	XCTAssertEqualObjects(store.currentProperties, @{@"a": @2});
+}
+
+- (void)testCompaction100 {
+
+	GRKPropertyStore *store = [[GRKPropertyStore alloc] init];
+	NSMutableDictionary *expected = [NSMutableDictionary dictionary];
+	for (NSUInteger i = 0; i < 100; ++i) {
+		NSString *key = [NSString stringWithFormat:@"key%d", (int)(i % 7)];
+		if (i % 5 == 0) {
+			[store removePropertiesForKeys:@[key]];
+			[expected removeObjectForKey:key];
+		}
+		else {
+			[store addProperties:@{key: @(i)}];
+			expected[key] = @(i);
+		}
+	}
+
+	XCTAssertEqualObjects(store.currentProperties, expected);
+}
+
+- (void)testLayers100 {
+
+	GRKPropertyStore *store = [[GRKPropertyStore alloc] init];
+	[store addProperties:@{@"screen": @"none", @"user": @"u"}];
+
+	id first = [store pushLayer:@{@"screen": @"first"}];
+	id second = [store pushLayer:@{@"screen": @"second", @"item": @"i"}];
+	XCTAssertEqualObjects(store.currentProperties, (@{@"screen": @"second", @"user": @"u", @"item": @"i"}));
+
+	[store popLayer:second];
+	XCTAssertEqualObjects(store.currentProperties, (@{@"screen": @"first", @"user": @"u"}));
+
+	// Removing base properties does not affect the layer.
+	[store removePropertiesForKeys:@[@"screen"]];
+	XCTAssertEqualObjects(store.currentProperties, (@{@"screen": @"first", @"user": @"u"}));
+
+	[store popLayer:first];
+	XCTAssertEqualObjects(store.currentProperties, @{@"user": @"u"});
+
+	// Popping again has no effect.
+	[store popLayer:second];
+	XCTAssertEqualObjects(store.currentProperties, @{@"user": @"u"});
+}
+
+- (void)testPopOuterLayer100 {
+
+	GRKPropertyStore *store = [[GRKPropertyStore alloc] init];
+	id first = [store pushLayer:@{@"a": @1}];
+	[store pushLayer:@{@"b": @2}];
+	[store popLayer:first];
+
+	XCTAssertEqualObjects(store.currentProperties, @{});
+}
+
+- (void)testOverlay100 {
+
+	GRKPropertyStore *store = [[GRKPropertyStore alloc] init];
+	[store addProperties:@{@"a": @1, @"b": @2}];
+
+	NSDictionary *properties = [store propertiesWithOverlay:@{@"b": @3, @"c": @4}];
+
+	XCTAssertTrue(properties.count == 3, @"Expected count 3 but found %d.", (int)properties.count);
+	XCTAssertEqualObjects(properties, (@{@"a": @1, @"b": @3, @"c": @4}));
+	XCTAssertEqualObjects([NSSet setWithArray:properties.allKeys], ([NSSet setWithArray:@[@"a", @"b", @"c"]]));
+	XCTAssertTrue([properties copy] == properties, @"Expected the overlay to be immutable.");
+}
+
+- (void)testOverlayEmpty100 {
+
+	GRKPropertyStore *store = [[GRKPropertyStore alloc] init];
+	NSDictionary *properties = @{@"a": @1};
+
+	XCTAssertEqualObjects([store propertiesWithOverlay:properties], properties);
+	XCTAssertEqualObjects([store propertiesWithOverlay:nil], @{});
+}
+
+@end
@@ -0,0 +1,201 @@
+//
+//  GRKSpanTableTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "GRKSpanTable.h"
+
+@interface GRKSpanTableTests : XCTestCase
+
+@end
+
+@implementation GRKSpanTableTests
+
+- (void)testParenting100 {
+
+	GRKSpanTable *table = [[GRKSpanTable alloc] init];
+	GRKSpan root = [table startSpanWithName:@"load" parent:kGRKSpanContextNone];
+	GRKSpan child = [table startSpanWithName:@"network" parent:root.context];
+
+	XCTAssertTrue(root.context.traceID != 0 && root.parentSpanID == 0, @"Expected the root to start a trace.");
+	XCTAssertTrue(root.context.root == root.handle, @"Expected the root to gather its trace.");
+	XCTAssertTrue(child.context.traceID == root.context.traceID, @"Expected the child to join the root's trace.");
+	XCTAssertTrue(child.parentSpanID == root.context.spanID, @"Expected the root to be the child's parent.");
+	XCTAssertTrue(child.context.root == root.handle, @"Expected the child to know its trace's root.");
+	XCTAssertTrue(child.context.spanID != root.context.spanID, @"Expected distinct span IDs.");
+	XCTAssertTrue(table.count == 2, @"Expected 2 spans but found %d.", (int)table.count);
+}
+
+- (void)testIndividual100 {
+
+	GRKSpanTable *table = [[GRKSpanTable alloc] init];
+	GRKSpan root = [table startSpanWithName:@"load" parent:kGRKSpanContextNone];
+	GRKSpan child = [table startSpanWithName:@"network" parent:root.context];
+	usleep(10000);
+
+	__block NSUInteger reported = 0;
+	BOOL ended = [table endSpan:child gatherTrace:NO handler:^(const GRKSpanRecord *records, NSUInteger count) {
+		reported = count;
+		XCTAssertTrue([records[0].name isEqualToString:@"network"], @"Unexpected span %@.", records[0].name);
+		XCTAssertTrue(records[0].parentSpanID == root.context.spanID, @"Unexpected parent.");
+		XCTAssertTrue(records[0].duration >= 10 * NSEC_PER_MSEC, @"Expected at least 10ms but found %llu ns.", records[0].duration);
+	}];
+	XCTAssertTrue(ended && reported == 1, @"Expected the span to be reported alone.");
+
+	XCTAssertFalse([table endSpan:child gatherTrace:NO handler:^(const GRKSpanRecord *records, NSUInteger count) {
+		XCTFail(@"Expected a span ended twice not to be reported.");
+	}], @"Expected the span to have ended.");
+}
+
+- (void)testTrace100 {
+
+	GRKSpanTable *table = [[GRKSpanTable alloc] init];
+	GRKSpan root = [table startSpanWithName:@"load" parent:kGRKSpanContextNone];
+	GRKSpan network = [table startSpanWithName:@"network" parent:root.context];
+	GRKSpan parse = [table startSpanWithName:@"parse" parent:network.context];
+	GRKSpan layout = [table startSpanWithName:@"layout" parent:root.context];
+	GRKSpan abandoned = [table startSpanWithName:@"abandoned" parent:root.context];
+
+	void (^unexpected)(const GRKSpanRecord *, NSUInteger) = ^(const GRKSpanRecord *records, NSUInteger count) {
+		XCTFail(@"Expected the span to be kept for its trace.");
+	};
+	XCTAssertTrue([table endSpan:parse gatherTrace:YES handler:unexpected], @"Expected a running span.");
+	XCTAssertTrue([table endSpan:layout gatherTrace:YES handler:unexpected], @"Expected a running span.");
+	XCTAssertTrue([table endSpan:network gatherTrace:YES handler:unexpected], @"Expected a running span.");
+
+	NSMutableArray<NSString *> *names = [NSMutableArray array];
+	[table endSpan:root gatherTrace:YES handler:^(const GRKSpanRecord *records, NSUInteger count) {
+		for (NSUInteger index = 0; index < count; ++index) {
+			[names addObject:records[index].name];
+			XCTAssertTrue(index == 0 || records[index].start >= records[index - 1].start, @"Expected the records in the order they started.");
+		}
+	}];
+	NSArray<NSString *> *expected = @[@"load", @"network", @"parse", @"layout"];
+	XCTAssertTrue([names isEqualToArray:expected], @"Expected %@ but found %@.", expected, names);
+
+	// A span outliving its root is reported alone.
+	__block NSUInteger reported = 0;
+	[table endSpan:abandoned gatherTrace:YES handler:^(const GRKSpanRecord *records, NSUInteger count) {
+		reported = count;
+	}];
+	XCTAssertTrue(reported == 1, @"Expected the span to be reported alone.");
+	XCTAssertTrue(table.count == 0, @"Expected no spans but found %d.", (int)table.count);
+}
+
+- (void)testCurrentContext100 {
+
+	XCTAssertTrue(GRKSpanContextGetCurrent().traceID == 0, @"Expected no current context.");
+
+	GRKSpanTable *table = [[GRKSpanTable alloc] init];
+	GRKSpan span = [table startSpanWithName:@"load" parent:kGRKSpanContextNone];
+	GRKSpanContextSetCurrent(span.context);
+
+	XCTestExpectation *expectation = [self expectationWithDescription:@"thread"];
+	dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+		XCTAssertTrue(GRKSpanContextGetCurrent().traceID == 0, @"Expected the context to be per thread.");
+		[expectation fulfill];
+	});
+	[self waitForExpectationsWithTimeout:5.0 handler:nil];
+
+	XCTAssertTrue(GRKSpanContextGetCurrent().spanID == span.context.spanID, @"Expected the context to be kept.");
+	GRKSpanContextSetCurrent(kGRKSpanContextNone);
+}
+
+- (void)testEndedParent100 {
+
+	GRKSpanTable *table = [[GRKSpanTable alloc] init];
+	GRKSpan root = [table startSpanWithName:@"load" parent:kGRKSpanContextNone];
+	[table endSpan:root gatherTrace:YES handler:^(const GRKSpanRecord *records, NSUInteger count) {}];
+
+	// A context left behind by an ended span starts a new trace, rather than joining the ended one.
+	GRKSpan span = [table startSpanWithName:@"later" parent:root.context];
+	XCTAssertTrue(span.parentSpanID == 0 && span.parentHandle == kGRKTimerHandleInvalid, @"Expected a new root.");
+	XCTAssertTrue(span.context.traceID == span.context.spanID, @"Expected a new trace.");
+	XCTAssertTrue(span.context.root == span.handle, @"Expected the span to gather its own trace.");
+
+	// A parent from elsewhere has no handle, and is always joined.
+	GRKSpanContext remote = {42, 43, kGRKTimerHandleInvalid, kGRKTimerHandleInvalid};
+	GRKSpan child = [table startSpanWithName:@"remote" parent:remote];
+	XCTAssertTrue(child.context.traceID == 42 && child.parentSpanID == 43, @"Expected the remote trace to be joined.");
+}
+
+- (void)testMaximumAge100 {
+
+	GRKSpanTable *table = [[GRKSpanTable alloc] init];
+	void (^unexpected)(const GRKSpanRecord *, NSUInteger) = ^(const GRKSpanRecord *records, NSUInteger count) {
+		XCTFail(@"Expected the span to be kept for its trace.");
+	};
+
+	// A root which never ends, with ended spans waiting for it, and one still running.
+	GRKSpan root = [table startSpanWithName:@"load" parent:kGRKSpanContextNone];
+	[table endSpan:[table startSpanWithName:@"network" parent:root.context] gatherTrace:YES handler:unexpected];
+	[table endSpan:[table startSpanWithName:@"parse" parent:root.context] gatherTrace:YES handler:unexpected];
+	GRKSpan layout = [table startSpanWithName:@"layout" parent:root.context];
+	XCTAssertTrue(table.count == 4, @"Expected 4 spans but found %d.", (int)table.count);
+	usleep(100000);
+
+	// Setting the maximum age sweeps out the spans already past it, and the abandoned root's ended spans with it.
+	table.maximumAge = 0.05;
+	XCTAssertTrue(table.count == 0, @"Expected no spans but found %d.", (int)table.count);
+	XCTAssertTrue(table.abandonedCount == 4, @"Expected 4 abandoned spans but found %llu.", table.abandonedCount);
+	XCTAssertFalse([table endSpan:root gatherTrace:YES handler:unexpected], @"Expected the root to be abandoned.");
+	XCTAssertFalse([table endSpan:layout gatherTrace:YES handler:unexpected], @"Expected the span to be abandoned.");
+
+	// A context whose span was abandoned is not joined.
+	GRKSpan later = [table startSpanWithName:@"later" parent:root.context];
+	XCTAssertTrue(later.parentSpanID == 0, @"Expected a new root.");
+
+	// With no spans starting, the periodic sweep abandons the rest.
+	usleep(200000);
+	XCTAssertTrue(table.count == 0, @"Expected no spans but found %d.", (int)table.count);
+	XCTAssertTrue(table.abandonedCount == 5, @"Expected 5 abandoned spans but found %llu.", table.abandonedCount);
+}
+
+- (void)testMaximumCount100 {
+
+	GRKSpanTable *table = [[GRKSpanTable alloc] init];
+	table.maximumCount = 3;
+
+	GRKSpan first = [table startSpanWithName:@"first" parent:kGRKSpanContextNone];
+	[table endSpan:[table startSpanWithName:@"child" parent:first.context] gatherTrace:YES handler:^(const GRKSpanRecord *records, NSUInteger count) {}];
+	GRKSpan second = [table startSpanWithName:@"second" parent:kGRKSpanContextNone];
+
+	// Making room abandons the oldest running span, and the ended span kept for its trace.
+	GRKSpan third = [table startSpanWithName:@"third" parent:kGRKSpanContextNone];
+	XCTAssertTrue(table.count == 2, @"Expected 2 spans but found %d.", (int)table.count);
+	XCTAssertTrue(table.abandonedCount == 2, @"Expected 2 abandoned spans but found %llu.", table.abandonedCount);
+
+	void (^handler)(const GRKSpanRecord *, NSUInteger) = ^(const GRKSpanRecord *records, NSUInteger count) {};
+	XCTAssertFalse([table endSpan:first gatherTrace:YES handler:handler], @"Expected the oldest span to be abandoned.");
+	XCTAssertTrue([table endSpan:second gatherTrace:YES handler:handler], @"Expected a running span.");
+	XCTAssertTrue([table endSpan:third gatherTrace:YES handler:handler], @"Expected a running span.");
+
+	for (NSUInteger i = 0; i < 100; ++i) {
+		[table startSpanWithName:@"span" parent:kGRKSpanContextNone];
+	}
+	XCTAssertTrue(table.count == 3, @"Expected 3 spans but found %d.", (int)table.count);
+}
+
+- (void)testPerformanceStartEnd {
+
+	GRKSpanTable *table = [[GRKSpanTable alloc] init];
+
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 10000; ++i) {
+			GRKSpan root = [table startSpanWithName:@"load" parent:kGRKSpanContextNone];
+			for (NSUInteger j = 0; j < 8; ++j) {
+				GRKSpan child = [table startSpanWithName:@"step" parent:root.context];
+				[table endSpan:child gatherTrace:YES handler:^(const GRKSpanRecord *records, NSUInteger count) {
+				}];
+			}
+			[table endSpan:root gatherTrace:YES handler:^(const GRKSpanRecord *records, NSUInteger count) {
+			}];
+		}
+	}];
+}
+
+@end
@@ -0,0 +1,256 @@
+//
+//  GRKTimerTableTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "GRKTimerTable.h"
+
+@interface GRKTimerTableTests : XCTestCase
+
+@end
+
+@implementation GRKTimerTableTests
+
+- (void)testMonotonicTime100 {
+
+	uint64_t previous = GRKMonotonicTimeNanoseconds();
+	for (NSUInteger i = 0; i < 10000; ++i) {
+		uint64_t now = GRKMonotonicTimeNanoseconds();
+		XCTAssertTrue(now >= previous, @"The clock went backwards.");
+		previous = now;
+	}
+}
+
+- (void)testStartStop100 {
+
+	GRKTimerTable *table = [[GRKTimerTable alloc] init];
+	[table startTimerForKey:@"event"];
+	usleep(10000);
+
+	uint64_t elapsed = 0;
+	XCTAssertTrue([table stopTimerForKey:@"event" elapsedNanoseconds:&elapsed], @"Expected a running timer.");
+	XCTAssertTrue(elapsed >= 10 * NSEC_PER_MSEC, @"Expected at least 10ms but found %llu ns.", elapsed);
+	XCTAssertTrue(elapsed < NSEC_PER_SEC, @"Expected well under a second but found %llu ns.", elapsed);
+	XCTAssertTrue(table.count == 0, @"Expected no running timers but found %d.", (int)table.count);
+
+	elapsed = 42;
+	XCTAssertFalse([table stopTimerForKey:@"event" elapsedNanoseconds:&elapsed], @"Expected the timer to have stopped.");
+	XCTAssertTrue(elapsed == 42, @"Expected the elapsed time to be untouched.");
+}
+
+- (void)testRestart100 {
+
+	GRKTimerTable *table = [[GRKTimerTable alloc] init];
+	[table startTimerForKey:@"event"];
+	usleep(50000);
+	[table startTimerForKey:@"event"];
+
+	uint64_t elapsed = 0;
+	XCTAssertTrue([table stopTimerForKey:@"event" elapsedNanoseconds:&elapsed], @"Expected a running timer.");
+	XCTAssertTrue(elapsed < 50 * NSEC_PER_MSEC, @"Expected the restart to reset the timer, but found %llu ns.", elapsed);
+}
+
+- (void)testManyTimers100 {
+
+	GRKTimerTable *table = [[GRKTimerTable alloc] init];
+	for (NSUInteger i = 0; i < 100; ++i) {
+		[table startTimerForKey:[NSString stringWithFormat:@"event%d", (int)i]];
+	}
+	XCTAssertTrue(table.count == 100, @"Expected 100 running timers but found %d.", (int)table.count);
+
+	for (NSUInteger i = 0; i < 100; i += 2) {
+		XCTAssertTrue([table stopTimerForKey:[NSString stringWithFormat:@"event%d", (int)i] elapsedNanoseconds:NULL], @"Expected a running timer.");
+	}
+	for (NSUInteger i = 100; i < 150; ++i) {
+		[table startTimerForKey:[NSString stringWithFormat:@"event%d", (int)i]];
+	}
+	XCTAssertTrue(table.count == 100, @"Expected 100 running timers but found %d.", (int)table.count);
+
+	for (NSUInteger i = 1; i < 150; ++i) {
+		BOOL running = i >= 100 || i % 2 == 1;
+		uint64_t elapsed = 0;
+		XCTAssertTrue([table stopTimerForKey:[NSString stringWithFormat:@"event%d", (int)i] elapsedNanoseconds:&elapsed] == running, @"Unexpected timer state for event%d.", (int)i);
+	}
+	XCTAssertTrue(table.count == 0, @"Expected no running timers but found %d.", (int)table.count);
+
+	[table startTimerForKey:@"event"];
+	[table removeAllTimers];
+	XCTAssertTrue(table.count == 0, @"Expected no running timers but found %d.", (int)table.count);
+}
+
+- (void)testHandles100 {
+
+	GRKTimerTable *table = [[GRKTimerTable alloc] init];
+	GRKTimerHandle first = [table startTimer];
+	usleep(50000);
+	GRKTimerHandle second = [table startTimer];
+	XCTAssertTrue(first != second && first != kGRKTimerHandleInvalid && second != kGRKTimerHandleInvalid, @"Expected distinct, valid handles.");
+	XCTAssertTrue(table.count == 2, @"Expected 2 running timers but found %d.", (int)table.count);
+
+	uint64_t firstElapsed = 0;
+	uint64_t secondElapsed = 0;
+	XCTAssertTrue([table stopTimer:second elapsedNanoseconds:&secondElapsed], @"Expected a running timer.");
+	XCTAssertTrue([table stopTimer:first elapsedNanoseconds:&firstElapsed], @"Expected a running timer.");
+	XCTAssertTrue(firstElapsed >= 50 * NSEC_PER_MSEC && firstElapsed > secondElapsed, @"Expected overlapping timers to be independent.");
+
+	// The slot is reused, but the stale handle doesn't match the new timer.
+	GRKTimerHandle third = [table startTimer];
+	XCTAssertTrue((uint32_t)third == (uint32_t)first && third != first, @"Expected the slot to be reused with a new generation.");
+	XCTAssertFalse([table stopTimer:first elapsedNanoseconds:NULL], @"Expected the stale handle to be rejected.");
+	XCTAssertFalse([table stopTimer:kGRKTimerHandleInvalid elapsedNanoseconds:NULL], @"Expected the invalid handle to be rejected.");
+	XCTAssertFalse([table stopTimer:UINT64_MAX elapsedNanoseconds:NULL], @"Expected the out of range handle to be rejected.");
+	XCTAssertTrue(table.count == 1, @"Expected 1 running timer but found %d.", (int)table.count);
+
+	[table removeAllTimers];
+	XCTAssertFalse([table stopTimer:third elapsedNanoseconds:NULL], @"Expected the removed timer's handle to be rejected.");
+}
+
+- (void)testConcurrentHandles100 {
+
+	GRKTimerTable *table = [[GRKTimerTable alloc] init];
+	__block NSUInteger stoppedCount = 0;
+	dispatch_apply(1000, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+		GRKTimerHandle handle = [table startTimer];
+		if ([table stopTimer:handle elapsedNanoseconds:NULL]) {
+			@synchronized (self) {
+				++stoppedCount;
+			}
+		}
+	});
+
+	XCTAssertTrue(stoppedCount == 1000, @"Expected 1000 stopped timers but found %d.", (int)stoppedCount);
+	XCTAssertTrue(table.count == 0, @"Expected no running timers but found %d.", (int)table.count);
+}
+
+- (void)testPerformanceHandles {
+
+	GRKTimerTable *table = [[GRKTimerTable alloc] init];
+
+	[self measureBlock:^{
+		GRKTimerHandle handles[32];
+		for (NSUInteger i = 0; i < 10000; ++i) {
+			for (NSUInteger j = 0; j < 32; ++j) {
+				handles[j] = [table startTimer];
+			}
+			for (NSUInteger j = 0; j < 32; ++j) {
+				[table stopTimer:handles[j] elapsedNanoseconds:NULL];
+			}
+		}
+	}];
+}
+
+- (void)testPause100 {
+
+	GRKTimerTable *table = [[GRKTimerTable alloc] init];
+	GRKTimerHandle continuous = [table startTimer];
+	table.mode = GRKTimerModePausesWhileSuspended;
+	GRKTimerHandle pausing = [table startTimer];
+	[table startTimerForKey:@"event"];
+
+	[table pause];
+	[table pause];
+	XCTAssertTrue(table.isPaused, @"Expected the table to be paused.");
+	usleep(100000);
+	[table resume];
+	[table resume];
+	XCTAssertFalse(table.isPaused, @"Expected the table to be resumed.");
+
+	uint64_t continuousElapsed = 0;
+	uint64_t pausingElapsed = 0;
+	uint64_t keyedElapsed = 0;
+	[table stopTimer:continuous elapsedNanoseconds:&continuousElapsed];
+	[table stopTimer:pausing elapsedNanoseconds:&pausingElapsed];
+	[table stopTimerForKey:@"event" elapsedNanoseconds:&keyedElapsed];
+
+	XCTAssertTrue(continuousElapsed >= 100 * NSEC_PER_MSEC, @"Expected the continuous timer to count the pause, but found %llu ns.", continuousElapsed);
+	XCTAssertTrue(pausingElapsed < 50 * NSEC_PER_MSEC, @"Expected the pausing timer to skip the pause, but found %llu ns.", pausingElapsed);
+	XCTAssertTrue(keyedElapsed < 50 * NSEC_PER_MSEC, @"Expected the keyed timer to skip the pause, but found %llu ns.", keyedElapsed);
+
+	// A timer started while paused counts from the resume.
+	[table pause];
+	GRKTimerHandle started = [table startTimer];
+	usleep(100000);
+	[table resume];
+	uint64_t startedElapsed = 0;
+	[table stopTimer:started elapsedNanoseconds:&startedElapsed];
+	XCTAssertTrue(startedElapsed < 50 * NSEC_PER_MSEC, @"Expected the timer to start counting on resume, but found %llu ns.", startedElapsed);
+}
+
+- (void)testMaximumAge100 {
+
+	GRKTimerTable *table = [[GRKTimerTable alloc] init];
+	NSMutableArray *abandonedKeys = [NSMutableArray array];
+	table.abandonHandler = ^(NSString *key, uint64_t elapsed) {
+		@synchronized (abandonedKeys) {
+			[abandonedKeys addObject:key ?: [NSNull null]];
+		}
+	};
+
+	[table startTimerForKey:@"old"];
+	GRKTimerHandle handle = [table startTimer];
+	usleep(100000);
+
+	// Setting the maximum age sweeps out the timers already past it, oldest first.
+	table.maximumAge = 0.05;
+	[table startTimerForKey:@"new"];
+	XCTAssertTrue(table.count == 1, @"Expected 1 running timer but found %d.", (int)table.count);
+	XCTAssertTrue(table.abandonedCount == 2, @"Expected 2 abandoned timers but found %llu.", table.abandonedCount);
+	XCTAssertTrue([abandonedKeys isEqualToArray:@[@"old", [NSNull null]]], @"Unexpected abandoned timers: %@", abandonedKeys);
+	XCTAssertFalse([table stopTimerForKey:@"old" elapsedNanoseconds:NULL], @"Expected the old timer to be abandoned.");
+	XCTAssertFalse([table stopTimer:handle elapsedNanoseconds:NULL], @"Expected the handle to be abandoned.");
+
+	// With no timers starting, the periodic sweep abandons the rest.
+	usleep(200000);
+	XCTAssertTrue(table.count == 0, @"Expected no running timers but found %d.", (int)table.count);
+	XCTAssertTrue(table.abandonedCount == 3, @"Expected 3 abandoned timers but found %llu.", table.abandonedCount);
+}
+
+- (void)testMaximumCount100 {
+
+	GRKTimerTable *table = [[GRKTimerTable alloc] init];
+	table.maximumCount = 3;
+
+	[table startTimerForKey:@"a"];
+	[table startTimerForKey:@"b"];
+	[table startTimerForKey:@"c"];
+	// Restarting moves a timer to the back of the line.
+	[table startTimerForKey:@"a"];
+	[table startTimerForKey:@"d"];
+
+	XCTAssertTrue(table.count == 3, @"Expected 3 running timers but found %d.", (int)table.count);
+	XCTAssertTrue(table.abandonedCount == 1, @"Expected 1 abandoned timer but found %llu.", table.abandonedCount);
+	XCTAssertFalse([table stopTimerForKey:@"b" elapsedNanoseconds:NULL], @"Expected the oldest timer to be abandoned.");
+	XCTAssertTrue([table stopTimerForKey:@"a" elapsedNanoseconds:NULL], @"Expected a running timer.");
+
+	for (NSUInteger i = 0; i < 100; ++i) {
+		[table startTimer];
+	}
+	XCTAssertTrue(table.count == 3, @"Expected 3 running timers but found %d.", (int)table.count);
+	XCTAssertTrue(table.abandonedCount == 100, @"Expected 100 abandoned timers but found %llu.", table.abandonedCount);
+}
+
+- (void)testPerformanceStartStop {
+
+	GRKTimerTable *table = [[GRKTimerTable alloc] init];
+	NSMutableArray<NSString *> *keys = [NSMutableArray array];
+	for (NSUInteger i = 0; i < 32; ++i) {
+		[keys addObject:[NSString stringWithFormat:@"event%d", (int)i]];
+	}
+
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 10000; ++i) {
+			for (NSString *key in keys) {
+				[table startTimerForKey:key];
+			}
+			for (NSString *key in keys) {
+				[table stopTimerForKey:key elapsedNanoseconds:NULL];
+			}
+		}
+	}];
+}
+
+@end
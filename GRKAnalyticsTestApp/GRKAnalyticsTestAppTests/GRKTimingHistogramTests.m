@@ -0,0 +1,160 @@
+//
+//  GRKTimingHistogramTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <pthread.h>
+#import "GRKTimingHistogram.h"
+#import "GRKTimingAggregator.h"
+
+@interface GRKTimingHistogramTests : XCTestCase
+
+@end
+
+static void *GRKTimingTestRecord(void *context)
+{
+	@autoreleasepool {
+		GRKTimingAggregator *aggregator = (__bridge GRKTimingAggregator *)context;
+		for (uint64_t i = 1; i <= 100; ++i) {
+			[aggregator recordDuration:i * NSEC_PER_USEC forEvent:@"render" category:@"cell"];
+		}
+	}
+
+	return NULL;
+}
+
+@implementation GRKTimingHistogramTests
+
+// Whether the value is within the histogram's precision of the expected value.
+- (BOOL)value:(uint64_t)value approximates:(uint64_t)expected {
+
+	uint64_t difference = value > expected ? value - expected : expected - value;
+	return difference <= expected / 32 + 1;
+}
+
+- (void)testEmpty100 {
+
+	GRKTimingHistogram *histogram = [[GRKTimingHistogram alloc] init];
+	XCTAssertTrue(histogram.count == 0, @"Expected no values.");
+	XCTAssertTrue(histogram.minimum == 0 && histogram.maximum == 0, @"Expected a zero minimum and maximum.");
+	XCTAssertTrue([histogram valueAtPercentile:50.0] == 0, @"Expected a zero percentile.");
+}
+
+- (void)testPercentiles100 {
+
+	GRKTimingHistogram *histogram = [[GRKTimingHistogram alloc] init];
+	for (uint64_t value = 1; value <= 10000; ++value) {
+		[histogram recordValue:value * NSEC_PER_USEC];
+	}
+
+	XCTAssertTrue(histogram.count == 10000, @"Expected 10000 values but found %llu.", histogram.count);
+	XCTAssertTrue(histogram.minimum == NSEC_PER_USEC, @"Unexpected minimum %llu.", histogram.minimum);
+	XCTAssertTrue(histogram.maximum == 10000 * NSEC_PER_USEC, @"Unexpected maximum %llu.", histogram.maximum);
+
+	double percentiles[] = {50.0, 90.0, 99.0, 99.9, 100.0};
+	for (NSUInteger i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); ++i) {
+		uint64_t expected = (uint64_t)(percentiles[i] * 100.0) * NSEC_PER_USEC;
+		uint64_t value = [histogram valueAtPercentile:percentiles[i]];
+		XCTAssertTrue([self value:value approximates:expected], @"Expected p%g near %llu but found %llu.", percentiles[i], expected, value);
+	}
+}
+
+- (void)testRange100 {
+
+	GRKTimingHistogram *histogram = [[GRKTimingHistogram alloc] init];
+	uint64_t values[] = {0, 1, 63, 64, 65, 1000003, 60 * NSEC_PER_SEC};
+	for (NSUInteger i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+		GRKTimingHistogram *single = [[GRKTimingHistogram alloc] init];
+		[single recordValue:values[i]];
+		uint64_t value = [single valueAtPercentile:50.0];
+		XCTAssertTrue([self value:value approximates:values[i]], @"Expected %llu but found %llu.", values[i], value);
+		[histogram recordValue:values[i]];
+	}
+
+	[histogram recordValue:UINT64_MAX];
+	XCTAssertTrue(histogram.maximum == kGRKTimingHistogramMaximumValue, @"Expected an out of range value to be clamped.");
+}
+
+- (void)testMoveCounts100 {
+
+	GRKTimingHistogram *source = [[GRKTimingHistogram alloc] init];
+	GRKTimingHistogram *destination = [[GRKTimingHistogram alloc] init];
+	[source recordValue:100];
+	[source recordValue:5000];
+	[destination recordValue:300];
+
+	[source moveCountsToHistogram:destination];
+
+	XCTAssertTrue(source.count == 0 && source.minimum == 0 && source.maximum == 0, @"Expected the source to be reset.");
+	XCTAssertTrue(destination.count == 3, @"Expected 3 values but found %llu.", destination.count);
+	XCTAssertTrue(destination.minimum == 100 && destination.maximum == 5000, @"Unexpected minimum %llu or maximum %llu.", destination.minimum, destination.maximum);
+}
+
+- (void)testAggregator100 {
+
+	GRKTimingAggregator *aggregator = [[GRKTimingAggregator alloc] init];
+	dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+		for (uint64_t i = 1; i <= 1000; ++i) {
+			[aggregator recordDuration:i * NSEC_PER_USEC forEvent:@"render" category:@"cell"];
+			[aggregator recordDuration:i * NSEC_PER_USEC forEvent:@"lookup" category:nil];
+		}
+	});
+
+	NSMutableDictionary<NSString *, GRKTimingHistogram *> *summaries = [NSMutableDictionary dictionary];
+	[aggregator drainWithBlock:^(NSString *event, NSString *category, GRKTimingHistogram *histogram) {
+		summaries[[NSString stringWithFormat:@"%@/%@", event, category]] = histogram;
+	}];
+
+	XCTAssertTrue(summaries.count == 2, @"Expected 2 summaries but found %d.", (int)summaries.count);
+	XCTAssertTrue(summaries[@"render/cell"].count == 8000, @"Expected 8000 values but found %llu.", summaries[@"render/cell"].count);
+	XCTAssertTrue(summaries[@"lookup/(null)"].count == 8000, @"Expected 8000 values but found %llu.", summaries[@"lookup/(null)"].count);
+	XCTAssertTrue([self value:[summaries[@"render/cell"] valueAtPercentile:50.0] approximates:500 * NSEC_PER_USEC], @"Unexpected median.");
+
+	__block NSUInteger count = 0;
+	[aggregator drainWithBlock:^(NSString *event, NSString *category, GRKTimingHistogram *histogram) {
+		++count;
+	}];
+	XCTAssertTrue(count == 0, @"Expected nothing to drain but found %d summaries.", (int)count);
+}
+
+- (void)testRetiredThreads100 {
+
+	GRKTimingAggregator *aggregator = [[GRKTimingAggregator alloc] init];
+	pthread_t threads[4];
+	for (NSUInteger i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i) {
+		XCTAssertTrue(pthread_create(&threads[i], NULL, GRKTimingTestRecord, (__bridge void *)aggregator) == 0, @"Unable to start a thread.");
+	}
+	// Joined once each thread has exited, and so retired its histograms.
+	for (NSUInteger i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i) {
+		pthread_join(threads[i], NULL);
+	}
+	[aggregator recordDuration:NSEC_PER_USEC forEvent:@"render" category:@"cell"];
+	XCTAssertTrue(aggregator.histogramCount == 5, @"Expected 5 histograms but found %d.", (int)aggregator.histogramCount);
+
+	// The exited threads' last recordings are drained, then their histograms let go of; the live thread's are kept.
+	__block uint64_t count = 0;
+	[aggregator drainWithBlock:^(NSString *event, NSString *category, GRKTimingHistogram *histogram) {
+		count += histogram.count;
+	}];
+	XCTAssertTrue(count == 401, @"Expected 401 values but found %llu.", count);
+	XCTAssertTrue(aggregator.histogramCount == 1, @"Expected 1 histogram but found %d.", (int)aggregator.histogramCount);
+}
+
+- (void)testPerformanceRecord {
+
+	GRKTimingAggregator *aggregator = [[GRKTimingAggregator alloc] init];
+
+	[self measureBlock:^{
+		for (uint64_t i = 0; i < 1000000; ++i) {
+			[aggregator recordDuration:i forEvent:@"render" category:@"cell"];
+		}
+		[aggregator drainWithBlock:^(NSString *event, NSString *category, GRKTimingHistogram *histogram) {
+		}];
+	}];
+}
+
+@end
@@ -0,0 +1,161 @@
+//
+//  GoogleAnalyticsProviderTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "GRKGoogleAnalyticsProvider.h"
+#import "GRKLayeredDictionary.h"
+
+// Stands in for a GAI tracker, keeping the hits sent to it.
+@interface GRKRecordingTracker : NSObject
+
+@property (nonatomic, strong) NSMutableArray<NSDictionary *> *hits;
+
+@end
+
+@implementation GRKRecordingTracker
+
+- (instancetype)init {
+
+	if ((self = [super init])) {
+		_hits = [NSMutableArray array];
+	}
+
+	return self;
+}
+
+- (void)set:(NSString *)parameterName value:(NSString *)value {
+}
+
+- (NSString *)get:(NSString *)parameterName {
+
+	return nil;
+}
+
+- (void)send:(NSDictionary *)parameters {
+
+	[self.hits addObject:parameters];
+}
+
+@end
+
+@interface GRKGoogleAnalyticsProvider ()
+
+@property (nonatomic, copy) NSArray *trackers;
+@property (nonatomic, copy) NSArray<NSString *> *trackingIDs;
+
+- (NSDictionary *)fieldsFromProperties:(nullable NSDictionary *)properties event:(nullable NSString *)event label:(NSString * _Nullable * _Nullable)label value:(NSNumber * _Nullable * _Nullable)value;
+
+@end
+
+@interface GoogleAnalyticsProviderTests : XCTestCase
+
+@property (nonatomic,strong) GRKGoogleAnalyticsProvider *provider;
+
+@end
+
+@implementation GoogleAnalyticsProviderTests
+
+- (void)setUp {
+    [super setUp];
+	
+	self.provider = [[GRKGoogleAnalyticsProvider alloc] init];
+}
+
+- (void)tearDown {
+
+	self.provider = nil;
+	
+    [super tearDown];
+}
+
+- (void)testCustomFields100 {
+
+	self.provider.customDimensionKeys = [NSOrderedSet orderedSetWithArray:@[@"dimension_a", @"dimension_b"]];
+	self.provider.customMetricKeys = [NSOrderedSet orderedSetWithArray:@[@"metric_a"]];
+
+	NSDictionary *fields = [self.provider fieldsFromProperties:@{@"dimension_b": @"b", @"metric_a": @3, @"other": @"x"} event:nil label:nil value:nil];
+
+	XCTAssertEqualObjects(fields, (@{@"&cd2": @"b", @"&cm1": @3}));
+}
+
+- (void)testLabelValueFallback100 {
+
+	NSString *label = nil;
+	NSNumber *value = nil;
+	[self.provider fieldsFromProperties:@{@"zeta": @1, @"beta": @2, @"alpha": @"not a number", @"gamma": @3} event:@"event" label:&label value:&value];
+
+	XCTAssertEqualObjects(label, @"beta");
+	XCTAssertEqualObjects(value, @2);
+}
+
+- (void)testLabelValueKeys100 {
+
+	NSDictionary *properties = @{@"count": @1, @"score": @2, @"level": @3};
+	self.provider.labelValueKeys = @[@"missing", @"score"];
+	[self.provider setLabelValueKey:@"level" forEvent:@"level_up"];
+
+	NSString *label = nil;
+	NSNumber *value = nil;
+	[self.provider fieldsFromProperties:properties event:@"event" label:&label value:&value];
+	XCTAssertEqualObjects(label, @"score");
+	XCTAssertEqualObjects(value, @2);
+
+	[self.provider fieldsFromProperties:properties event:@"level_up" label:&label value:&value];
+	XCTAssertEqualObjects(label, @"level");
+	XCTAssertEqualObjects(value, @3);
+
+	[self.provider setLabelValueKey:nil forEvent:@"level_up"];
+	[self.provider fieldsFromProperties:properties event:@"level_up" label:&label value:&value];
+	XCTAssertEqualObjects(label, @"score");
+}
+
+- (void)testMultipleTrackers100 {
+
+	GRKGoogleAnalyticsProvider *provider = [[GRKGoogleAnalyticsProvider alloc] initWithTrackingIDs:@[@"UA-1-1", @"UA-1-2", @"UA-1-3"]];
+	NSArray<GRKRecordingTracker *> *trackers = @[[[GRKRecordingTracker alloc] init], [[GRKRecordingTracker alloc] init], [[GRKRecordingTracker alloc] init]];
+	provider.trackers = trackers;
+	provider.trackingIDs = @[@"UA-1-1", @"UA-1-2", @"UA-1-3"];
+	provider.customDimensionKeys = [NSOrderedSet orderedSetWithArray:@[@"screen"]];
+	provider.enabled = YES;
+
+	// Tracker fields add to the hit, and take precedence over its own fields.
+	[provider setFields:@{@"&cd9": @"second"} forTrackingID:@"UA-1-2"];
+	[provider setFields:@{@"&ec": @"third"} forTrackingID:@"UA-1-3"];
+	[provider setFields:@{@"&cd9": @"unknown"} forTrackingID:@"UA-9-9"];
+
+	[provider trackEvent:@"event" category:@"cat" properties:@{@"screen": @"home", @"count": @2}];
+
+	for (GRKRecordingTracker *tracker in trackers) {
+		XCTAssertTrue(tracker.hits.count == 1, @"Expected 1 hit but found %d.", (int)tracker.hits.count);
+	}
+	NSDictionary *hit = trackers[0].hits.firstObject;
+	XCTAssertEqualObjects(hit[@"&ec"], @"cat");
+	XCTAssertEqualObjects(hit[@"&ea"], @"event");
+	XCTAssertEqualObjects(hit[@"&cd1"], @"home");
+	XCTAssertNil(hit[@"&cd9"], @"Expected no tracker fields in the first tracker's hit.");
+
+	NSMutableDictionary *expected = [hit mutableCopy];
+	expected[@"&cd9"] = @"second";
+	XCTAssertEqualObjects(trackers[1].hits.firstObject, expected);
+	expected = [hit mutableCopy];
+	expected[@"&ec"] = @"third";
+	XCTAssertEqualObjects(trackers[2].hits.firstObject, expected);
+
+	// The hit is built once: the other trackers' hits layer their fields over the same dictionary.
+	for (NSUInteger index = 1; index < trackers.count; ++index) {
+		NSDictionary *layered = trackers[index].hits.firstObject;
+		XCTAssertTrue([layered isKindOfClass:GRKLayeredDictionary.class] && ((GRKLayeredDictionary *)layered).base == hit, @"Expected tracker %d's hit to share the first tracker's hit.", (int)index);
+	}
+
+	// Removing a tracker's fields sends it the shared hit as is.
+	[provider setFields:nil forTrackingID:@"UA-1-2"];
+	[provider trackEvent:@"event" category:@"cat" properties:nil];
+	XCTAssertTrue(trackers[1].hits.lastObject == trackers[0].hits.lastObject, @"Expected the shared hit itself.");
+}
+
+@end
@@ -0,0 +1,230 @@
+//
+//  MeasurementProtocolProviderTests.m
+//  GRKAnalyticsTestAppTests
+//
+//  Created by Levi Brown on 2026-10-17.
+//  Copyright © 2026 Levi Brown. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "GRKMeasurementProtocolProvider.h"
+
+static NSString * const kGRKTestCollectorHost = @"collector.test";
+
+// A stand-in collector: records each request body, and answers with the next queued status code (200 once the queue is empty).
+@interface GRKTestCollectorProtocol : NSURLProtocol
+
+@end
+
+static NSMutableArray<NSString *> *GRKTestCollectorBodies;
+static NSMutableArray<NSNumber *> *GRKTestCollectorStatusCodes;
+
+@implementation GRKTestCollectorProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+
+	return [request.URL.host isEqualToString:kGRKTestCollectorHost];
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+
+	return request;
+}
+
+- (void)startLoading {
+
+	NSData *body = self.request.HTTPBody;
+	if (!body && self.request.HTTPBodyStream) {
+		NSMutableData *streamed = [NSMutableData data];
+		NSInputStream *stream = self.request.HTTPBodyStream;
+		[stream open];
+		uint8_t buffer[4096];
+		NSInteger length = 0;
+		while ((length = [stream read:buffer maxLength:sizeof(buffer)]) > 0) {
+			[streamed appendBytes:buffer length:(NSUInteger)length];
+		}
+		[stream close];
+		body = streamed;
+	}
+
+	NSInteger statusCode = 200;
+	@synchronized (GRKTestCollectorBodies) {
+		[GRKTestCollectorBodies addObject:[[NSString alloc] initWithData:body ?: [NSData data] encoding:NSUTF8StringEncoding]];
+		if (GRKTestCollectorStatusCodes.count > 0) {
+			statusCode = GRKTestCollectorStatusCodes.firstObject.integerValue;
+			[GRKTestCollectorStatusCodes removeObjectAtIndex:0];
+		}
+	}
+
+	NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL statusCode:statusCode HTTPVersion:@"HTTP/1.1" headerFields:@{}];
+	[self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+	[self.client URLProtocol:self didLoadData:[NSData data]];
+	[self.client URLProtocolDidFinishLoading:self];
+}
+
+- (void)stopLoading {
+}
+
+@end
+
+@interface MeasurementProtocolProviderTests : XCTestCase
+
+@end
+
+@implementation MeasurementProtocolProviderTests
+
+- (void)setUp {
+
+	[super setUp];
+	GRKTestCollectorBodies = [NSMutableArray array];
+	GRKTestCollectorStatusCodes = [NSMutableArray array];
+}
+
+- (GRKMeasurementProtocolProvider *)provider {
+
+	NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+	configuration.protocolClasses = @[GRKTestCollectorProtocol.class];
+	GRKMeasurementProtocolProvider *provider = [[GRKMeasurementProtocolProvider alloc] initWithTrackingID:@"UA-1-1" clientID:@"client" configuration:configuration];
+	provider.endpointURL = [NSURL URLWithString:[NSString stringWithFormat:@"https://%@/batch", kGRKTestCollectorHost]];
+	provider.dispatchInterval = 0;
+	provider.retryInterval = 0.01;
+
+	return provider;
+}
+
+- (BOOL)dispatchProvider:(GRKMeasurementProtocolProvider *)provider {
+
+	__block BOOL dispatched = NO;
+	XCTestExpectation *expectation = [self expectationWithDescription:@"dispatch"];
+	[provider dispatchWithCompletion:^(BOOL success) {
+		dispatched = success;
+		[expectation fulfill];
+	}];
+	[self waitForExpectationsWithTimeout:10.0 handler:nil];
+
+	return dispatched;
+}
+
+- (void)testBatches100 {
+
+	GRKMeasurementProtocolProvider *provider = [self provider];
+	for (NSUInteger i = 0; i < 45; ++i) {
+		[provider trackEvent:@"name" category:@"cat" properties:nil];
+	}
+
+	XCTAssertTrue([self dispatchProvider:provider], @"Dispatch unexpectedly failed.");
+	XCTAssertTrue(GRKTestCollectorBodies.count == 3, @"Expected 3 requests but found %d.", (int)GRKTestCollectorBodies.count);
+
+	NSArray<NSNumber *> *expectedCounts = @[@20, @20, @5];
+	[GRKTestCollectorBodies enumerateObjectsUsingBlock:^(NSString *body, NSUInteger index, BOOL *stop) {
+		NSArray<NSString *> *hits = [body componentsSeparatedByString:@"\n"];
+		XCTAssertTrue(hits.count == expectedCounts[index].unsignedIntegerValue, @"Expected %@ hits but found %d.", expectedCounts[index], (int)hits.count);
+		for (NSString *hit in hits) {
+			XCTAssertTrue([hit hasPrefix:@"v=1&tid=UA-1-1&cid=client"], @"Unexpected hit: %@", hit);
+			XCTAssertTrue([hit rangeOfString:@"&t=event&ec=cat&ea=name"].location != NSNotFound, @"Unexpected hit: %@", hit);
+			XCTAssertTrue([hit rangeOfString:@"&qt="].location != NSNotFound, @"Missing queue time: %@", hit);
+		}
+	}];
+}
+
+- (void)testEncoding100 {
+
+	GRKMeasurementProtocolProvider *provider = [self provider];
+	provider.customDimensionKeys = @[@"unused", @"dimension"];
+	[provider trackEvent:@"a b&c=d" category:@"café" properties:@{@"dimension": @"x/y", @"count": @3, @"ignored": @"z"}];
+	[provider trackTimingEvent:@"load" category:@"timing" timeInterval:1.5 properties:nil];
+
+	XCTAssertTrue([self dispatchProvider:provider], @"Dispatch unexpectedly failed.");
+	NSArray<NSString *> *hits = [GRKTestCollectorBodies.firstObject componentsSeparatedByString:@"\n"];
+	XCTAssertTrue(hits.count == 2, @"Expected 2 hits but found %d.", (int)hits.count);
+	XCTAssertTrue([hits[0] rangeOfString:@"&ec=caf%C3%A9&ea=a%20b%26c%3Dd&el=count&ev=3&cd2=x%2Fy&qt="].location != NSNotFound, @"Unexpected hit: %@", hits[0]);
+	XCTAssertTrue([hits[0] rangeOfString:@"ignored"].location == NSNotFound, @"Unexpected hit: %@", hits[0]);
+	XCTAssertTrue([hits[1] rangeOfString:@"&t=timing&utc=timing&utv=load&utt=1500&qt="].location != NSNotFound, @"Unexpected hit: %@", hits[1]);
+}
+
+- (void)testRetry100 {
+
+	GRKMeasurementProtocolProvider *provider = [self provider];
+	[GRKTestCollectorStatusCodes addObjectsFromArray:@[@500, @503]];
+	[provider trackEvent:@"name" category:@"cat" properties:nil];
+
+	// A flush stops at the first failure; dispatching again does not wait out the backoff.
+	XCTAssertFalse([self dispatchProvider:provider], @"Dispatch unexpectedly succeeded.");
+	XCTAssertFalse([self dispatchProvider:provider], @"Dispatch unexpectedly succeeded.");
+	XCTAssertTrue([self dispatchProvider:provider], @"Dispatch unexpectedly failed.");
+
+	XCTAssertTrue(GRKTestCollectorBodies.count == 3, @"Expected 3 requests but found %d.", (int)GRKTestCollectorBodies.count);
+	XCTAssertTrue(provider.droppedHitCount == 0, @"Expected no dropped hits but found %d.", (int)provider.droppedHitCount);
+}
+
+- (void)testRejected100 {
+
+	GRKMeasurementProtocolProvider *provider = [self provider];
+	[GRKTestCollectorStatusCodes addObject:@400];
+	[provider trackEvent:@"name" category:@"cat" properties:nil];
+
+	XCTAssertFalse([self dispatchProvider:provider], @"Dispatch unexpectedly succeeded.");
+	XCTAssertTrue([self dispatchProvider:provider], @"Dispatch unexpectedly failed.");
+
+	XCTAssertTrue(GRKTestCollectorBodies.count == 1, @"Expected 1 request but found %d.", (int)GRKTestCollectorBodies.count);
+	XCTAssertTrue(provider.droppedHitCount == 1, @"Expected 1 dropped hit but found %d.", (int)provider.droppedHitCount);
+}
+
+- (void)testRequestBytes100 {
+
+	GRKMeasurementProtocolProvider *provider = [self provider];
+	provider.maximumRequestBytes = 1024;
+	NSString *padding = [@"" stringByPaddingToLength:300 withString:@"x" startingAtIndex:0];
+	for (NSUInteger i = 0; i < 10; ++i) {
+		[provider trackEvent:padding category:@"cat" properties:nil];
+	}
+	[provider trackEvent:[@"" stringByPaddingToLength:2000 withString:@"x" startingAtIndex:0] category:@"cat" properties:nil];
+
+	XCTAssertTrue([self dispatchProvider:provider], @"Dispatch unexpectedly failed.");
+
+	NSUInteger hitCount = 0;
+	for (NSString *body in GRKTestCollectorBodies) {
+		XCTAssertTrue(body.length <= 1024, @"Request of %d bytes exceeds the limit.", (int)body.length);
+		hitCount += [body componentsSeparatedByString:@"\n"].count;
+	}
+	XCTAssertTrue(hitCount == 10, @"Expected 10 hits but found %d.", (int)hitCount);
+	XCTAssertTrue(provider.droppedHitCount == 1, @"Expected 1 dropped hit but found %d.", (int)provider.droppedHitCount);
+}
+
+- (void)testRequestBytesSend100 {
+
+	GRKMeasurementProtocolProvider *provider = [self provider];
+	provider.maximumRequestBytes = 1024;
+	NSString *padding = [@"" stringByPaddingToLength:300 withString:@"x" startingAtIndex:0];
+	for (NSUInteger i = 0; i < 4; ++i) {
+		[provider trackEvent:padding category:@"cat" properties:nil];
+	}
+
+	// A batch sealed because the next hit does not fit is sent without waiting for a dispatch.
+	NSPredicate *sent = [NSPredicate predicateWithBlock:^BOOL(id object, NSDictionary *bindings) {
+		@synchronized (GRKTestCollectorBodies) {
+			return GRKTestCollectorBodies.count > 0;
+		}
+	}];
+	[self expectationForPredicate:sent evaluatedWithObject:self handler:nil];
+	[self waitForExpectationsWithTimeout:10.0 handler:nil];
+
+	XCTAssertTrue([self dispatchProvider:provider], @"Dispatch unexpectedly failed.");
+	XCTAssertTrue(GRKTestCollectorBodies.count == 2, @"Expected 2 requests but found %d.", (int)GRKTestCollectorBodies.count);
+}
+
+- (void)testPerformanceTrackAndDispatch {
+
+	GRKMeasurementProtocolProvider *provider = [self provider];
+	provider.customDimensionKeys = @[@"screen", @"user"];
+	NSDictionary *properties = @{@"screen": @"Home", @"user": @"anonymous", @"count": @1};
+
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 1000; ++i) {
+			[provider trackEvent:@"tap" category:@"ui" properties:properties];
+		}
+		[self dispatchProvider:provider];
+	}];
+}
+
+@end
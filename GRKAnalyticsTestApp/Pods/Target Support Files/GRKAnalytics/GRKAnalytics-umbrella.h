@@ -11,8 +11,20 @@
 #endif
 
 #import "GRKAnalytics.h"
+#import "GRKAnalyticsEvent.h"
 #import "GRKAnalyticsProvider.h"
+#import "GRKDeliveryPlan.h"
+#import "GRKEventBatcher.h"
+#import "GRKEventRingBuffer.h"
+#import "GRKFlushScheduler.h"
 #import "GRKLanguageFeatures.h"
+#import "GRKLayeredDictionary.h"
+#import "GRKOverlayDictionary.h"
+#import "GRKPropertyStore.h"
+#import "GRKSpanTable.h"
+#import "GRKTimerTable.h"
+#import "GRKTimingAggregator.h"
+#import "GRKTimingHistogram.h"
 
 FOUNDATION_EXPORT double GRKAnalyticsVersionNumber;
 FOUNDATION_EXPORT const unsigned char GRKAnalyticsVersionString[];